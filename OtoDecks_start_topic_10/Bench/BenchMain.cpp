@@ -0,0 +1,1119 @@
+/*
+==============================================================================
+BenchMain.cpp
+Created: 24 Oct 2026 5:20:44pm
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "../Source/DJAudioPlayer.h"
+#include "../Source/MixerEngine.h"
+#include "../Source/MixScript.h"
+#include "../Source/MixRenderer.h"
+#include "../Source/RealtimeSafetyChecker.h"
+#include "../Source/SeekableMp3Reader.h"
+#include "../Source/WaveformPyramid.h"
+#include "BenchReport.h"
+#include "TestTracks.h"
+
+//==============================================================================
+// OtoDecksBench times the audio engine headlessly: no GUI and no audio device.
+// The calling thread stands in for the audio thread and pulls blocks from the
+// decks, the mixer and the DSP stages directly, timing every call.
+//
+//   OtoDecksBench [--quick] [--filter <group>] [--json <file>] [--label <text>]
+//                 [--lame <executable>] [--mp3 <file>]
+//
+// Results are printed as they are measured and written to a JSON file
+// (OtoDecksBench.json by default) to diff between commits. Everything timed
+// stands in for the audio thread, so in a real-time checking build any
+// allocation or lock in it is reported at the end and fails the run. Some
+// groups also check a result against a bound, and a failed check fails the
+// run too, so a quick run doubles as the engine's test. Checks on timings
+// only run in full runs of optimised builds; a quick run checks results
+// alone, so the test does not depend on the machine. JUCE can only write
+// MP3 by running LAME, so the MP3 checks use one found on the PATH (or given
+// with --lame) to write their tracks, plus any file given with --mp3.
+
+namespace
+{
+    constexpr double deviceRate = 44100.0;
+    constexpr int blockSizes[] = { 32, 64, 128, 256, 512, 1024, 2048 };
+    constexpr int fixedBlockSize = 512;
+
+    /** Tempo of the test tracks; the sync test plays two slightly apart */
+    constexpr double trackBpm = 124.0;
+    constexpr double followerBpm = 126.0;
+
+    /** How much slower a smoothed gain may be than the plain gain it replaces */
+    constexpr double maxGainOverhead = 0.05;
+
+    /** Unoptimised code times nothing like the release build, so its timings are not checked */
+   #if defined (__OPTIMIZE__) || (defined (_MSC_VER) && ! defined (_DEBUG))
+    constexpr bool optimisedBuild = true;
+   #else
+    constexpr bool optimisedBuild = false;
+   #endif
+
+    /** The 99th percentile of the synced decks' beat offset, once locked in: about where a flam starts to be heard */
+    constexpr double maxSyncPhaseErrorMs = 10.0;
+
+    /** The command line, and where the test tracks are kept between runs */
+    struct Settings
+    {
+        bool quick = false;
+        String filter;
+        File dataDirectory;
+
+        /** Seconds of audio timed in each case */
+        double getCaseSeconds() const { return quick ? 2.0 : 10.0; }
+
+        bool wants(const String& group) const { return filter.isEmpty() || group.contains(filter); }
+
+        /** Timings are only checked against bounds when they are long and representative enough */
+        bool checksTimings() const { return optimisedBuild && ! quick; }
+    };
+
+    /** The largest difference allowed between a seek and a decode from the top: none, to float precision */
+    constexpr float maxMp3SeekError = 1.0e-6f;
+
+    struct TestFiles
+    {
+        File wav44, wav48, flac44;
+
+        /** MP3 tracks to check seeks on, by name; empty without LAME or --mp3 */
+        std::vector<std::pair<String, File>> mp3s;
+    };
+
+    /** Nanoseconds since a tick count */
+    double nanosSince(int64 startTicks)
+    {
+        return Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - startTicks) * 1.0e9;
+    }
+
+    double median(std::vector<double> values)
+    {
+        std::sort(values.begin(), values.end());
+        return BenchReport::getPercentile(values, 50.0);
+    }
+
+    /** Looks for the LAME executable on the PATH, returning File() if it is not there */
+    File findLame()
+    {
+       #if JUCE_WINDOWS
+        const auto directories = StringArray::fromTokens(SystemStats::getEnvironmentVariable("PATH", {}), ";", "\"");
+        const String name = "lame.exe";
+       #else
+        const auto directories = StringArray::fromTokens(SystemStats::getEnvironmentVariable("PATH", {}), ":", "");
+        const String name = "lame";
+       #endif
+
+        for (const auto& directory : directories)
+        {
+            if (! File::isAbsolutePath(directory))
+                continue;
+
+            const File lame = File(directory).getChildFile(name);
+            if (lame.existsAsFile())
+                return lame;
+        }
+
+        return {};
+    }
+
+    /** Empties the decoded cache of everything not playing, so the next load decodes again */
+    void evictDecodedTracks()
+    {
+        SharedResourcePointer<DecodedTrackCache> cache;
+        const int64 budget = cache->getMemoryBudget();
+        cache->setMemoryBudget(0);
+        cache->setMemoryBudget(budget);
+    }
+
+    /** A deck playing a file from the start, prepared for a block size. Streams the file if asked to. */
+    std::unique_ptr<DJAudioPlayer> makeDeck(AudioFormatManager& formatManager, const File& file, int blockSize, bool stream = false)
+    {
+        auto deck = std::make_unique<DJAudioPlayer>(formatManager);
+        deck->setAutoCue(false);
+        deck->prepareToPlay(blockSize, deviceRate);
+
+        SharedResourcePointer<DecodedTrackCache> cache;
+        const int64 budget = cache->getMemoryBudget();
+
+        if (stream)
+            cache->setMemoryBudget(0);  // Too big for the cache, so the loader streams it
+
+        auto track = deck->loadTrackNow(URL(file));
+        cache->setMemoryBudget(budget);
+
+        if (track == nullptr)
+        {
+            std::cout << "OtoDecksBench could not load " << file.getFullPathName() << std::endl;
+            return nullptr;
+        }
+
+        // A first load streams while the cache decodes; time the deck once it plays from memory
+        if (track->cachedSource != nullptr)
+            track->cachedSource->getTrack().waitUntilComplete(-1);
+
+        deck->swapTrackNow(std::move(track));
+        deck->applyCommandNow(DeckCommand::Type::setRampLength, 0.0);
+        deck->applyCommandNow(DeckCommand::Type::start);
+        return deck;
+    }
+
+    /** Times blocks from any source, in nanoseconds per sample */
+    std::vector<double> timeBlocks(AudioSource& source, int blockSize, double seconds)
+    {
+        AudioBuffer<float> buffer(2, blockSize);
+        const AudioSourceChannelInfo info(&buffer, 0, blockSize);
+        const int numBlocks = jmax(64, (int) (seconds * deviceRate / blockSize));
+        std::vector<double> times;
+        times.reserve((size_t) numBlocks);
+
+        const RealtimeSafetyChecker::ScopedRealtimeThread realtime;
+
+        for (int i = 0; i < 16; ++i)
+            source.getNextAudioBlock(info);  // Warm the caches and let any glides settle
+
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            const int64 start = Time::getHighResolutionTicks();
+            source.getNextAudioBlock(info);
+            times.push_back(nanosSince(start) / blockSize);
+        }
+
+        return times;
+    }
+
+    //==============================================================================
+    // A deck's whole chain, per block size, in the configurations that cost the most
+    void benchPlayer(BenchReport& report, const Settings& settings, AudioFormatManager& formatManager, const TestFiles& files)
+    {
+        struct Mode
+        {
+            const char* name;
+            File file;
+            double speed;
+            bool keyLock;
+            bool eq;
+            bool stream;
+        };
+
+        const Mode modes[] = {
+            { "plain",       files.wav44, 1.0,  false, false, false },
+            { "rateconvert", files.wav48, 1.0,  false, false, false },
+            { "pitch",       files.wav44, 1.07, false, false, false },
+            { "keylock0.50", files.wav44, 0.5,  true,  false, false },
+            { "keylock0.75", files.wav44, 0.75, true,  false, false },
+            { "keylock",     files.wav44, 1.07, true,  false, false },
+            { "keylock1.25", files.wav44, 1.25, true,  false, false },
+            { "keylock1.50", files.wav44, 1.5,  true,  false, false },
+            { "eq",          files.wav44, 1.0,  false, true,  false },
+            { "stream",      files.wav44, 1.0,  false, false, true  },
+        };
+
+        for (const auto& mode : modes)
+        {
+            for (const int blockSize : blockSizes)
+            {
+                auto deck = makeDeck(formatManager, mode.file, blockSize, mode.stream);
+                if (deck == nullptr)
+                    return;
+
+                deck->applyCommandNow(DeckCommand::Type::setSpeed, mode.speed);
+                deck->applyCommandNow(DeckCommand::Type::setKeyLock, mode.keyLock ? 1.0 : 0.0);
+
+                if (mode.eq)
+                {
+                    deck->applyCommandNow(DeckCommand::Type::setEqLow, -6.0);
+                    deck->applyCommandNow(DeckCommand::Type::setEqHigh, 3.0);
+                    deck->applyCommandNow(DeckCommand::Type::setFilter, 0.3);
+                }
+
+                report.add("player/" + String(mode.name) + "/" + String(blockSize), "ns/sample",
+                           timeBlocks(*deck, blockSize, settings.getCaseSeconds()));
+
+                if (mode.stream && blockSize == fixedBlockSize)
+                    report.addValue("player/stream/underruns", "blocks", deck->getNumReadAheadUnderruns());
+            }
+        }
+    }
+
+    //==============================================================================
+    // A seek through the index has to land on exactly the samples a decode from
+    // the top of the file gives. The positions straddle frame boundaries, the
+    // priming frames near the start and the end, then the whole file is read
+    // in order, which crosses from window to window.
+    void checkMp3Seeks(BenchReport& report, const String& name, const File& file)
+    {
+        const String checkName = "seek/check/mp3/" + name;
+        MP3AudioFormat mp3Format;
+        std::unique_ptr<AudioFormatReader> reference(mp3Format.createReaderFor(file.createInputStream().release(), true));
+        std::unique_ptr<AudioFormatReader> fullReader(mp3Format.createReaderFor(file.createInputStream().release(), true));
+
+        if (reference == nullptr || fullReader == nullptr || reference->lengthInSamples <= 0)
+        {
+            report.addCheck(checkName, false, "could not open " + file.getFullPathName());
+            return;
+        }
+
+        const int length = (int) reference->lengthInSamples;
+        const int numChannels = (int) reference->numChannels;
+        AudioBuffer<float> expected(numChannels, length);
+        reference->read(&expected, 0, length, 0, true, true);
+
+        SeekableMp3Reader seekable(fullReader.release(), file, Mp3SeekIndex::Storage::none);
+
+        for (int i = 0; i < 1000 && ! seekable.isIndexReady(); ++i)
+            Thread::sleep(10);
+
+        if (! seekable.isIndexReady())
+        {
+            report.addCheck(checkName, false, "the seek index was not built");
+            return;
+        }
+
+        constexpr int numCompared = 4096;
+        constexpr int frame = 1152;
+        std::vector<int> positions = { 0, 1, frame - 1, frame, frame + 1, 11 * frame - 1, 11 * frame, 12 * frame + 500,
+                                       length / 3, length / 2 + 7, length - numCompared - frame, length - numCompared };
+        Random random(8);
+
+        for (int i = 0; i < 20; ++i)
+            positions.push_back(random.nextInt(length));
+
+        AudioBuffer<float> actual(numChannels, numCompared);
+        float worstError = 0.0f;
+        int worstPosition = 0;
+
+        const auto compare = [&](int position)
+        {
+            position = jlimit(0, length - 1, position);
+            const int numSamples = jmin(numCompared, length - position);
+            seekable.read(&actual, 0, numSamples, position, true, true);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const float error = std::abs(actual.getSample(channel, i) - expected.getSample(channel, position + i));
+
+                    if (error > worstError)
+                    {
+                        worstError = error;
+                        worstPosition = position + i;
+                    }
+                }
+            }
+        };
+
+        for (const int position : positions)
+            compare(position);
+
+        for (int position = 0; position < length; position += numCompared)
+            compare(position);
+
+        report.addCheck(checkName, worstError <= maxMp3SeekError,
+                        "worst error " + String(worstError, 7) + " at sample " + String(worstPosition) + ", "
+                        + String((int) positions.size()) + " seeks and a full read, bound " + String(maxMp3SeekError, 7));
+    }
+
+    //==============================================================================
+    // A seek costs one block restarting the chain from memory; a streamed deck
+    // also has to wait for its read-ahead buffer to refill
+    void benchSeeks(BenchReport& report, const Settings& settings, AudioFormatManager& formatManager, const TestFiles& files)
+    {
+        const int numSeeks = settings.quick ? 50 : 200;
+
+        for (const bool stream : { false, true })
+        {
+            auto deck = makeDeck(formatManager, files.wav44, fixedBlockSize, stream);
+            if (deck == nullptr)
+                return;
+
+            AudioBuffer<float> buffer(2, fixedBlockSize);
+            const AudioSourceChannelInfo info(&buffer, 0, fixedBlockSize);
+            Random random(1);
+            std::vector<double> blockTimes, recoverTimes;
+            blockTimes.reserve((size_t) numSeeks);
+            recoverTimes.reserve((size_t) numSeeks);
+
+            for (int i = 0; i < numSeeks; ++i)
+            {
+                const RealtimeSafetyChecker::ScopedRealtimeThread realtime;
+                const int64 start = Time::getHighResolutionTicks();
+                deck->applyCommandNow(DeckCommand::Type::setPosition, random.nextDouble() * 50.0);
+                deck->getNextAudioBlock(info);
+                blockTimes.push_back(nanosSince(start) / 1000.0);
+
+                if (stream)
+                {
+                    // Keep asking for audio until a block comes back without an underrun
+                    int underruns = deck->getNumReadAheadUnderruns();
+                    int attempts = 0;
+
+                    do
+                    {
+                        underruns = deck->getNumReadAheadUnderruns();
+                        Thread::sleep(1);
+                        deck->getNextAudioBlock(info);
+                    }
+                    while (deck->getNumReadAheadUnderruns() != underruns && ++attempts < 1000);
+
+                    recoverTimes.push_back(nanosSince(start) / 1.0e6);
+                }
+            }
+
+            report.add(String("seek/") + (stream ? "stream" : "cached") + "/block", "us", blockTimes);
+
+            if (stream)
+                report.add("seek/stream/until_audible", "ms", recoverTimes);
+        }
+
+        if (files.mp3s.empty())
+            std::cout << "OtoDecksBench found no LAME and was given no --mp3, so MP3 seeks are not checked" << std::endl;
+
+        for (const auto& [name, file] : files.mp3s)
+            checkMp3Seeks(report, name, file);
+    }
+
+    //==============================================================================
+    // With room for two tracks, a third has to push out the least recently used
+    // one that nothing holds. A track still held is passed over, however old.
+    void checkEviction(BenchReport& report, AudioFormatManager& formatManager, const TestFiles& files)
+    {
+        for (const bool holdOldest : { false, true })
+        {
+            DecodedTrackCache cache;
+            const int64 trackBytes = 2 * (int64) (60.0 * 48000.0) * (int64) sizeof(float);
+            cache.setMemoryBudget(trackBytes * 5 / 2);
+
+            const auto decode = [&](const File& file)
+            {
+                std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(file));
+                return reader != nullptr ? cache.getOrDecode(file, *reader, [](double) { return true; }) : DecodedTrack::Ptr();
+            };
+
+            auto oldest = decode(files.wav44);
+            const bool cached = oldest != nullptr && decode(files.flac44) != nullptr;
+
+            if (! holdOldest)
+                oldest = nullptr;
+
+            const bool loaded = cached && decode(files.wav48) != nullptr;
+            const auto stats = cache.getStats();
+            const bool oldestKept = cache.find(files.wav44) != nullptr;
+            const bool nextKept = cache.find(files.flac44) != nullptr;
+
+            report.addCheck(holdOldest ? "load/check/eviction/held" : "load/check/eviction/unused",
+                            loaded && stats.evictions == 1 && oldestKept == holdOldest && nextKept != holdOldest,
+                            String(stats.evictions) + " evicted, oldest " + (oldestKept ? "kept" : "evicted")
+                            + ", next " + (nextKept ? "kept" : "evicted") + ", expected the "
+                            + (holdOldest ? "next" : "oldest") + " evicted");
+        }
+    }
+
+    //==============================================================================
+    // Loads on the calling thread, decoding from scratch, from the decoded
+    // cache, and opening a stream
+    void benchLoads(BenchReport& report, const Settings& settings, AudioFormatManager& formatManager, const TestFiles& files)
+    {
+        const int numLoads = settings.quick ? 3 : 10;
+        DJAudioPlayer deck(formatManager);
+        SharedResourcePointer<DecodedTrackCache> cache;
+
+        const std::pair<const char*, File> sources[] = { { "wav", files.wav44 }, { "wav48k", files.wav48 }, { "flac", files.flac44 } };
+
+        for (const auto& source : sources)
+        {
+            std::vector<double> cold, decoded, warm, stream;
+
+            for (int i = 0; i < numLoads; ++i)
+            {
+                evictDecodedTracks();
+
+                // A miss is playable as soon as it would be streamed; the decode carries on behind it
+                int64 start = Time::getHighResolutionTicks();
+                auto track = deck.loadTrackNow(URL(source.second));
+                cold.push_back(nanosSince(start) / 1.0e6);
+
+                if (track != nullptr && track->cachedSource != nullptr)
+                {
+                    track->cachedSource->getTrack().waitUntilComplete(-1);
+                    decoded.push_back(nanosSince(start) / 1.0e6);
+                }
+
+                track.reset();
+
+                start = Time::getHighResolutionTicks();
+                track = deck.loadTrackNow(URL(source.second));
+                warm.push_back(nanosSince(start) / 1.0e6);
+                track.reset();
+
+                const int64 budget = cache->getMemoryBudget();
+                cache->setMemoryBudget(0);
+                start = Time::getHighResolutionTicks();
+                track = deck.loadTrackNow(URL(source.second));
+                stream.push_back(nanosSince(start) / 1.0e6);
+                track.reset();
+                cache->setMemoryBudget(budget);
+            }
+
+            report.add("load/" + String(source.first) + "/decode", "ms", cold);
+            report.add("load/" + String(source.first) + "/decode_complete", "ms", decoded);
+            report.add("load/" + String(source.first) + "/cached", "ms", warm);
+            report.add("load/" + String(source.first) + "/stream", "ms", stream);
+        }
+
+        checkEviction(report, formatManager, files);
+    }
+
+    //==============================================================================
+    // Building a pyramid on one thread and on one per core, then drawing a
+    // display's worth of columns from it at zooms from the whole track to a
+    // fraction of a second
+    void benchWaveforms(BenchReport& report, const Settings& settings, AudioFormatManager& formatManager, const TestFiles& files)
+    {
+        const int numBuilds = settings.quick ? 3 : 10;
+        const int numThreads[] = { 1, jmax(1, SystemStats::getNumCpus()) };
+        const auto never = [] { return false; };
+        WaveformPyramid::Ptr pyramid;
+
+        for (const int threads : numThreads)
+        {
+            ThreadPool pool(ThreadPoolOptions{}.withNumberOfThreads(threads));
+            const std::pair<const char*, File> sources[] = { { "wav", files.wav44 }, { "flac", files.flac44 } };
+
+            for (const auto& source : sources)
+            {
+                std::vector<double> times;
+
+                for (int i = 0; i < numBuilds; ++i)
+                {
+                    const int64 start = Time::getHighResolutionTicks();
+                    pyramid = WaveformPyramid::build(source.second, formatManager, pool, never);
+                    times.push_back(nanosSince(start) / 1.0e6);
+                }
+
+                report.add("waveform/build/" + String(source.first) + "/" + String(threads) + "threads", "ms", times);
+            }
+        }
+
+        if (pyramid == nullptr)
+        {
+            std::cout << "OtoDecksBench could not build a waveform" << std::endl;
+            return;
+        }
+
+        constexpr int width = 1000;
+        std::vector<WaveformBin> columns((size_t) width);
+        const double length = pyramid->getLengthInSeconds();
+
+        for (const double zoom : { 1.0, 8.0, 64.0, 512.0 })
+        {
+            std::vector<double> times;
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                const double start = (length - length / zoom) * (i % 100) / 100.0;
+                const int64 startTicks = Time::getHighResolutionTicks();
+                pyramid->getColumns(start, start + length / zoom, columns.data(), width);
+                times.push_back(nanosSince(startTicks) / 1.0e3);
+            }
+
+            report.add("waveform/columns/zoom" + String((int) zoom), "us/paint", times);
+        }
+    }
+
+    //==============================================================================
+    // A short loop that is not a whole number of blocks, so the wrap lands all
+    // over the block; blocks that wrapped are timed separately from the rest
+    void benchLoops(BenchReport& report, const Settings& settings, AudioFormatManager& formatManager, const TestFiles& files)
+    {
+        for (const int blockSize : blockSizes)
+        {
+            auto deck = makeDeck(formatManager, files.wav44, blockSize);
+            if (deck == nullptr)
+                return;
+
+            deck->applyCommandNow(DeckCommand::Type::setLoopStart, 10.0);
+            deck->applyCommandNow(DeckCommand::Type::setLoopEnd, 10.1037);
+            deck->applyCommandNow(DeckCommand::Type::enableLoop, 1.0);
+            deck->applyCommandNow(DeckCommand::Type::setPosition, 10.0);
+
+            AudioBuffer<float> buffer(2, blockSize);
+            const AudioSourceChannelInfo info(&buffer, 0, blockSize);
+            const int numBlocks = jmax(256, (int) (settings.getCaseSeconds() * deviceRate / blockSize));
+            std::vector<double> wrapped, straight;
+            wrapped.reserve((size_t) numBlocks);
+            straight.reserve((size_t) numBlocks);
+
+            for (int i = 0; i < numBlocks; ++i)
+            {
+                const RealtimeSafetyChecker::ScopedRealtimeThread realtime;
+                const double before = deck->getPositionRelative();
+                const int64 start = Time::getHighResolutionTicks();
+                deck->getNextAudioBlock(info);
+                const double nanos = nanosSince(start);
+
+                (deck->getPositionRelative() < before ? wrapped : straight).push_back(nanos / blockSize);
+            }
+
+            report.add("loop/wrap/" + String(blockSize), "ns/sample", wrapped);
+            report.add("loop/straight/" + String(blockSize), "ns/sample", straight);
+        }
+    }
+
+    //==============================================================================
+    // The DSP stages on their own, fed from memory
+    void benchStages(BenchReport& report, const Settings& settings)
+    {
+        AudioBuffer<float> source(2, (int) (10.0 * deviceRate));
+        Random random(1);
+        TestTracks::fill(source, deviceRate, trackBpm, 0, random);
+        const double seconds = settings.getCaseSeconds();
+
+        if (settings.wants("resampler"))
+        {
+            // A sweep over the speeds a deck plays at, plus the common rate conversion
+            const std::pair<const char*, double> ratios[] = { { "0.50", 0.5 }, { "0.75", 0.75 }, { "0.93", 0.93 },
+                                                              { "1.07", 1.07 }, { "1.25", 1.25 }, { "1.50", 1.5 },
+                                                              { "2.00", 2.0 }, { "48k", 48000.0 / 44100.0 } };
+            const std::pair<const char*, SincResamplingSource::Quality> qualities[] = {
+                { "sinc-low", SincResamplingSource::Quality::low },
+                { "sinc-medium", SincResamplingSource::Quality::medium },
+                { "sinc-high", SincResamplingSource::Quality::high } };
+
+            for (const auto& ratio : ratios)
+            {
+                for (const auto& quality : qualities)
+                {
+                    MemoryAudioSource memory(source, false, true);
+                    SincResamplingSource resampler(&memory, 2);
+                    resampler.setQuality(quality.second);
+                    resampler.setResamplingRatio(ratio.second);
+                    resampler.prepareToPlay(fixedBlockSize, deviceRate);
+                    report.add("resampler/" + String(quality.first) + "/" + ratio.first, "ns/sample",
+                               timeBlocks(resampler, fixedBlockSize, seconds));
+                }
+
+                MemoryAudioSource memory(source, false, true);
+                ResamplingAudioSource resampler(&memory, false, 2);
+                resampler.setResamplingRatio(ratio.second);
+                resampler.prepareToPlay(fixedBlockSize, deviceRate);
+                report.add("resampler/juce/" + String(ratio.first), "ns/sample", timeBlocks(resampler, fixedBlockSize, seconds));
+            }
+        }
+
+        if (settings.wants("stretcher"))
+        {
+            // Beatmatching needs a few percent, but tempo changes go out to ±50%
+            for (const double tempo : { 0.5, 0.75, 0.93, 1.0, 1.07, 1.25, 1.5 })
+            {
+                MemoryAudioSource memory(source, false, true);
+                TimeStretcher stretcher(&memory, 2);
+                stretcher.setEnabled(tempo != 1.0);
+                stretcher.setTempo(tempo);
+                stretcher.prepareToPlay(fixedBlockSize, deviceRate);
+                report.add("stretcher/" + String(tempo == 1.0 ? "off" : String(tempo, 2)), "ns/sample",
+                           timeBlocks(stretcher, fixedBlockSize, seconds));
+            }
+        }
+
+        // Stages that process a buffer in place are timed on a copy of the same block every time
+        AudioBuffer<float> block(2, fixedBlockSize);
+        const int numBlocks = (int) (seconds * deviceRate / fixedBlockSize);
+
+        const auto timeInPlace = [&](const String& name, const std::function<void()>& process) -> double
+        {
+            std::vector<double> times;
+            times.reserve((size_t) numBlocks);
+
+            for (int i = 0; i < numBlocks; ++i)
+            {
+                const RealtimeSafetyChecker::ScopedRealtimeThread realtime;
+
+                for (int channel = 0; channel < 2; ++channel)
+                    block.copyFrom(channel, 0, source, channel, (i * fixedBlockSize) % (source.getNumSamples() - fixedBlockSize), fixedBlockSize);
+
+                const int64 start = Time::getHighResolutionTicks();
+                process();
+                times.push_back(nanosSince(start) / fixedBlockSize);
+            }
+
+            report.add(name, "ns/sample", times);
+            return median(times);
+        };
+
+        if (settings.wants("gain"))
+        {
+            SmoothedParameter gliding(1.0f), settled(0.7f);
+            gliding.prepare(deviceRate, fixedBlockSize);
+            settled.prepare(deviceRate, fixedBlockSize);
+            gliding.setRampLength(0.05);
+
+            const double constant = timeInPlace("gain/constant", [&] { block.applyGain(0.7f); });
+            const double ramp = timeInPlace("gain/ramp", [&] { block.applyGainRamp(0, fixedBlockSize, 0.5f, 1.0f); });
+            const double smoothedSettled = timeInPlace("gain/smoothed-settled", [&] { settled.applyGain(block, 0, fixedBlockSize); });
+            const double smoothedGliding = timeInPlace("gain/smoothed-gliding", [&]
+            {
+                if (! gliding.isSmoothing())
+                    gliding.setTargetValue(gliding.getTargetValue() > 0.75f ? 0.5f : 1.0f);
+
+                gliding.applyGain(block, 0, fixedBlockSize);
+            });
+
+            // A settled parameter should cost no more than a plain gain, and a
+            // glide no more than JUCE's ramp, within the bound
+            const auto checkOverhead = [&report, &settings](const String& name, double smoothed, double plain)
+            {
+                const double overhead = smoothed / jmax(1.0e-3, plain) - 1.0;
+                report.addValue("gain/overhead/" + name, "%", overhead * 100.0);
+
+                if (settings.checksTimings())
+                    report.addCheck("gain/check/" + name, overhead <= maxGainOverhead,
+                                    String(overhead * 100.0, 1) + "% <= " + String(maxGainOverhead * 100.0, 0) + "%");
+            };
+
+            checkOverhead("settled", smoothedSettled, constant);
+            checkOverhead("gliding", smoothedGliding, ramp);
+        }
+
+        if (settings.wants("eq"))
+        {
+            DeckEqualiser eq;
+            eq.prepare(deviceRate);
+            timeInPlace("eq/flat", [&] { eq.process(block, 0, fixedBlockSize); });
+
+            eq.setBandGain(DeckEqualiser::Band::low, -6.0f);
+            eq.setBandGain(DeckEqualiser::Band::mid, 2.0f);
+            eq.setBandGain(DeckEqualiser::Band::high, 4.0f);
+            timeInPlace("eq/bands", [&] { eq.process(block, 0, fixedBlockSize); });
+
+            eq.setBandKill(DeckEqualiser::Band::mid, true);
+            timeInPlace("eq/kill", [&] { eq.process(block, 0, fixedBlockSize); });
+
+            eq.setFilter(0.5f);
+            timeInPlace("eq/filter", [&] { eq.process(block, 0, fixedBlockSize); });
+        }
+    }
+
+    //==============================================================================
+    // The whole mix for 1 to 16 decks: MixerEngine serial and parallel against
+    // JUCE's MixerAudioSource, in microseconds per callback
+    void benchMixer(BenchReport& report, const Settings& settings, AudioFormatManager& formatManager, const TestFiles& files)
+    {
+        OwnedArray<DJAudioPlayer> decks;
+
+        for (int i = 0; i < 16; ++i)
+        {
+            auto deck = makeDeck(formatManager, files.wav44, fixedBlockSize);
+            if (deck == nullptr)
+                return;
+
+            deck->applyCommandNow(DeckCommand::Type::setLoopStart, 1.0);
+            deck->applyCommandNow(DeckCommand::Type::setLoopEnd, 55.0);
+            deck->applyCommandNow(DeckCommand::Type::enableLoop, 1.0);
+            decks.add(deck.release());
+        }
+
+        // Per sample figures are scaled back up to the whole callback
+        const auto perCallback = [](std::vector<double> times)
+        {
+            for (auto& time : times)
+                time *= fixedBlockSize / 1000.0;
+            return times;
+        };
+
+        for (const int numDecks : { 1, 2, 4, 8, 16 })
+        {
+            MixerEngine engine(numDecks);
+            for (int i = 0; i < numDecks; ++i)
+                engine.setInput(i, decks[i]);
+
+            engine.prepareToPlay(fixedBlockSize, deviceRate);
+            const auto serial = perCallback(timeBlocks(engine, fixedBlockSize, settings.getCaseSeconds()));
+            report.add("mixer/engine/" + String(numDecks), "us/callback", serial);
+
+            if (numDecks > 1)
+            {
+                engine.setParallelRendering(true, 2);
+                engine.getWorkerPool()->resetWakeUpJitter();
+                const auto parallel = perCallback(timeBlocks(engine, fixedBlockSize, settings.getCaseSeconds()));
+                report.add("mixer/parallel/" + String(numDecks), "us/callback", parallel);
+                report.addValue("mixer/parallel_speedup/" + String(numDecks), "x", median(serial) / jmax(0.001, median(parallel)));
+
+                double averageJitter = 0.0, maxJitter = 0.0;
+                engine.getWorkerPool()->getWakeUpJitter(averageJitter, maxJitter);
+                report.addValue("mixer/wake_jitter_mean/" + String(numDecks), "us", averageJitter);
+                report.addValue("mixer/wake_jitter_max/" + String(numDecks), "us", maxJitter);
+            }
+
+            engine.releaseResources();
+
+            MixerAudioSource juceMixer;
+            for (int i = 0; i < numDecks; ++i)
+                juceMixer.addInputSource(decks[i], false);
+
+            juceMixer.prepareToPlay(fixedBlockSize, deviceRate);
+            const RealtimeSafetyChecker::ScopedAllowed juceLocks;  // MixerAudioSource locks on every callback
+            report.add("mixer/juce/" + String(numDecks), "us/callback",
+                       perCallback(timeBlocks(juceMixer, fixedBlockSize, settings.getCaseSeconds())));
+            juceMixer.removeAllInputs();
+
+            report.addValue("mixer/per_deck/" + String(numDecks), "us", median(serial) / numDecks);
+        }
+    }
+
+    //==============================================================================
+    // Two decks at different tempos, one synced to the other, rendered offline
+    // through a mix script for ten minutes. The phase error is sampled every
+    // block once the lock has had ten seconds to pull in.
+    void benchSync(BenchReport& report, const Settings& settings, AudioFormatManager& formatManager)
+    {
+        const int minutes = settings.quick ? 2 : 10;
+        const File master = settings.dataDirectory.getChildFile("sync_" + String((int) trackBpm) + ".wav");
+        const File follower = settings.dataDirectory.getChildFile("sync_" + String((int) followerBpm) + ".wav");
+
+        if (! TestTracks::write(master, deviceRate, minutes * 60.0 + 30.0, trackBpm)
+            || ! TestTracks::write(follower, deviceRate, minutes * 60.0 + 30.0, followerBpm))
+        {
+            report.addCheck("sync/check/phase_error", false, "the test tracks could not be written");
+            return;
+        }
+
+        MixScript script;
+        const String text = "0  1  load  \"" + master.getFileName() + "\"\n"
+                            "0  2  load  \"" + follower.getFileName() + "\"\n"
+                            "0  2  seek  0.2\n"
+                            "0  2  sync  on\n"
+                            "0  1  play\n"
+                            "0  2  play\n"
+                          + String(minutes) + ":00  -  end\n";
+
+        if (! script.loadFromText(text, settings.dataDirectory))
+        {
+            report.addCheck("sync/check/phase_error", false, "the script could not be parsed");
+            return;
+        }
+
+        OwnedArray<DJAudioPlayer> decks;
+        decks.add(new DJAudioPlayer(formatManager));
+        decks.add(new DJAudioPlayer(formatManager));
+
+        MixerEngine mixer(2);
+        mixer.setInput(0, decks[0]);
+        mixer.setInput(1, decks[1]);
+        mixer.setChannelCrossfaderSide(0, MixerEngine::CrossfaderSide::a);
+        mixer.setChannelCrossfaderSide(1, MixerEngine::CrossfaderSide::b);
+
+        SyncEngine syncEngine(decks);
+        MixScriptPlayer player(script, formatManager, decks, mixer, syncEngine);
+
+        if (! player.prepareTracks())
+        {
+            report.addCheck("sync/check/phase_error", false, "the script's tracks could not be loaded into memory");
+            return;
+        }
+
+        mixer.prepareToPlay(fixedBlockSize, deviceRate);
+        player.prepareToPlay(deviceRate);
+
+        AudioBuffer<float> buffer(2, fixedBlockSize);
+        const AudioSourceChannelInfo info(&buffer, 0, fixedBlockSize);
+        const int64 lockInSamples = (int64) (10.0 * deviceRate);
+        const double trackLength = (double) (int64) ((minutes * 60.0 + 30.0) * deviceRate);
+        std::vector<double> errorsMs, estimatedErrorsMs;
+        errorsMs.reserve((size_t) (player.getLengthInSamples() / fixedBlockSize + 1));
+        estimatedErrorsMs.reserve(errorsMs.capacity());
+        const int64 start = Time::getHighResolutionTicks();
+
+        while (! player.isFinished())
+        {
+            {
+                const RealtimeSafetyChecker::ScopedRealtimeThread realtime;
+                player.renderNextBlock(info);
+            }
+
+            if (player.getPosition() <= lockInSamples)
+                continue;
+
+            // The test tracks have a beat every samplesPerBeat from sample 0,
+            // so where each deck is on its real beat follows from its playhead
+            const double masterBeat = decks[0]->getPositionRelative() * trackLength * trackBpm / (60.0 * deviceRate);
+            const double followerBeat = decks[1]->getPositionRelative() * trackLength * followerBpm / (60.0 * deviceRate);
+            const double offsetBeats = (followerBeat - masterBeat) - std::round(followerBeat - masterBeat);
+            errorsMs.push_back(std::abs(offsetBeats) * 60000.0 / trackBpm);
+
+            // What the sync engine believes, from the analysed beatgrids
+            const double masterBpm = decks[0]->getTrackBpm();
+            if (masterBpm > 0.0)
+                estimatedErrorsMs.push_back(std::abs(syncEngine.getPhaseError(1)) * 60000.0 / masterBpm);
+        }
+
+        const double wallSeconds = nanosSince(start) / 1.0e9;
+        mixer.releaseResources();
+
+        if (decks[0]->getTrackBpm() <= 0.0 || decks[1]->getTrackBpm() <= 0.0)
+        {
+            report.addCheck("sync/check/phase_error", false, "the analyser found no tempo in the test tracks");
+            return;
+        }
+
+        report.add("sync/phase_error/" + String(minutes) + "min", "ms", errorsMs);
+        report.add("sync/estimated_phase_error/" + String(minutes) + "min", "ms", estimatedErrorsMs);
+
+        std::sort(errorsMs.begin(), errorsMs.end());
+        const double p99 = BenchReport::getPercentile(errorsMs, 99.0);
+        report.addCheck("sync/check/phase_error", ! errorsMs.empty() && p99 <= maxSyncPhaseErrorMs,
+                        "p99 " + String(p99, 2) + " ms <= " + String(maxSyncPhaseErrorMs, 0) + " ms against the real beats");
+
+        report.addValue("render/realtime_factor/2decks", "x", player.getLengthInSamples() / deviceRate / jmax(0.001, wallSeconds));
+    }
+
+    //==============================================================================
+    // A script played on decks that have been used by hand must come out the
+    // same as MixRenderer's render on new ones. The decks, sync engine and
+    // mixer are left mid-glide with every control moved, and the script is
+    // then played through them and compared with the render sample for sample.
+    void checkLiveRender(BenchReport& report, const Settings& settings, AudioFormatManager& formatManager, const TestFiles& files)
+    {
+        MixScript script;
+        const String text = "0     1  load  \"" + files.wav44.getFileName() + "\"\n"
+                            "0     2  load  \"" + files.wav48.getFileName() + "\"\n"
+                            "0     1  play\n"
+                            "0:01  2  seek  0.5\n"
+                            "0:01  2  sync  on\n"
+                            "0:01  2  play\n"
+                            "0:02  1  eq    low  -12\n"
+                            "0:03  -  crossfade  0.8  2\n"
+                            "0:04  1  speed  1.05\n"
+                            "0:06  -  end\n";
+
+        const File renderFile = settings.dataDirectory.getChildFile("live_render.wav");
+        MixRenderer::Options options;
+        options.sampleRate = deviceRate;
+        options.blockSize = fixedBlockSize;
+        MixRenderer::Result result;
+
+        if (! script.loadFromText(text, settings.dataDirectory) || ! MixRenderer::render(script, renderFile, options, result))
+        {
+            report.addCheck("render/check/live_matches_offline", false, "the script could not be rendered");
+            return;
+        }
+
+        std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(renderFile));
+        AudioBuffer<float> offline(2, reader != nullptr ? (int) reader->lengthInSamples : 0);
+
+        if (reader == nullptr || ! reader->read(&offline, 0, offline.getNumSamples(), 0, true, true))
+        {
+            report.addCheck("render/check/live_matches_offline", false, "the render could not be read back");
+            return;
+        }
+
+        OwnedArray<DJAudioPlayer> decks;
+        decks.add(new DJAudioPlayer(formatManager));
+        decks.add(new DJAudioPlayer(formatManager));
+
+        MixerEngine mixer(2);
+        mixer.setInput(0, decks[0]);
+        mixer.setInput(1, decks[1]);
+        mixer.setChannelCrossfaderSide(0, MixerEngine::CrossfaderSide::b);
+        mixer.setChannelGain(0, 0.3f);
+        mixer.setChannelTrim(1, 6.0f);
+        mixer.setChannelMute(1, true);
+        mixer.setCrossfader(0.9f);
+        mixer.setCrossfaderCurve(MixerEngine::CrossfaderCurve::cut);
+        mixer.prepareToPlay(fixedBlockSize, deviceRate);
+
+        SyncEngine syncEngine(decks);
+        syncEngine.setMaster(1);
+        syncEngine.setSynced(0, true);
+
+        // Both decks playing something else, with every control away from where a new deck has it
+        for (int i = 0; i < decks.size(); ++i)
+        {
+            auto* deck = decks[i];
+            deck->setAutoGain(false);
+            deck->setAutoCue(false);
+            deck->setResamplingQuality(SincResamplingSource::Quality::low);
+
+            auto track = deck->loadTrackNow(URL(i == 0 ? files.flac44 : files.wav44));
+            if (track == nullptr)
+            {
+                report.addCheck("render/check/live_matches_offline", false, "the decks could not be loaded");
+                return;
+            }
+
+            deck->swapTrackNow(std::move(track));
+            deck->applyCommandNow(DeckCommand::Type::setRampLength, 0.5);
+            deck->applyCommandNow(DeckCommand::Type::setRampCurve, (double) (int) SmoothedParameter::Curve::exponential);
+            deck->applyCommandNow(DeckCommand::Type::setLoopStart, 1.0);
+            deck->applyCommandNow(DeckCommand::Type::setLoopEnd, 1.5);
+            deck->applyCommandNow(DeckCommand::Type::enableLoop, 1.0);
+            deck->applyCommandNow(DeckCommand::Type::setKeyLock, 1.0);
+            deck->applyCommandNow(DeckCommand::Type::setEqMid, -18.0);
+            deck->applyCommandNow(DeckCommand::Type::killEqHigh, 1.0);
+            deck->applyCommandNow(DeckCommand::Type::setFilter, -0.7);
+            deck->applyCommandNow(DeckCommand::Type::start);
+            deck->applyCommandNow(DeckCommand::Type::setGain, 0.4);
+            deck->applyCommandNow(DeckCommand::Type::setSpeed, 1.3);
+        }
+
+        AudioBuffer<float> buffer(2, fixedBlockSize);
+        const AudioSourceChannelInfo info(&buffer, 0, fixedBlockSize);
+
+        for (int block = 0; block < 20; ++block)
+        {
+            syncEngine.process();
+            mixer.getNextAudioBlock(info);
+        }
+
+        MixScriptPlayer player(script, formatManager, decks, mixer, syncEngine);
+
+        if (! player.prepareTracks())
+        {
+            report.addCheck("render/check/live_matches_offline", false, "the script's tracks could not be loaded");
+            return;
+        }
+
+        player.prepareToPlay(deviceRate);
+
+        const int length = (int) jmin(player.getLengthInSamples(), (int64) offline.getNumSamples());
+        float maxDifference = length == offline.getNumSamples() ? 0.0f : 1.0f;
+
+        for (int done = 0; done < length; done += fixedBlockSize)
+        {
+            {
+                const RealtimeSafetyChecker::ScopedRealtimeThread realtime;
+                player.renderNextBlock(info);
+            }
+
+            const int numSamples = jmin(fixedBlockSize, length - done);
+
+            for (int channel = 0; channel < 2; ++channel)
+                for (int i = 0; i < numSamples; ++i)
+                    maxDifference = jmax(maxDifference, std::abs(buffer.getSample(channel, i) - offline.getSample(channel, done + i)));
+        }
+
+        mixer.releaseResources();
+
+        report.addCheck("render/check/live_matches_offline", maxDifference == 0.0f,
+                        "largest difference " + String(maxDifference) + " over " + String(length) + " samples");
+    }
+
+    //==============================================================================
+    int runBenchmarks(const StringArray& args)
+    {
+        const auto option = [&args](const String& name)
+        {
+            const int i = args.indexOf(name);
+            return i >= 0 && i + 1 < args.size() ? args[i + 1] : String();
+        };
+
+        Settings settings;
+        settings.quick = args.contains("--quick");
+        settings.filter = option("--filter");
+        settings.dataDirectory = File::getSpecialLocation(File::tempDirectory).getChildFile("OtoDecksBench");
+        settings.dataDirectory.createDirectory();
+
+        const File jsonFile = File::getCurrentWorkingDirectory().getChildFile(option("--json").isNotEmpty() ? option("--json")
+                                                                                                            : "OtoDecksBench.json");
+
+        TestFiles files;
+        files.wav44 = settings.dataDirectory.getChildFile("beat_44k.wav");
+        files.wav48 = settings.dataDirectory.getChildFile("beat_48k.wav");
+        files.flac44 = settings.dataDirectory.getChildFile("beat_44k.flac");
+
+        if (! TestTracks::write(files.wav44, 44100.0, 60.0, trackBpm)
+            || ! TestTracks::write(files.wav48, 48000.0, 60.0, trackBpm)
+            || ! TestTracks::write(files.flac44, 44100.0, 60.0, trackBpm))
+        {
+            std::cout << "OtoDecksBench could not write the test tracks to " << settings.dataDirectory.getFullPathName() << std::endl;
+            return 1;
+        }
+
+        // A CBR file starts with an Info frame and a VBR one with a Xing frame,
+        // which decoders treat differently, so both are checked
+        const File lame = option("--lame").isNotEmpty() ? File::getCurrentWorkingDirectory().getChildFile(option("--lame"))
+                                                        : findLame();
+
+        if (lame.existsAsFile())
+        {
+            for (const bool vbr : { false, true })
+            {
+                const File mp3 = settings.dataDirectory.getChildFile(vbr ? "beat_vbr.mp3" : "beat_cbr.mp3");
+
+                if (TestTracks::writeMp3(mp3, lame, vbr, 20.0, trackBpm))
+                    files.mp3s.emplace_back(vbr ? "vbr" : "cbr", mp3);
+                else
+                    std::cout << "OtoDecksBench could not write " << mp3.getFullPathName() << " with " << lame.getFullPathName() << std::endl;
+            }
+        }
+
+        if (option("--mp3").isNotEmpty())
+            files.mp3s.emplace_back("file", File::getCurrentWorkingDirectory().getChildFile(option("--mp3")));
+
+        // As the audio device would have it
+        const ScopedNoDenormals noDenormals;
+
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        BenchReport report(option("--label"));
+
+        if (settings.wants("player"))
+            benchPlayer(report, settings, formatManager, files);
+        if (settings.wants("seek"))
+            benchSeeks(report, settings, formatManager, files);
+        if (settings.wants("load"))
+            benchLoads(report, settings, formatManager, files);
+        if (settings.wants("loop"))
+            benchLoops(report, settings, formatManager, files);
+        if (settings.wants("waveform"))
+            benchWaveforms(report, settings, formatManager, files);
+
+        benchStages(report, settings);
+
+        if (settings.wants("mixer"))
+            benchMixer(report, settings, formatManager, files);
+        if (settings.wants("sync") || settings.wants("render"))
+            benchSync(report, settings, formatManager);
+        if (settings.wants("render"))
+            checkLiveRender(report, settings, formatManager, files);
+
+        if (! report.writeJson(jsonFile))
+            return 1;
+
+        if (report.getNumFailures() > 0)
+        {
+            std::cout << "OtoDecksBench: " << report.getNumFailures() << " check(s) failed" << std::endl;
+            return 2;
+        }
+
+        return 0;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    const StringArray args(argv + 1, argc - 1);
+
+    if (args.contains("--help"))
+    {
+        std::cout << "Usage: OtoDecksBench [--quick] [--filter <group>] [--json <file>] [--label <text>]"
+                     " [--lame <executable>] [--mp3 <file>]" << std::endl;
+        return 0;
+    }
+
+    // The decks post loader and analyser updates to the message queue, which is never run here
+    MessageManager::getInstance();
+
+    const int result = runBenchmarks(args);
+
+    DeletedAtShutdown::deleteAll();
+    MessageManager::deleteInstance();
+    return RealtimeSafetyChecker::reportViolations() > 0 ? 3 : result;
+}
@@ -0,0 +1,114 @@
+/*
+==============================================================================
+BenchReport.cpp
+Created: 24 Oct 2026 4:51:30pm
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "BenchReport.h"
+#include <algorithm>
+#include <numeric>
+
+//==============================================================================
+BenchReport::BenchReport(const String& _label)
+    : label(_label)
+{
+    std::cout << String("result").paddedRight(' ', 44) << String("unit").paddedRight(' ', 12)
+              << "     mean      p50      p90      p99      max" << std::endl;
+}
+
+//==============================================================================
+// Keep the summary, not the samples, so a long run stays small on disk
+void BenchReport::add(const String& name, const String& unit, std::vector<double> values)
+{
+    if (values.empty())
+        return;
+
+    std::sort(values.begin(), values.end());
+    const double mean = std::accumulate(values.begin(), values.end(), 0.0) / (double) values.size();
+
+    auto* result = new DynamicObject();
+    result->setProperty("name", name);
+    result->setProperty("unit", unit);
+    result->setProperty("count", (int) values.size());
+    result->setProperty("mean", mean);
+    result->setProperty("p50", getPercentile(values, 50.0));
+    result->setProperty("p90", getPercentile(values, 90.0));
+    result->setProperty("p99", getPercentile(values, 99.0));
+    result->setProperty("max", values.back());
+    results.add(var(result));
+
+    const auto column = [](double value) { return String(value, 2).paddedLeft(' ', 9); };
+
+    std::cout << name.paddedRight(' ', 44) << unit.paddedRight(' ', 12) << column(mean)
+              << column(getPercentile(values, 50.0)) << column(getPercentile(values, 90.0))
+              << column(getPercentile(values, 99.0)) << column(values.back()) << std::endl;
+}
+
+void BenchReport::addValue(const String& name, const String& unit, double value)
+{
+    auto* result = new DynamicObject();
+    result->setProperty("name", name);
+    result->setProperty("unit", unit);
+    result->setProperty("value", value);
+    results.add(var(result));
+
+    std::cout << name.paddedRight(' ', 44) << unit.paddedRight(' ', 12) << String(value, 3).paddedLeft(' ', 9) << std::endl;
+}
+
+void BenchReport::addCheck(const String& name, bool passed, const String& detail)
+{
+    auto* result = new DynamicObject();
+    result->setProperty("name", name);
+    result->setProperty("passed", passed);
+    result->setProperty("detail", detail);
+    results.add(var(result));
+
+    if (! passed)
+        ++numFailures;
+
+    std::cout << name.paddedRight(' ', 44) << String(passed ? "ok" : "FAILED").paddedRight(' ', 12) << detail << std::endl;
+}
+
+int BenchReport::getNumFailures() const
+{
+    return numFailures;
+}
+
+//==============================================================================
+bool BenchReport::writeJson(const File& file) const
+{
+    auto* root = new DynamicObject();
+    root->setProperty("bench", "OtoDecksBench");
+    root->setProperty("label", label);
+    root->setProperty("time", Time::getCurrentTime().toISO8601(true));
+    root->setProperty("cpu", SystemStats::getCpuModel());
+    root->setProperty("cores", SystemStats::getNumCpus());
+    root->setProperty("os", SystemStats::getOperatingSystemName());
+    root->setProperty("juce", SystemStats::getJUCEVersion());
+   #if JUCE_DEBUG
+    root->setProperty("build", "debug");
+   #else
+    root->setProperty("build", "release");
+   #endif
+    root->setProperty("failures", numFailures);
+    root->setProperty("results", results);
+
+    if (! file.replaceWithText(JSON::toString(var(root))))
+    {
+        std::cout << "BenchReport::writeJson could not write " << file.getFullPathName() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+double BenchReport::getPercentile(const std::vector<double>& sorted, double percentile)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    const auto rank = (size_t) std::ceil(percentile / 100.0 * (double) sorted.size());
+    return sorted[jlimit((size_t) 0, sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
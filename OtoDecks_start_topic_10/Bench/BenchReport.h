@@ -0,0 +1,81 @@
+/*
+==============================================================================
+BenchReport.h
+Created: 24 Oct 2026 4:51:30pm
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <vector>
+
+//==============================================================================
+/*
+    BenchReport collects benchmark results, prints each one as it arrives and
+    writes them all to a JSON file at the end.
+
+    A result is either a distribution of timings, summarised by its mean,
+    percentiles and maximum, or a single derived value such as a speedup.
+    Results are named "group/case/parameter" and kept in the order they were
+    added, so the JSON files from two commits can be diffed line by line.
+
+    A check is a result that passes or fails against a stated bound. Any
+    failed check fails the whole run.
+*/
+class BenchReport
+{
+public:
+    /**
+     * Constructor for BenchReport.
+     * @param _label Names the build being measured, e.g. a commit hash.
+     */
+    BenchReport(const String& _label);
+
+    /**
+     * Adds a distribution of measurements.
+     * @param name The result's name.
+     * @param unit The unit of the values, e.g. "ns/sample".
+     * @param values The measurements, in any order.
+     */
+    void add(const String& name, const String& unit, std::vector<double> values);
+
+    /**
+     * Adds a single value.
+     * @param name The result's name.
+     * @param unit The unit of the value.
+     * @param value The value.
+     */
+    void addValue(const String& name, const String& unit, double value);
+
+    /**
+     * Adds a check, printing FAILED and counting it if it did not pass.
+     * @param name The check's name.
+     * @param passed Whether the check passed.
+     * @param detail What was measured against what bound, e.g. "4.1% <= 5%".
+     */
+    void addCheck(const String& name, bool passed, const String& detail);
+
+    /** Returns the number of checks that failed. */
+    int getNumFailures() const;
+
+    /**
+     * Writes every result to a JSON file, with details of the machine.
+     * @param file The file to write, replaced if it exists.
+     * @return False if it could not be written.
+     */
+    bool writeJson(const File& file) const;
+
+    /**
+     * Gets a percentile of some measurements by nearest rank.
+     * @param sorted The values, sorted in ascending order.
+     * @param percentile From 0 to 100.
+     */
+    static double getPercentile(const std::vector<double>& sorted, double percentile);
+
+private:
+    String label;
+    Array<var> results;
+    int numFailures = 0;
+};
@@ -0,0 +1,127 @@
+/*
+==============================================================================
+TestTracks.cpp
+Created: 24 Oct 2026 4:58:12pm
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "TestTracks.h"
+#include "../Source/MixRenderer.h"
+
+namespace
+{
+    /** The kick's pitch and decay rate, and the off-beat noise's decay rate */
+    constexpr double kickHz = 55.0;
+    constexpr double kickDecay = 30.0;
+    constexpr double hatDecay = 200.0;
+
+    /** A, C and E, an octave below middle C and up */
+    constexpr double padHz[] = { 220.0, 261.63, 329.63 };
+    constexpr float padLevel = 0.08f;
+
+    /** Tracks are written in chunks this long, so long tracks need little memory */
+    constexpr int chunkSize = 65536;
+
+    constexpr int64 noiseSeed = 20261024;
+
+    /** Writes a track's audio through any writer */
+    bool writeAudio(AudioFormatWriter& writer, double sampleRate, int64 length, double bpm)
+    {
+        AudioBuffer<float> chunk(2, chunkSize);
+        Random random(noiseSeed);
+
+        for (int64 done = 0; done < length; done += chunkSize)
+        {
+            const int numSamples = (int) jmin((int64) chunkSize, length - done);
+            chunk.setSize(2, numSamples, false, false, true);
+            TestTracks::fill(chunk, sampleRate, bpm, done, random);
+
+            if (! writer.writeFromAudioSampleBuffer(chunk, 0, numSamples))
+                return false;
+        }
+
+        return true;
+    }
+}
+
+//==============================================================================
+void TestTracks::fill(AudioBuffer<float>& buffer, double sampleRate, double bpm, int64 startSample, Random& random)
+{
+    const double samplesPerBeat = sampleRate * 60.0 / bpm;
+
+    for (int i = 0; i < buffer.getNumSamples(); ++i)
+    {
+        const int64 n = startSample + i;
+        const double t = (double) n / sampleRate;
+        const double sinceBeat = std::fmod((double) n, samplesPerBeat) / sampleRate;
+        const double sinceOffBeat = std::fmod((double) n + samplesPerBeat / 2.0, samplesPerBeat) / sampleRate;
+
+        float sample = (float) (0.8 * std::sin(MathConstants<double>::twoPi * kickHz * sinceBeat) * std::exp(-sinceBeat * kickDecay));
+        sample += (random.nextFloat() * 2.0f - 1.0f) * 0.2f * (float) std::exp(-sinceOffBeat * hatDecay);
+
+        for (const double hz : padHz)
+            sample += padLevel * (float) std::sin(MathConstants<double>::twoPi * hz * t);
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            buffer.setSample(channel, i, sample);
+    }
+}
+
+//==============================================================================
+// A file that already exists with the expected length is kept, so repeated
+// runs do not spend their time writing test data
+bool TestTracks::write(const File& file, double sampleRate, double seconds, double bpm)
+{
+    const int64 length = (int64) (seconds * sampleRate);
+
+    AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    if (std::unique_ptr<AudioFormatReader> existing { formatManager.createReaderFor(file) })
+        if (existing->lengthInSamples == length && existing->sampleRate == sampleRate)
+            return true;
+
+    auto writer = MixRenderer::createWriter(file, sampleRate, 16);
+    return writer != nullptr && writeAudio(*writer, sampleRate, length, bpm);
+}
+
+// The encoder pads the length, so an existing file is kept if it has any.
+// LAME only runs when the writer is deleted, so it is deleted before the
+// file is checked.
+bool TestTracks::writeMp3(const File& file, const File& lame, bool vbr, double seconds, double bpm)
+{
+   #if JUCE_USE_LAME_AUDIO_FORMAT
+    if (file.getSize() > 0)
+        return true;
+
+    constexpr double sampleRate = 44100.0;
+    LAMEEncoderAudioFormat format(lame);
+    const int quality = format.getQualityOptions().indexOf(vbr ? "VBR quality 2" : "128 Kb/s CBR");
+
+    bool written = false;
+
+    {
+        auto out = file.createOutputStream();
+
+        if (out == nullptr || quality < 0)
+            return false;
+
+        std::unique_ptr<AudioFormatWriter> writer(format.createWriterFor(out.get(), sampleRate, 2, 16, {}, quality));
+        if (writer == nullptr)
+            return false;
+
+        out.release();  // Now the writer's
+        written = writeAudio(*writer, sampleRate, (int64) (seconds * sampleRate), bpm);
+    }
+
+    if (written && file.getSize() > 0)
+        return true;
+
+    file.deleteFile();  // Or the next run would take it for a finished track
+    return false;
+   #else
+    ignoreUnused(file, lame, vbr, seconds, bpm);
+    return false;
+   #endif
+}
@@ -0,0 +1,56 @@
+/*
+==============================================================================
+TestTracks.h
+Created: 24 Oct 2026 4:58:12pm
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/*
+    TestTracks writes synthetic tracks for the benchmarks, so every machine
+    measures the same audio without shipping any.
+
+    Each track is a steady four-to-the-floor beat: a decaying 55 Hz kick on
+    every beat, a burst of noise on every off-beat and an A minor pad
+    underneath, which gives the analyser a clear tempo, key and loudness.
+    The noise comes from a fixed seed, so a track is the same every time it
+    is written.
+*/
+namespace TestTracks
+{
+    /**
+     * Writes a stereo track, unless an identical one is already there.
+     * @param file A .wav or .flac file.
+     * @param sampleRate The track's sample rate.
+     * @param seconds The track's length.
+     * @param bpm The tempo of its beat.
+     * @return False if the file could not be written.
+     */
+    bool write(const File& file, double sampleRate, double seconds, double bpm);
+
+    /**
+     * Writes a stereo MP3 track by running LAME, unless the file is already there.
+     * @param file The .mp3 file.
+     * @param lame The LAME executable.
+     * @param vbr True for variable bit rate (with a Xing header), false for 128 kb/s CBR (with an Info header).
+     * @param seconds The track's length, at 44.1 kHz.
+     * @param bpm The tempo of its beat.
+     * @return False if the file could not be written, or this build has no LAME support.
+     */
+    bool writeMp3(const File& file, const File& lame, bool vbr, double seconds, double bpm);
+
+    /**
+     * Fills a buffer with part of a track.
+     * @param buffer Receives the audio, in every channel.
+     * @param sampleRate The track's sample rate.
+     * @param bpm The tempo of its beat.
+     * @param startSample Where in the track the buffer starts.
+     * @param random The noise source, advanced by the samples generated.
+     */
+    void fill(AudioBuffer<float>& buffer, double sampleRate, double bpm, int64 startSample, Random& random);
+}
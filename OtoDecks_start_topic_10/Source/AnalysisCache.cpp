@@ -0,0 +1,257 @@
+/*
+==============================================================================
+AnalysisCache.cpp
+Created: 22 Oct 2026 11:32:18am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "AnalysisCache.h"
+
+namespace
+{
+    /** "OTAC", and the layout version */
+    constexpr int cacheMagic = 0x4f544143;
+    constexpr int cacheVersion = 1;
+
+    /** Bytes sampled from each of the start, middle and end of a file for its hash */
+    constexpr int hashSampleSize = 65536;
+
+    /** Writes one kind of analysis as a block: its kind, its size, then its data */
+    void writeBlock(OutputStream& out, int kind, const MemoryBlock& data)
+    {
+        out.writeInt(kind);
+        out.writeInt((int) data.getSize());
+        out.write(data.getData(), data.getSize());
+    }
+
+    /** Pitch class names from C, with the spellings DJs use */
+    const char* const pitchNames[12] = { "C", "C#", "D", "Eb", "E", "F", "F#", "G", "Ab", "A", "Bb", "B" };
+}
+
+//==============================================================================
+String TrackAnalysis::getKeyName() const
+{
+    if (! hasKey())
+        return {};
+
+    return String(pitchNames[musicalKey % 12]) + (musicalKey >= 12 ? "m" : "");
+}
+
+// Camelot numbers step round the circle of fifths, with 8B at C major; a minor
+// key shares its number with its relative major, three semitones up
+String TrackAnalysis::getCamelotKey() const
+{
+    if (! hasKey())
+        return {};
+
+    const bool minor = musicalKey >= 12;
+    const int major = (musicalKey % 12 + (minor ? 3 : 0)) % 12;
+    return String((major * 7 + 7) % 12 + 1) + (minor ? "A" : "B");
+}
+
+//==============================================================================
+// Constructor: Loads whatever previous sessions found
+AnalysisCache::AnalysisCache()
+{
+    load();
+}
+
+AnalysisCache::~AnalysisCache()
+{
+    save();
+}
+
+File AnalysisCache::getCacheFile()
+{
+    return File::getSpecialLocation(File::userApplicationDataDirectory)
+               .getChildFile("OtoDecks")
+               .getChildFile("Analysis")
+               .getChildFile("analysis.cache");
+}
+
+//==============================================================================
+// MD5 of the size and the three samples. Tags are usually at the very start
+// or end, so retagging a file counts as a new track; that only costs a re-analysis.
+String AnalysisCache::getContentHash(const File& file)
+{
+    FileInputStream in(file);
+    if (in.failedToOpen())
+        return {};
+
+    const int64 size = in.getTotalLength();
+    MemoryOutputStream sampled;
+    sampled.writeInt64(size);
+
+    for (const int64 start : { (int64) 0, (size - hashSampleSize) / 2, size - hashSampleSize })
+    {
+        if (! in.setPosition(jmax((int64) 0, start)))
+            return {};
+
+        sampled.writeFromInputStream(in, hashSampleSize);
+    }
+
+    return MD5(sampled.getData(), sampled.getDataSize()).toHexString();
+}
+
+//==============================================================================
+bool AnalysisCache::lookup(const String& hash, TrackAnalysis& result) const
+{
+    const ScopedLock sl(lock);
+    const auto entry = entries.find(hash);
+
+    if (entry == entries.end())
+        return false;
+
+    result = entry->second;
+    return true;
+}
+
+void AnalysisCache::store(const String& hash, const TrackAnalysis& analysis)
+{
+    const ScopedLock sl(lock);
+    entries[hash] = analysis;
+    dirty = true;
+}
+
+int AnalysisCache::getNumEntries() const
+{
+    const ScopedLock sl(lock);
+    return (int) entries.size();
+}
+
+//==============================================================================
+// Each entry is its hash and a list of blocks. Blocks of kinds this version
+// does not know about are skipped.
+void AnalysisCache::load()
+{
+    const File cacheFile = getCacheFile();
+
+    if (! cacheFile.existsAsFile())
+        return;
+
+    FileInputStream fileStream(cacheFile);
+    if (fileStream.failedToOpen())
+        return;
+
+    BufferedInputStream in(fileStream, 65536);
+
+    if (in.readInt() != cacheMagic || in.readInt() != cacheVersion)
+        return;
+
+    const int numEntries = in.readInt();
+    const ScopedLock sl(lock);
+
+    for (int i = 0; i < numEntries && ! in.isExhausted(); ++i)
+    {
+        const String hash = in.readString();
+        const int numBlocks = in.readInt();
+        TrackAnalysis analysis;
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            const int kind = in.readInt();
+            const int size = in.readInt();
+
+            if (size < 0 || size > in.getNumBytesRemaining())
+                return;  // Truncated; keep the entries read so far
+
+            MemoryBlock data;
+            in.readIntoMemoryBlock(data, size);
+            MemoryInputStream block(data, false);
+
+            if (kind == TrackAnalysis::tempo)
+            {
+                analysis.bpm = block.readDouble();
+                analysis.firstBeatSeconds = block.readDouble();
+                analysis.beatConfidence = block.readFloat();
+                analysis.kinds |= TrackAnalysis::tempo;
+            }
+            else if (kind == TrackAnalysis::key)
+            {
+                analysis.musicalKey = block.readInt();
+                analysis.keyConfidence = block.readFloat();
+                analysis.kinds |= TrackAnalysis::key;
+            }
+            else if (kind == TrackAnalysis::loudness)
+            {
+                analysis.integratedLufs = block.readDouble();
+                analysis.truePeakDb = block.readDouble();
+                analysis.firstAudibleSample = block.readInt64();
+                analysis.lastAudibleSample = block.readInt64();
+                analysis.kinds |= TrackAnalysis::loudness;
+            }
+        }
+
+        entries[hash] = analysis;
+    }
+}
+
+bool AnalysisCache::save()
+{
+    const ScopedLock sl(lock);
+
+    if (! dirty)
+        return true;
+
+    const File cacheFile = getCacheFile();
+
+    if (! cacheFile.getParentDirectory().createDirectory())
+        return false;
+
+    TemporaryFile temp(cacheFile);
+
+    {
+        FileOutputStream fileStream(temp.getFile());
+        if (fileStream.failedToOpen())
+            return false;
+
+        fileStream.writeInt(cacheMagic);
+        fileStream.writeInt(cacheVersion);
+        fileStream.writeInt((int) entries.size());
+
+        for (const auto& [hash, analysis] : entries)
+        {
+            fileStream.writeString(hash);
+            fileStream.writeInt((analysis.has(TrackAnalysis::tempo) ? 1 : 0) + (analysis.has(TrackAnalysis::key) ? 1 : 0)
+                                + (analysis.has(TrackAnalysis::loudness) ? 1 : 0));
+
+            if (analysis.has(TrackAnalysis::tempo))
+            {
+                MemoryOutputStream block;
+                block.writeDouble(analysis.bpm);
+                block.writeDouble(analysis.firstBeatSeconds);
+                block.writeFloat(analysis.beatConfidence);
+                writeBlock(fileStream, TrackAnalysis::tempo, block.getMemoryBlock());
+            }
+
+            if (analysis.has(TrackAnalysis::key))
+            {
+                MemoryOutputStream block;
+                block.writeInt(analysis.musicalKey);
+                block.writeFloat(analysis.keyConfidence);
+                writeBlock(fileStream, TrackAnalysis::key, block.getMemoryBlock());
+            }
+
+            if (analysis.has(TrackAnalysis::loudness))
+            {
+                MemoryOutputStream block;
+                block.writeDouble(analysis.integratedLufs);
+                block.writeDouble(analysis.truePeakDb);
+                block.writeInt64(analysis.firstAudibleSample);
+                block.writeInt64(analysis.lastAudibleSample);
+                writeBlock(fileStream, TrackAnalysis::loudness, block.getMemoryBlock());
+            }
+        }
+
+        fileStream.flush();
+        if (fileStream.getStatus().failed())
+            return false;
+    }
+
+    if (! temp.overwriteTargetFileWithTemporary())
+        return false;
+
+    dirty = false;
+    return true;
+}
@@ -0,0 +1,143 @@
+/*
+==============================================================================
+AnalysisCache.h
+Created: 22 Oct 2026 11:32:18am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <map>
+
+//==============================================================================
+/*
+    What the background analysis has found out about one track. Each kind of
+    analysis sets its flag when it has run, so a track that was analysed but
+    had no steady pulse is not analysed again.
+*/
+struct TrackAnalysis
+{
+    /** The kinds of analysis, as bit flags */
+    enum Kind
+    {
+        tempo = 1 << 0,
+        key = 1 << 1,
+        loudness = 1 << 2
+    };
+
+    /** Every kind the analyser runs */
+    static constexpr int allKinds = tempo | key | loudness;
+
+    int kinds = 0;
+
+    /** Tempo and beatgrid; bpm is 0 if no steady pulse was found */
+    double bpm = 0.0;
+    double firstBeatSeconds = 0.0;
+    float beatConfidence = 0.0f;
+
+    /** Musical key, 0 to 11 for C major to B major and 12 to 23 for C minor to B minor;
+        -1 if none was found */
+    int musicalKey = -1;
+    float keyConfidence = 0.0f;
+
+    /** EBU R128 integrated loudness and true peak, and the audible part of the track in
+        source samples. The last audible sample is 0 if the track is silent or too quiet
+        to pass the loudness gate, and then the other three are not measured. */
+    double integratedLufs = 0.0;
+    double truePeakDb = 0.0;
+    int64 firstAudibleSample = 0;
+    int64 lastAudibleSample = 0;
+
+    /** Returns true if the given kind of analysis has run. */
+    bool has(Kind kind) const { return (kinds & kind) != 0; }
+
+    /** Returns true if every kind of analysis has run. */
+    bool isComplete() const { return (kinds & allKinds) == allKinds; }
+
+    /** Returns true if a tempo was found. */
+    bool hasTempo() const { return has(tempo) && bpm > 0.0; }
+
+    /** Returns true if a key was found. */
+    bool hasKey() const { return has(key) && musicalKey >= 0; }
+
+    /** Returns true if the track's loudness was measured: false for a track too quiet to pass the gate. */
+    bool hasLoudness() const { return has(loudness) && lastAudibleSample > 0; }
+
+    /** Returns the key's name, such as "Am" or "F#", or an empty string if none was found. */
+    String getKeyName() const;
+
+    /** Returns the key on the Camelot wheel, such as "8A" for A minor, or an empty string. */
+    String getCamelotKey() const;
+};
+
+//==============================================================================
+/*
+    AnalysisCache keeps analysis results between sessions, so a library is
+    analysed only once. Entries are keyed by a hash of the file's content
+    rather than its path, so they follow a track that is moved or renamed,
+    or the same track in two places.
+
+    The hash covers the file size and three 64 KB samples of its bytes, from
+    the start, middle and end, which identifies a track for a fraction of the
+    cost of reading all of it.
+
+    All entries are held in memory and written to a single file in the
+    application's data directory. Each kind of analysis is stored as its own
+    tagged block, so a cache written by a newer version can still be read.
+    Use it through SharedResourcePointer<AnalysisCache>. Thread-safe.
+*/
+class AnalysisCache
+{
+public:
+    /** Constructor: loads the cache file, if there is one */
+    AnalysisCache();
+
+    /** Destructor: saves any unsaved changes */
+    ~AnalysisCache();
+
+    /**
+     * Works out the content hash a file is cached under. Reads about 200 KB of it.
+     * @param file The audio file.
+     * @return The hash as hex, or an empty string if the file could not be read.
+     */
+    static String getContentHash(const File& file);
+
+    /**
+     * Looks up a track.
+     * @param hash The track's content hash.
+     * @param result Receives the stored analysis.
+     * @return True if the track has an entry.
+     */
+    bool lookup(const String& hash, TrackAnalysis& result) const;
+
+    /**
+     * Stores a track's analysis, replacing any earlier entry. Call save() to write it to disk.
+     * @param hash The track's content hash.
+     * @param analysis The analysis to store.
+     */
+    void store(const String& hash, const TrackAnalysis& analysis);
+
+    /**
+     * Writes the cache file if anything has changed since it was last written.
+     * @return False if writing failed.
+     */
+    bool save();
+
+    /** Returns the number of tracks in the cache. */
+    int getNumEntries() const;
+
+    /** Returns the file the cache is kept in. */
+    static File getCacheFile();
+
+private:
+    /** Reads the cache file into memory */
+    void load();
+
+    mutable CriticalSection lock;
+    std::map<String, TrackAnalysis> entries;
+    bool dirty = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalysisCache)
+};
@@ -0,0 +1,109 @@
+/*
+==============================================================================
+AudioStatsPanel.cpp
+Created: 25 Oct 2026 11:03:52am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "AudioStatsPanel.h"
+
+namespace
+{
+    /** Times shown under a millisecond in microseconds, and above it in milliseconds */
+    String formatMicros(double micros)
+    {
+        return micros < 1000.0 ? String(roundToInt(micros)) + " us" : String(micros / 1000.0, 2) + " ms";
+    }
+}
+
+//==============================================================================
+AudioStatsPanel::AudioStatsPanel(AudioTimingMonitor& _monitor)
+    : monitor(_monitor)
+{
+    addAndMakeVisible(dumpButton);
+    dumpButton.onClick = [this]() { dump(); };
+
+    addAndMakeVisible(resetButton);
+    resetButton.onClick = [this]() { monitor.reset(); };
+
+    // Off by default: the mixer starts no worker threads until this is first ticked
+    addAndMakeVisible(parallelButton);
+    parallelButton.onClick = [this]()
+    {
+        if (onParallelRenderingChanged != nullptr)
+            onParallelRenderingChanged(parallelButton.getToggleState());
+    };
+
+    startTimer(250);
+}
+
+AudioStatsPanel::~AudioStatsPanel()
+{
+    stopTimer();
+}
+
+void AudioStatsPanel::setNumDecks(int newNumDecks)
+{
+    numDecks = jlimit(1, monitor.getNumDecks(), newNumDecks);
+}
+
+//==============================================================================
+void AudioStatsPanel::paint(Graphics& g)
+{
+    g.setColour(Colours::grey);
+    g.drawRect(getLocalBounds(), 1);
+
+    // Red once anything has overrun, so a dropout is noticed after the fact
+    g.setColour(monitor.getNumOverruns() > 0 ? Colours::red : getLookAndFeel().findColour(Label::textColourId));
+    g.setFont(13.0f);
+
+    auto area = getLocalBounds().reduced(6, 4).withTrimmedRight(265);
+    g.drawFittedText(summary, area.removeFromTop(area.getHeight() / 2), Justification::centredLeft, 1);
+
+    g.setColour(getLookAndFeel().findColour(Label::textColourId));
+    g.drawFittedText(deckSummary, area, Justification::centredLeft, 2);
+}
+
+void AudioStatsPanel::resized()
+{
+    auto area = getLocalBounds().reduced(4);
+    auto buttons = area.removeFromRight(255).withSizeKeepingCentre(255, jmin(24, area.getHeight()));
+    resetButton.setBounds(buttons.removeFromRight(65));
+    dumpButton.setBounds(buttons.removeFromRight(75).withTrimmedRight(10));
+    parallelButton.setBounds(buttons.withTrimmedRight(5));
+}
+
+//==============================================================================
+void AudioStatsPanel::timerCallback()
+{
+    const auto& callbacks = monitor.getCallbackTimes();
+
+    summary = "DSP load " + String(monitor.getLoadPercent(), 1) + "% (peak " + String(monitor.getPeakLoadPercent(), 1) + "%)"
+            + "   callback p50 " + formatMicros(callbacks.getPercentile(50.0))
+            + "  p99 " + formatMicros(callbacks.getPercentile(99.0))
+            + "  max " + formatMicros(callbacks.getMax())
+            + "   overruns " + String(monitor.getNumOverruns());
+
+    deckSummary = "Deck p99:";
+    for (int i = 0; i < numDecks; ++i)
+        deckSummary << "  " << (i + 1) << ": " << formatMicros(monitor.getDeckTimes(i).getPercentile(99.0));
+
+    repaint();
+}
+
+void AudioStatsPanel::dump()
+{
+    chooser = std::make_unique<FileChooser>("Dump audio timings to...",
+                                            File::getSpecialLocation(File::userDocumentsDirectory).getChildFile("OtoDecksTimings.json"),
+                                            "*.json");
+
+    chooser->launchAsync(FileBrowserComponent::saveMode | FileBrowserComponent::canSelectFiles
+                         | FileBrowserComponent::warnAboutOverwriting,
+        [this](const FileChooser& fc)
+        {
+            const File file = fc.getResult();
+            if (file != File())
+                monitor.dumpToFile(file);
+        });
+}
@@ -0,0 +1,64 @@
+/*
+==============================================================================
+AudioStatsPanel.h
+Created: 25 Oct 2026 11:03:52am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "AudioTimingMonitor.h"
+
+//==============================================================================
+/*
+    AudioStatsPanel shows an AudioTimingMonitor's figures a few times a
+    second: the DSP load and its peak, the callback's median, 99th percentile
+    and worst time, the overrun count, and each deck's 99th percentile.
+    Its buttons clear the figures and dump them to a JSON file, and its
+    toggle switches the mixer between serial and parallel deck rendering.
+*/
+class AudioStatsPanel : public Component,
+                        private Timer
+{
+public:
+    /**
+     * Constructor for AudioStatsPanel.
+     * @param _monitor The monitor to show (not owned).
+     */
+    AudioStatsPanel(AudioTimingMonitor& _monitor);
+
+    /** Destructor */
+    ~AudioStatsPanel() override;
+
+    /** Sets how many decks are shown, from the first. */
+    void setNumDecks(int numDecks);
+
+    /** Called when the parallel rendering toggle is clicked, with its new state */
+    std::function<void(bool shouldRenderInParallel)> onParallelRenderingChanged;
+
+    //==============================================================================
+    void paint(Graphics& g) override;
+    void resized() override;
+
+private:
+    void timerCallback() override;
+
+    /** Asks for a file and dumps the monitor's figures to it */
+    void dump();
+
+    AudioTimingMonitor& monitor;
+    int numDecks = 1;
+
+    /** The text shown, rebuilt on every timer tick */
+    String summary;
+    String deckSummary;
+
+    TextButton dumpButton{"Dump"};
+    TextButton resetButton{"Reset"};
+    ToggleButton parallelButton{"Parallel decks"};
+    std::unique_ptr<FileChooser> chooser;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioStatsPanel)
+};
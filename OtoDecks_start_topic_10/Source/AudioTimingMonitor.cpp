@@ -0,0 +1,254 @@
+/*
+==============================================================================
+AudioTimingMonitor.cpp
+Created: 25 Oct 2026 10:12:37am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "AudioTimingMonitor.h"
+
+namespace
+{
+    /** Seconds over which the displayed DSP load is smoothed */
+    constexpr double loadSmoothingSeconds = 1.0;
+
+    /** Raises an atomic to a value if it is higher, without a lock */
+    void raiseTo(std::atomic<double>& target, double value)
+    {
+        double current = target.load(std::memory_order_relaxed);
+        while (value > current && ! target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+        {
+        }
+    }
+}
+
+//==============================================================================
+TimingHistogram::TimingHistogram()
+{
+    for (auto& bucket : buckets)
+        bucket.store(0);
+}
+
+// Bucket 0 takes everything under a microsecond and the last bucket everything
+// over its lower edge
+void TimingHistogram::record(double micros)
+{
+    const int bucket = micros > 1.0 ? jmin(numBuckets - 1, (int) (std::log2(micros) * bucketsPerOctave)) : 0;
+
+    buckets[(size_t) bucket].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+
+    double total = totalMicros.load(std::memory_order_relaxed);
+    while (! totalMicros.compare_exchange_weak(total, total + micros, std::memory_order_relaxed))
+    {
+    }
+
+    raiseTo(maxMicros, micros);
+}
+
+void TimingHistogram::reset()
+{
+    for (auto& bucket : buckets)
+        bucket.store(0, std::memory_order_relaxed);
+
+    count = 0;
+    totalMicros = 0.0;
+    maxMicros = 0.0;
+}
+
+int64 TimingHistogram::getCount() const
+{
+    return count.load(std::memory_order_relaxed);
+}
+
+double TimingHistogram::getMean() const
+{
+    const int64 n = getCount();
+    return n > 0 ? totalMicros.load(std::memory_order_relaxed) / (double) n : 0.0;
+}
+
+double TimingHistogram::getMax() const
+{
+    return maxMicros.load(std::memory_order_relaxed);
+}
+
+// The buckets are summed rather than trusting count, which the audio thread
+// may have moved on since
+double TimingHistogram::getPercentile(double percentile) const
+{
+    std::array<int64, numBuckets> counts;
+    int64 total = 0;
+
+    for (int i = 0; i < numBuckets; ++i)
+        total += (counts[(size_t) i] = getBucketCount(i));
+
+    if (total == 0)
+        return 0.0;
+
+    const int64 rank = jmax((int64) 1, (int64) std::ceil(percentile / 100.0 * (double) total));
+    int64 seen = 0;
+
+    for (int i = 0; i < numBuckets; ++i)
+    {
+        seen += counts[(size_t) i];
+
+        if (seen >= rank)
+            return jmin(getBucketLimit(i), getMax());
+    }
+
+    return getMax();
+}
+
+double TimingHistogram::getBucketLimit(int bucket)
+{
+    return std::exp2((double) (bucket + 1) / bucketsPerOctave);
+}
+
+int64 TimingHistogram::getBucketCount(int bucket) const
+{
+    return buckets[(size_t) bucket].load(std::memory_order_relaxed);
+}
+
+//==============================================================================
+AudioTimingMonitor::AudioTimingMonitor(int _numDecks)
+{
+    for (int i = 0; i < _numDecks; ++i)
+        deckTimes.add(new TimingHistogram());
+}
+
+void AudioTimingMonitor::prepare(double newSampleRate)
+{
+    if (newSampleRate > 0.0)
+        sampleRate = newSampleRate;
+}
+
+// The deadline is the length of the block: a callback that takes longer than
+// that has made the device wait
+void AudioTimingMonitor::recordCallback(int64 startTicks, int numSamples)
+{
+    if (numSamples <= 0)
+        return;
+
+    const double micros = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - startTicks) * 1.0e6;
+    const double blockMicros = numSamples / sampleRate.load(std::memory_order_relaxed) * 1.0e6;
+    const double load = micros / blockMicros * 100.0;
+
+    callbackTimes.record(micros);
+    loadPercentages.record(load);
+    raiseTo(peakLoad, load);
+
+    if (micros > blockMicros)
+        numOverruns.fetch_add(1, std::memory_order_relaxed);
+
+    const double smoothing = jmin(1.0, blockMicros / (loadSmoothingSeconds * 1.0e6));
+    smoothedLoad = smoothedLoad.load(std::memory_order_relaxed) + smoothing * (load - smoothedLoad.load(std::memory_order_relaxed));
+}
+
+void AudioTimingMonitor::recordDeck(int deck, double micros)
+{
+    if (isPositiveAndBelow(deck, deckTimes.size()))
+        deckTimes.getUnchecked(deck)->record(micros);
+}
+
+void AudioTimingMonitor::reset()
+{
+    callbackTimes.reset();
+    loadPercentages.reset();
+
+    for (auto* histogram : deckTimes)
+        histogram->reset();
+
+    peakLoad = 0.0;
+    numOverruns = 0;
+}
+
+//==============================================================================
+const TimingHistogram& AudioTimingMonitor::getCallbackTimes() const
+{
+    return callbackTimes;
+}
+
+const TimingHistogram& AudioTimingMonitor::getLoadPercentages() const
+{
+    return loadPercentages;
+}
+
+const TimingHistogram& AudioTimingMonitor::getDeckTimes(int deck) const
+{
+    return *deckTimes[jlimit(0, deckTimes.size() - 1, deck)];
+}
+
+int AudioTimingMonitor::getNumDecks() const
+{
+    return deckTimes.size();
+}
+
+double AudioTimingMonitor::getLoadPercent() const
+{
+    return smoothedLoad.load(std::memory_order_relaxed);
+}
+
+double AudioTimingMonitor::getPeakLoadPercent() const
+{
+    return peakLoad.load(std::memory_order_relaxed);
+}
+
+int64 AudioTimingMonitor::getNumOverruns() const
+{
+    return numOverruns.load(std::memory_order_relaxed);
+}
+
+//==============================================================================
+// Decks that never rendered are left out
+bool AudioTimingMonitor::dumpToFile(const File& file) const
+{
+    auto* root = new DynamicObject();
+    root->setProperty("time", Time::getCurrentTime().toISO8601(true));
+    root->setProperty("sampleRate", sampleRate.load());
+    root->setProperty("overruns", getNumOverruns());
+    root->setProperty("peakLoadPercent", getPeakLoadPercent());
+    root->setProperty("callbackMicros", toVar(callbackTimes));
+    root->setProperty("loadPercent", toVar(loadPercentages));
+
+    Array<var> decks;
+    for (int i = 0; i < deckTimes.size(); ++i)
+    {
+        if (deckTimes[i]->getCount() == 0)
+            continue;
+
+        var deck = toVar(*deckTimes[i]);
+        deck.getDynamicObject()->setProperty("deck", i + 1);
+        decks.add(deck);
+    }
+    root->setProperty("deckMicros", decks);
+
+    if (! file.replaceWithText(JSON::toString(var(root))))
+    {
+        std::cout << "AudioTimingMonitor::dumpToFile could not write " << file.getFullPathName() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+var AudioTimingMonitor::toVar(const TimingHistogram& histogram)
+{
+    auto* summary = new DynamicObject();
+    summary->setProperty("count", histogram.getCount());
+    summary->setProperty("mean", histogram.getMean());
+    summary->setProperty("p50", histogram.getPercentile(50.0));
+    summary->setProperty("p90", histogram.getPercentile(90.0));
+    summary->setProperty("p99", histogram.getPercentile(99.0));
+    summary->setProperty("p999", histogram.getPercentile(99.9));
+    summary->setProperty("max", histogram.getMax());
+
+    // Each bucket as [upper edge, count]
+    Array<var> buckets;
+    for (int i = 0; i < TimingHistogram::numBuckets; ++i)
+        if (const int64 n = histogram.getBucketCount(i))
+            buckets.add(Array<var>{ TimingHistogram::getBucketLimit(i), n });
+
+    summary->setProperty("buckets", buckets);
+    return var(summary);
+}
@@ -0,0 +1,154 @@
+/*
+==============================================================================
+AudioTimingMonitor.h
+Created: 25 Oct 2026 10:12:37am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <array>
+#include <atomic>
+
+//==============================================================================
+/*
+    TimingHistogram counts durations in logarithmic buckets, eight to an octave,
+    from one microsecond up to about a second. Every bucket is an atomic
+    counter, so the audio thread records without locking or allocating and any
+    other thread can read percentiles while it does. A percentile is reported
+    as the upper edge of its bucket, which is within 9% of the true value.
+*/
+class TimingHistogram
+{
+public:
+    static constexpr int bucketsPerOctave = 8;
+    static constexpr int numBuckets = 20 * bucketsPerOctave;
+
+    TimingHistogram();
+
+    /** Records one duration. Lock-free; safe to call from any thread. */
+    void record(double micros);
+
+    /** Clears every count. Counts recorded during the reset may be lost. */
+    void reset();
+
+    /** Returns the number of durations recorded. */
+    int64 getCount() const;
+
+    /** Returns the mean duration in microseconds. */
+    double getMean() const;
+
+    /** Returns the longest duration in microseconds. */
+    double getMax() const;
+
+    /**
+     * Gets a percentile of the recorded durations.
+     * @param percentile From 0 to 100.
+     * @return The duration in microseconds, or 0 if nothing has been recorded.
+     */
+    double getPercentile(double percentile) const;
+
+    /** Returns the upper edge of a bucket in microseconds. */
+    static double getBucketLimit(int bucket);
+
+    /** Returns a bucket's count. */
+    int64 getBucketCount(int bucket) const;
+
+private:
+    std::array<std::atomic<int64>, numBuckets> buckets;
+    std::atomic<int64> count{0};
+    std::atomic<double> totalMicros{0.0};
+    std::atomic<double> maxMicros{0.0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TimingHistogram)
+};
+
+//==============================================================================
+/*
+    AudioTimingMonitor measures how close the audio callback runs to its
+    deadline. The callback reports how long each block took and the mixer
+    reports how long each deck took to render. Every duration goes into a
+    TimingHistogram, and the callback's duration is also divided by the
+    block's length to give the DSP load. A callback that took longer than
+    its block lasts missed its deadline and is counted as an overrun.
+
+    Recording costs two tick reads and a few atomic adds, so it stays on in
+    release builds. The GUI reads the figures from a timer and dumpToFile()
+    writes them out as JSON.
+*/
+class AudioTimingMonitor
+{
+public:
+    /**
+     * Constructor for AudioTimingMonitor.
+     * @param _numDecks The number of decks timed separately.
+     */
+    AudioTimingMonitor(int _numDecks);
+
+    /** Sets the sample rate that block lengths are measured at. */
+    void prepare(double sampleRate);
+
+    /**
+     * Records one audio callback. Called on the audio thread when it returns.
+     * @param startTicks Time::getHighResolutionTicks() when the callback started.
+     * @param numSamples The length of the block.
+     */
+    void recordCallback(int64 startTicks, int numSamples);
+
+    /**
+     * Records one deck rendering part of a block, on whichever thread rendered it.
+     * @param deck The deck's index.
+     * @param micros The time its render took.
+     */
+    void recordDeck(int deck, double micros);
+
+    /** Clears every histogram and counter. */
+    void reset();
+
+    //==============================================================================
+    /** Returns the callback durations. */
+    const TimingHistogram& getCallbackTimes() const;
+
+    /** Returns the DSP load of each callback, as a percentage of its block's length. */
+    const TimingHistogram& getLoadPercentages() const;
+
+    /** Returns one deck's render times. */
+    const TimingHistogram& getDeckTimes(int deck) const;
+
+    /** Returns the number of decks timed. */
+    int getNumDecks() const;
+
+    /** Returns the DSP load as a percentage, smoothed over roughly the last second. */
+    double getLoadPercent() const;
+
+    /** Returns the highest DSP load of any one callback since the last reset. */
+    double getPeakLoadPercent() const;
+
+    /** Returns the number of callbacks that took longer than their block lasts. */
+    int64 getNumOverruns() const;
+
+    /**
+     * Writes every histogram and counter to a JSON file.
+     * @param file The file to write, replaced if it exists.
+     * @return False if it could not be written.
+     */
+    bool dumpToFile(const File& file) const;
+
+private:
+    /** Summarises a histogram, with its non-empty buckets, for the JSON dump */
+    static var toVar(const TimingHistogram& histogram);
+
+    std::atomic<double> sampleRate{44100.0};
+
+    TimingHistogram callbackTimes;
+    TimingHistogram loadPercentages;
+    OwnedArray<TimingHistogram> deckTimes;
+
+    std::atomic<double> smoothedLoad{0.0};
+    std::atomic<double> peakLoad{0.0};
+    std::atomic<int64> numOverruns{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioTimingMonitor)
+};
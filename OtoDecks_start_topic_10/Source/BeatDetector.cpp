@@ -0,0 +1,270 @@
+/*
+==============================================================================
+BeatDetector.cpp
+Created: 22 Oct 2026 10:05:37am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "BeatDetector.h"
+
+namespace
+{
+    /** Envelope frames per second */
+    constexpr double frameRate = 100.0;
+
+    /** The low band sits below the first cutoff, the high band above the second */
+    constexpr double lowBandHz = 150.0;
+    constexpr double highBandHz = 4000.0;
+
+    /** Scales the mean square before the log, which compresses loud and quiet passages alike */
+    constexpr float levelScale = 1000.0f;
+
+    /** Half the window over which the envelope's local mean is taken out, in frames */
+    constexpr int meanHalfWidth = 25;
+
+    /** The least audio worth analysing, in seconds */
+    constexpr double minimumSeconds = 10.0;
+
+    /** Beat multiples covered by the coarse autocorrelation pass */
+    constexpr int coarseBeats = 4;
+
+    /** Tempo search steps: the coarse pass, then the fine pass either side of the coarse
+        tempo (which is within a few tenths of a BPM), then a final polish */
+    constexpr double coarseStepBpm = 0.1;
+    constexpr double fineRangeBpm = 0.5;
+    constexpr double fineStepBpm = 0.005;
+    constexpr double polishStepBpm = 0.0005;
+
+    /** Steps between grid offsets tried by the fine pass and the polish, in frames */
+    constexpr double fineOffsetStep = 0.5;
+    constexpr double polishOffsetStep = 0.05;
+
+    /** Below this confidence no tempo is reported */
+    constexpr float minimumConfidence = 0.05f;
+}
+
+//==============================================================================
+// Constructor: One envelope frame per hop, the two band splits set for the sample rate
+BeatDetector::BeatDetector(double _sampleRate)
+    : sampleRate(_sampleRate),
+      hopSize(jmax(1, roundToInt(_sampleRate / frameRate)))
+{
+    lowCoefficient = (float) (1.0 - std::exp(-MathConstants<double>::twoPi * lowBandHz / sampleRate));
+    highCoefficient = (float) (1.0 - std::exp(-MathConstants<double>::twoPi * highBandHz / sampleRate));
+}
+
+void BeatDetector::reset()
+{
+    lowState = highSplitState = 0.0f;
+    lowEnergy = highEnergy = 0.0f;
+    samplesInFrame = 0;
+    lastLowLevel = lastHighLevel = 0.0f;
+    envelope.clear();
+}
+
+double BeatDetector::getFrameRate() const
+{
+    return sampleRate / hopSize;
+}
+
+const std::vector<float>& BeatDetector::getOnsetEnvelope() const
+{
+    return envelope;
+}
+
+size_t BeatDetector::getMemoryUsage() const
+{
+    return sizeof(*this) + envelope.capacity() * sizeof(float);
+}
+
+//==============================================================================
+void BeatDetector::process(const float* samples, int numSamples)
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float x = samples[i];
+
+        lowState += lowCoefficient * (x - lowState);
+        highSplitState += highCoefficient * (x - highSplitState);
+        const float high = x - highSplitState;
+
+        lowEnergy += lowState * lowState;
+        highEnergy += high * high;
+
+        if (++samplesInFrame == hopSize)
+            finishFrame();
+    }
+}
+
+// Only rises in level count as onsets, so a note dying away adds nothing
+void BeatDetector::finishFrame()
+{
+    const float lowLevel = std::log1p(levelScale * lowEnergy / (float) hopSize);
+    const float highLevel = std::log1p(levelScale * highEnergy / (float) hopSize);
+
+    envelope.push_back(jmax(0.0f, lowLevel - lastLowLevel) + jmax(0.0f, highLevel - lastHighLevel));
+
+    lastLowLevel = lowLevel;
+    lastHighLevel = highLevel;
+    lowEnergy = highEnergy = 0.0f;
+    samplesInFrame = 0;
+}
+
+//==============================================================================
+float BeatDetector::interpolate(const std::vector<float>& values, double position)
+{
+    const int index = (int) position;
+
+    if (index < 0 || index + 1 >= (int) values.size())
+        return 0.0f;
+
+    const float fraction = (float) (position - index);
+    return values[(size_t) index] + fraction * (values[(size_t) index + 1] - values[(size_t) index]);
+}
+
+float BeatDetector::scoreGrid(const std::vector<float>& values, double period, double offset)
+{
+    float total = 0.0f;
+    int count = 0;
+
+    for (double position = offset; position + 1.0 < (double) values.size(); position += period)
+    {
+        total += interpolate(values, position);
+        ++count;
+    }
+
+    return count > 0 ? total / (float) count : 0.0f;
+}
+
+// Try every tempo and offset on a lattice and keep the best grid. An offset
+// range ending below its start means a whole beat period.
+void BeatDetector::fitGrid(const std::vector<float>& values, double lowBpm, double highBpm, double bpmStep,
+                           double lowOffset, double highOffset, double offsetStep, Grid& best) const
+{
+    const double frames = getFrameRate();
+
+    for (double bpm = lowBpm; bpm <= highBpm; bpm += bpmStep)
+    {
+        const double period = frames * 60.0 / bpm;
+        const double endOffset = highOffset < lowOffset ? lowOffset + period : highOffset;
+
+        for (double offset = lowOffset; offset < endOffset; offset += offsetStep)
+        {
+            const float score = scoreGrid(values, period, offset < 0.0 ? offset + period : offset);
+
+            if (score > best.score)
+            {
+                best.score = score;
+                best.period = period;
+                best.offset = offset;
+            }
+        }
+    }
+}
+
+// Coarse tempo from the autocorrelation, then the grid that best fits the
+// envelope over the whole track. Tempos are compared in frames per beat.
+bool BeatDetector::analyse(Result& result) const
+{
+    const double frames = getFrameRate();
+    const int numFrames = (int) envelope.size();
+
+    if (numFrames < (int) (minimumSeconds * frames))
+        return false;
+
+    // Take out the local mean, keeping only the peaks that stand above it
+    std::vector<float> peaks((size_t) numFrames);
+    {
+        double windowSum = 0.0;
+        int windowStart = 0;
+        int windowEnd = 0;
+
+        for (int i = 0; i < numFrames; ++i)
+        {
+            for (; windowEnd < jmin(numFrames, i + meanHalfWidth + 1); ++windowEnd)
+                windowSum += envelope[(size_t) windowEnd];
+            for (; windowStart < i - meanHalfWidth; ++windowStart)
+                windowSum -= envelope[(size_t) windowStart];
+
+            const float mean = (float) (windowSum / (windowEnd - windowStart));
+            peaks[(size_t) i] = jmax(0.0f, envelope[(size_t) i] - mean);
+        }
+    }
+
+    // Coarse pass: autocorrelation at one to coarseBeats beat periods
+    const int maxLag = jmin(numFrames - 1, (int) std::ceil(frames * 60.0 / minBpm * coarseBeats) + 2);
+    std::vector<float> autocorrelation((size_t) maxLag + 1);
+
+    for (int lag = 0; lag <= maxLag; ++lag)
+    {
+        double sum = 0.0;
+        for (int i = 0; i + lag < numFrames; ++i)
+            sum += peaks[(size_t) i] * peaks[(size_t) (i + lag)];
+
+        autocorrelation[(size_t) lag] = (float) (sum / (numFrames - lag));
+    }
+
+    double coarseBpm = 0.0;
+    float bestCoarse = 0.0f;
+
+    for (double bpm = minBpm; bpm < maxBpm; bpm += coarseStepBpm)
+    {
+        // A mild preference for tempos near 120 settles half/double-time ties
+        const double octavesFrom120 = std::log2(bpm / 120.0);
+        const float prior = (float) std::exp(-0.5 * octavesFrom120 * octavesFrom120);
+
+        const double period = frames * 60.0 / bpm;
+        float score = 0.0f;
+
+        for (int beat = 1; beat <= coarseBeats; ++beat)
+            score += interpolate(autocorrelation, period * beat);
+
+        score *= prior;
+
+        if (score > bestCoarse)
+        {
+            bestCoarse = score;
+            coarseBpm = bpm;
+        }
+    }
+
+    if (bestCoarse <= 0.0f)
+        return false;
+
+    // Fine pass: the grid period and offset that land most beats on onsets,
+    // then the same search on a finer scale around the best grid found
+    Grid grid;
+    fitGrid(peaks, coarseBpm - fineRangeBpm, coarseBpm + fineRangeBpm, fineStepBpm, 0.0, -1.0, fineOffsetStep, grid);
+
+    const double fineBpm = frames * 60.0 / grid.period;
+    fitGrid(peaks, fineBpm - fineStepBpm, fineBpm + fineStepBpm, polishStepBpm,
+            grid.offset - fineOffsetStep, grid.offset + fineOffsetStep, polishOffsetStep, grid);
+
+    if (grid.score <= 0.0f)
+        return false;
+
+    const double bestPeriod = grid.period;
+    const double bestOffset = std::fmod(grid.offset + bestPeriod, bestPeriod);
+    const float bestScore = grid.score;
+
+    // Confidence: how far the best grid stands above grids at other offsets
+    float offsetTotal = 0.0f;
+    int numOffsets = 0;
+
+    for (double offset = 0.0; offset < bestPeriod; offset += 1.0)
+    {
+        offsetTotal += scoreGrid(peaks, bestPeriod, offset);
+        ++numOffsets;
+    }
+
+    const float confidence = jlimit(0.0f, 1.0f, 1.0f - offsetTotal / (float) numOffsets / bestScore);
+
+    if (confidence < minimumConfidence)
+        return false;
+
+    result.bpm = frames * 60.0 / bestPeriod;
+    result.firstBeatSeconds = bestOffset / frames;
+    result.confidence = confidence;
+    return true;
+}
@@ -0,0 +1,123 @@
+/*
+==============================================================================
+BeatDetector.h
+Created: 22 Oct 2026 10:05:37am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <vector>
+
+//==============================================================================
+/*
+    BeatDetector estimates a track's tempo and beatgrid from its audio.
+
+    Mono audio is fed in any block size and reduced to an onset envelope at
+    100 frames per second: the rise in log energy of a low band (kicks) and
+    a high band (hats, snares) from one frame to the next. Once the whole
+    track has been fed, analyse() finds the tempo in two passes. A coarse
+    pass scores candidate beat periods by the envelope's autocorrelation at
+    several multiples of the period. A fine pass fits a beatgrid of evenly
+    spaced beats to the envelope over the whole track, refining the period
+    and finding where the first beat falls.
+
+    The grid assumes a constant tempo, which suits most dance music. The
+    envelope takes 4 bytes per frame, so even a long mix needs very little
+    memory.
+*/
+class BeatDetector
+{
+public:
+    /** The result of an analysis */
+    struct Result
+    {
+        double bpm = 0.0;
+
+        /** Time of the first beat of the grid, within the first beat period */
+        double firstBeatSeconds = 0.0;
+
+        /** How clearly the grid stands out, from 0 (no pulse found) to 1 */
+        float confidence = 0.0f;
+    };
+
+    /** Tempo range searched; everything outside it is folded in by halving or doubling */
+    static constexpr double minBpm = 70.0;
+    static constexpr double maxBpm = 180.0;
+
+    /**
+     * Constructor for BeatDetector.
+     * @param sampleRate The rate of the audio to be fed in.
+     */
+    BeatDetector(double sampleRate);
+
+    /** Clears the envelope, to start on another track at the same sample rate. */
+    void reset();
+
+    /**
+     * Feeds the next block of mono audio.
+     * @param samples The audio.
+     * @param numSamples The number of samples.
+     */
+    void process(const float* samples, int numSamples);
+
+    /**
+     * Estimates the tempo and grid from everything fed since the last reset.
+     * @param result Receives the tempo and grid.
+     * @return False if there was too little audio or no steady pulse in it.
+     */
+    bool analyse(Result& result) const;
+
+    /** Returns the onset envelope built so far, one value per frame. */
+    const std::vector<float>& getOnsetEnvelope() const;
+
+    /** Returns the number of envelope frames per second. */
+    double getFrameRate() const;
+
+    /** Returns the number of bytes the detector holds, which grows with the envelope. */
+    size_t getMemoryUsage() const;
+
+private:
+    /** Turns the energy of the frame just completed into an envelope value */
+    void finishFrame();
+
+    /** Returns the value at a fractional index, interpolating linearly; 0 outside the range */
+    static float interpolate(const std::vector<float>& values, double position);
+
+    /** A candidate beatgrid, in frames */
+    struct Grid
+    {
+        double period = 0.0;
+        double offset = 0.0;
+        float score = 0.0f;
+    };
+
+    /** Searches a range of tempos and offsets for the grid that best fits the values */
+    void fitGrid(const std::vector<float>& values, double lowBpm, double highBpm, double bpmStep,
+                 double lowOffset, double highOffset, double offsetStep, Grid& best) const;
+
+    /** Returns how well a grid with the given period and offset, in frames, lines up with the envelope */
+    static float scoreGrid(const std::vector<float>& envelope, double period, double offset);
+
+    const double sampleRate;
+    const int hopSize;
+
+    /** One-pole low-pass states splitting off the low band and the high band */
+    float lowState = 0.0f;
+    float highSplitState = 0.0f;
+    float lowCoefficient = 0.0f;
+    float highCoefficient = 0.0f;
+
+    /** Energy of the frame in progress, and the log energies of the last one */
+    float lowEnergy = 0.0f;
+    float highEnergy = 0.0f;
+    int samplesInFrame = 0;
+    float lastLowLevel = 0.0f;
+    float lastHighLevel = 0.0f;
+
+    std::vector<float> envelope;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BeatDetector)
+};
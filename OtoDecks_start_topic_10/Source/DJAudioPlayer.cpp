@@ -1,180 +1,910 @@
-/*
-==============================================================================
-DJAudioPlayer.cpp
-Created: 13 Mar 2020 4:22:22pm
-Author:  matthew
-==============================================================================
-*/
-
-#include "DJAudioPlayer.h"
-
-//==============================================================================
-// Constructor: Initializes the DJAudioPlayer with an AudioFormatManager reference
-DJAudioPlayer::DJAudioPlayer(AudioFormatManager& _formatManager) 
-: formatManager(_formatManager)
-{
-
-}
-
-DJAudioPlayer::~DJAudioPlayer()
-{
-
-}
-
-//==============================================================================
-// Prepares the player for audio playback by initializing the transport and resample sources
-void DJAudioPlayer::prepareToPlay (int samplesPerBlockExpected, double sampleRate) 
-{
-    transportSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    resampleSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-}
-
-//==============================================================================
-// Set the loop start point (PERSONAL CONTRIBUTION: Looping functionality)
-void DJAudioPlayer::setLoopStart(double start)
-{
-    loopStart = start;
-}
-
-// Set the loop end point (PERSONAL CONTRIBUTION: Looping functionality)
-void DJAudioPlayer::setLoopEnd(double end)
-{
-    loopEnd = end; 
-}
-
-// Enable or disable looping (PERSONAL CONTRIBUTION: Looping functionality)
-void DJAudioPlayer::enableLoop(bool shouldLoop)
-{
-    isLooping = shouldLoop; // Set the looping state
-}
-
-// Get the current looping state (PERSONAL CONTRIBUTION: Looping functionality)
-bool DJAudioPlayer::getIsLooping() const
-{
-    return isLooping;
-}
-
-//==============================================================================
-// Get the next block of audio data, implementing looping logic if enabled
-// (PERSONAL CONTRIBUTION: Overriding the default getNextAudioBlock to handle looping)
-void DJAudioPlayer::getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill)
-{
-    if (readerSource == nullptr)
-        return;
-
-    transportSource.getNextAudioBlock(bufferToFill);
-
-    // Handle looping logic
-    if (isLooping)
-    {
-        double currentPosition = transportSource.getCurrentPosition();
-        
-        // Ensure that loopEnd is greater than loopStart to avoid immediate jumps
-        if (currentPosition >= loopEnd && loopEnd > loopStart)
-        {
-            transportSource.setPosition(loopStart);  // Reset to loop start
-        }
-    }
-}
-
-//==============================================================================
-// Release resources held by the transport and resample sources
-void DJAudioPlayer::releaseResources()
-{
-    transportSource.releaseResources();
-    resampleSource.releaseResources();
-}
-
-//==============================================================================
-// Load an audio file from a URL and update the transport source
-void DJAudioPlayer::loadURL(URL audioURL)
-{
-    transportSource.stop();  // Stop any currently playing audio
-    transportSource.setSource(nullptr);  // Reset the source
-    auto* reader = formatManager.createReaderFor(audioURL.createInputStream(false));
-
-    if (reader != nullptr)
-    {
-        auto newSource = std::make_unique<AudioFormatReaderSource>(reader, true);
-        transportSource.setSource(newSource.get(), 0, nullptr, reader->sampleRate);
-        readerSource.reset(newSource.release());
-    }
-
-    // (PERSONAL CONTRIBUTION: Store the track title for display)
-    trackTitle = audioURL.getFileName();  // Set the track title based on the file name
-}
-
-//==============================================================================
-// Get the title of the currently loaded track (PERSONAL CONTRIBUTION)
-String DJAudioPlayer::getTrackTitle() const
-{
-    return trackTitle;  // Return the stored track title
-}
-
-//==============================================================================
-// Set the playback gain (volume)
-void DJAudioPlayer::setGain(double gain)
-{
-    if (gain < 0 || gain > 1.0)
-    {
-        std::cout << "DJAudioPlayer::setGain gain should be between 0 and 1" << std::endl;
-    }
-    else {
-        transportSource.setGain(gain);
-    }
-}
-
-//==============================================================================
-// Set the playback speed
-void DJAudioPlayer::setSpeed(double ratio)
-{
-  if (ratio < 0 || ratio > 100.0)
-    {
-        std::cout << "DJAudioPlayer::setSpeed ratio should be between 0 and 100" << std::endl;
-    }
-    else {
-        resampleSource.setResamplingRatio(ratio);
-    }
-}
-
-//==============================================================================
-// Set the playback position in seconds
-void DJAudioPlayer::setPosition(double posInSecs)
-{
-    transportSource.setPosition(posInSecs);
-}
-
-//==============================================================================
-// Set the playback position relative to the track's length (from 0 to 1)
-void DJAudioPlayer::setPositionRelative(double pos)
-{
-     if (pos < 0 || pos > 1.0)
-    {
-        std::cout << "DJAudioPlayer::setPositionRelative pos should be between 0 and 1" << std::endl;
-    }
-    else {
-        double posInSecs = transportSource.getLengthInSeconds() * pos;
-        setPosition(posInSecs);
-    }
-}
-
-//==============================================================================
-// Start audio playback
-void DJAudioPlayer::start()
-{
-    transportSource.start();
-}
-
-//==============================================================================
-// Stop audio playback
-void DJAudioPlayer::stop()
-{
-    transportSource.stop();
-}
-
-//==============================================================================
-// Get the current position of the playhead relative to the track's length (from 0 to 1)
-double DJAudioPlayer::getPositionRelative()
-{
-    return transportSource.getCurrentPosition() / transportSource.getLengthInSeconds();
-}
+/*
+==============================================================================
+DJAudioPlayer.cpp
+Created: 13 Mar 2020 4:22:22pm
+Author:  matthew
+==============================================================================
+*/
+
+#include "DJAudioPlayer.h"
+
+namespace
+{
+    /** How long a trim worked out after the track started takes to glide in */
+    constexpr double trimRampSeconds = 0.5;
+
+    /** Normalisation never pushes the true peak above this, and stays within these limits */
+    constexpr double trimPeakCeilingDb = -1.0;
+    constexpr double maxTrimCutDb = -24.0;
+    constexpr double maxTrimBoostDb = 12.0;
+}
+
+//==============================================================================
+// Constructor: Initializes the DJAudioPlayer with an AudioFormatManager reference
+DJAudioPlayer::DJAudioPlayer(AudioFormatManager& _formatManager) 
+: formatManager(_formatManager)
+{
+    loader = std::make_unique<TrackLoader>(formatManager, [this] { triggerAsyncUpdate(); });
+    analyser->addListener(this);
+    trimSmoother.setRampLength(trimRampSeconds);
+}
+
+// Destructor: stops the loader first, then frees every track still held.
+// The audio device has been shut down by now, so nothing is playing them.
+DJAudioPlayer::~DJAudioPlayer()
+{
+    loader.reset();
+    analyser->removeListener(this);
+    cancelPendingUpdate();
+    stopTimer();
+
+    loopSource.setSource(nullptr);
+    deleteRetiredTracks();
+    delete pendingTrack.exchange(nullptr);
+    delete activeTrack;
+}
+
+//==============================================================================
+// Prepares the player for audio playback by initializing the resampler, which in
+// turn prepares the loop and reader sources behind it
+void DJAudioPlayer::prepareToPlay (int samplesPerBlockExpected, double sampleRate) 
+{
+    outputSampleRate = sampleRate;
+    blockSize = samplesPerBlockExpected;
+    gainSmoother.prepare(sampleRate, samplesPerBlockExpected);
+    speedSmoother.prepare(sampleRate, samplesPerBlockExpected);
+    trimSmoother.prepare(sampleRate, samplesPerBlockExpected);
+    equaliser.prepare(sampleRate);
+    resampleSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
+}
+
+//==============================================================================
+// Set the loop start point (PERSONAL CONTRIBUTION: Looping functionality)
+void DJAudioPlayer::setLoopStart(double start)
+{
+    postCommand(DeckCommand::Type::setLoopStart, start);
+}
+
+// Set the loop end point (PERSONAL CONTRIBUTION: Looping functionality)
+void DJAudioPlayer::setLoopEnd(double end)
+{
+    postCommand(DeckCommand::Type::setLoopEnd, end);
+}
+
+// Mark the loop start at the playhead, in source samples so no rounding creeps in
+void DJAudioPlayer::markLoopStart()
+{
+    postCommand(DeckCommand::Type::markLoopStart);
+}
+
+// Mark the loop end at the playhead, in source samples so no rounding creeps in
+void DJAudioPlayer::markLoopEnd()
+{
+    postCommand(DeckCommand::Type::markLoopEnd);
+}
+
+// Enable or disable looping (PERSONAL CONTRIBUTION: Looping functionality)
+void DJAudioPlayer::enableLoop(bool shouldLoop)
+{
+    postCommand(DeckCommand::Type::enableLoop, shouldLoop ? 1.0 : 0.0); // Set the looping state
+}
+
+// Get the current looping state (PERSONAL CONTRIBUTION: Looping functionality)
+bool DJAudioPlayer::getIsLooping() const
+{
+    return loopSource.isLoopEnabled();
+}
+
+//==============================================================================
+// Get the next block of audio data. The chain is reader -> loop -> resampler:
+// the loop source splits the block at the loop end and wraps within this same
+// callback, and the resampler applies the speed and sample-rate conversion.
+// A newly loaded track is swapped in here, between blocks, without locking.
+// Queued control changes are applied at their sample time, splitting the block.
+// (PERSONAL CONTRIBUTION: Overriding the default getNextAudioBlock to handle looping)
+void DJAudioPlayer::getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill)
+{
+    if (auto* track = pendingTrack.exchange(nullptr))
+        installTrack(track);
+
+    const int64 blockStart = sampleClock;
+    const int64 blockEnd = blockStart + bufferToFill.numSamples;
+    const double startMs = Time::getMillisecondCounterHiRes();
+    const double samplesPerMs = outputSampleRate.load() / 1000.0;
+
+    blockStartClock = blockStart;
+    blockStartMs = startMs;
+
+    int offset = 0;
+    DeckCommand command;
+
+    while (commandQueue.popDue(blockEnd, command))
+    {
+        const int commandOffset = (int) jlimit((int64) offset, (int64) bufferToFill.numSamples, command.sampleTime - blockStart);
+
+        renderSegment(bufferToFill, offset, commandOffset - offset);
+        offset = commandOffset;
+        applyCommand(command);
+
+        if (samplesPerMs > 0.0)
+            lastCommandLatencyMs = startMs + offset / samplesPerMs - command.postedAtMs;
+    }
+
+    renderSegment(bufferToFill, offset, bufferToFill.numSamples - offset);
+    sampleClock = blockEnd;
+}
+
+//==============================================================================
+// Render part of the block through the chain with the current settings
+void DJAudioPlayer::renderSegment(const AudioSourceChannelInfo& bufferToFill, int offset, int numSamples)
+{
+    if (numSamples <= 0)
+        return;
+
+    const AudioSourceChannelInfo segment(bufferToFill.buffer, bufferToFill.startSample + offset, numSamples);
+    const double deviceRate = outputSampleRate.load();
+
+    if (activeTrack == nullptr || ! playing.load() || deviceRate <= 0.0)
+    {
+        segment.clearActiveBufferRegion();
+        return;
+    }
+
+    // Keep the loop start buffered so wrapping back never waits for the disk
+    if (activeTrack->readAhead != nullptr)
+        activeTrack->readAhead->setPinnedPosition(loopSource.isLooping() ? loopSource.getLoopStart() : -1);
+
+    // While the speed glides, step the resampler ratio every few samples; once it
+    // has settled the whole segment is rendered in one pass
+    const double rateConversion = activeTrack->sampleRate / deviceRate;
+    const double speedFloor = keyLockOn ? minKeyLockSpeed : 0.0;
+    const double speedLimit = getSpeedLimit();
+    int numDone = 0;
+
+    while (numDone < numSamples)
+    {
+        const int numThisTime = speedSmoother.isSmoothing() ? jmin(speedStepSize, numSamples - numDone)
+                                                            : numSamples - numDone;
+        const double speedNow = jlimit(speedFloor, speedLimit, (double) speedSmoother.getCurrentValue());
+        speedSmoother.skip(numThisTime);
+
+        const AudioSourceChannelInfo part(segment.buffer, segment.startSample + numDone, numThisTime);
+        numDone += numThisTime;
+
+        if (speedNow <= 0.0)
+        {
+            part.clearActiveBufferRegion();  // A stopped platter makes no sound
+            continue;
+        }
+
+        // With key lock the stretcher changes the tempo and the resampler only converts
+        // the sample rate; without it the resampler does both and the pitch follows
+        stretchSource.setTempo(speedNow);
+        resampleSource.setResamplingRatio(keyLockOn ? rateConversion : speedNow * rateConversion);
+        resampleSource.getNextAudioBlock(part);
+    }
+
+    // A track played from the decoded cache is always fully buffered
+    if (activeTrack->readAhead != nullptr && ! activeTrack->isInMemory())
+    {
+        readAheadFill = activeTrack->readAhead->getFillLevel();
+        numUnderruns = underrunsBeforeTrack + activeTrack->readAhead->getNumUnderruns();
+    }
+    else {
+        readAheadFill = 1.0f;
+    }
+
+    // EQ and filter, then the loudness trim and the per-sample gain glide applied with vector multiplies
+    equaliser.process(*segment.buffer, segment.startSample, segment.numSamples);
+    trimSmoother.applyGain(*segment.buffer, segment.startSample, segment.numSamples);
+    gainSmoother.applyGain(*segment.buffer, segment.startSample, segment.numSamples);
+
+    // Publish what is being heard: the read position minus what the stretcher and resampler hold
+    const double stretcherInputPerOutput = keyLockOn ? stretchSource.getTempo() : 1.0;
+    const double lookahead = stretchSource.getInputLookahead()
+                           + resampleSource.getInputLookahead() * stretcherInputPerOutput;
+    const int64 position = loopSource.getNextReadPosition() - (int64) lookahead;
+    playheadSample = jmax((int64) 0, position);
+    playbackSpeed = jlimit(speedFloor, speedLimit, (double) speedSmoother.getCurrentValue());
+
+    if (! loopSource.isLooping() && position >= totalLengthSamples.load())
+        playing = false;  // Reached the end of the track
+}
+
+//==============================================================================
+// Apply one control change from the message thread
+void DJAudioPlayer::applyCommand(const DeckCommand& command)
+{
+    const double rate = sourceSampleRate.load();
+
+    switch (command.type)
+    {
+        case DeckCommand::Type::start:
+            playing = activeTrack != nullptr;
+            break;
+        case DeckCommand::Type::stop:
+            playing = false;
+            break;
+        case DeckCommand::Type::setGain:
+            gainSmoother.setTargetValue((float) command.value);
+            break;
+        case DeckCommand::Type::setSpeed:
+            ownSpeed = (float) jlimit(0.0, maxSpeed, command.value);  // Scripts post straight here
+            if (! syncSpeedOn)
+                speedSmoother.setTargetValue(ownSpeed);
+            break;
+        case DeckCommand::Type::setPosition:
+            seekTo((int64) (command.value * rate));
+            break;
+        case DeckCommand::Type::setPositionRelative:
+            seekTo((int64) (command.value * (double) totalLengthSamples.load()));
+            break;
+        case DeckCommand::Type::setLoopStart:
+            loopSource.setLoopStart((int64) (command.value * rate));
+            break;
+        case DeckCommand::Type::setLoopEnd:
+            loopSource.setLoopEnd((int64) (command.value * rate));
+            break;
+        case DeckCommand::Type::markLoopStart:
+            loopSource.setLoopStart(playheadSample.load());
+            break;
+        case DeckCommand::Type::markLoopEnd:
+            loopSource.setLoopEnd(playheadSample.load());
+            break;
+        case DeckCommand::Type::enableLoop:
+            loopSource.setLoopEnabled(command.value != 0.0);
+            break;
+        case DeckCommand::Type::setRampLength:
+            gainSmoother.setRampLength(command.value);
+            speedSmoother.setRampLength(command.value);
+            break;
+        case DeckCommand::Type::setRampCurve:
+            gainSmoother.setCurve((SmoothedParameter::Curve) (int) command.value);
+            speedSmoother.setCurve((SmoothedParameter::Curve) (int) command.value);
+            break;
+        case DeckCommand::Type::setEqLow:
+            equaliser.setBandGain(DeckEqualiser::Band::low, (float) command.value);
+            break;
+        case DeckCommand::Type::setEqMid:
+            equaliser.setBandGain(DeckEqualiser::Band::mid, (float) command.value);
+            break;
+        case DeckCommand::Type::setEqHigh:
+            equaliser.setBandGain(DeckEqualiser::Band::high, (float) command.value);
+            break;
+        case DeckCommand::Type::killEqLow:
+            equaliser.setBandKill(DeckEqualiser::Band::low, command.value != 0.0);
+            break;
+        case DeckCommand::Type::killEqMid:
+            equaliser.setBandKill(DeckEqualiser::Band::mid, command.value != 0.0);
+            break;
+        case DeckCommand::Type::killEqHigh:
+            equaliser.setBandKill(DeckEqualiser::Band::high, command.value != 0.0);
+            break;
+        case DeckCommand::Type::setFilter:
+            equaliser.setFilter((float) command.value);
+            break;
+        case DeckCommand::Type::setTrim:
+            trimSmoother.setTargetValue((float) command.value);
+            break;
+        case DeckCommand::Type::autoCue:
+            // Only a track that is still parked where it was loaded is moved
+            if (! playing.load() && playheadSample.load() == 0)
+                seekTo((int64) command.value);
+            break;
+        case DeckCommand::Type::setKeyLock:
+            // Switching key lock changes what the stretcher and resampler hold, so
+            // restart them from the playhead rather than play stale audio
+            if (keyLockOn != (command.value != 0.0))
+            {
+                keyLockOn = command.value != 0.0;
+                stretchSource.setEnabled(keyLockOn);
+                seekTo(playheadSample.load());
+            }
+            break;
+    }
+}
+
+void DJAudioPlayer::seekTo(int64 position)
+{
+    if (activeTrack == nullptr)
+        return;
+
+    position = jmax((int64) 0, position);
+    loopSource.setNextReadPosition(position);
+    stretchSource.flushBuffers();
+    resampleSource.flushBuffers();
+    playheadSample = position;
+}
+
+//==============================================================================
+// Swap a loaded track in behind the loop source and hand the old one back to
+// the message thread for deletion. Runs at the start of a block on the audio thread.
+void DJAudioPlayer::installTrack(LoadedTrack* track)
+{
+    if (activeTrack != nullptr)
+    {
+        const auto scope = retiredFifo.write(1);
+        jassert(scope.blockSize1 == 1);  // The message thread drains this before every publish
+
+        if (scope.blockSize1 > 0)
+            retiredTracks[(size_t) scope.startIndex1] = activeTrack;
+    }
+
+    activeTrack = track;
+
+    loopSource.setSource(track->getSource());  // Drop the old loop along with the old track
+    loopSource.setNextReadPosition(track->startPosition);
+    stretchSource.flushBuffers();
+    resampleSource.flushBuffers();
+
+    sourceSampleRate = track->sampleRate;
+    totalLengthSamples = track->lengthInSamples;
+    playheadSample = track->startPosition;
+    trimSmoother.setCurrentAndTargetValue(track->trimGain);
+    trackBpm = 0.0;  // The old grid no longer applies; the message thread publishes the new one
+    playing = startOnInstall.load();
+    underrunsBeforeTrack = numUnderruns.load();
+
+    installTimeMs = Time::getMillisecondCounterHiRes();
+}
+
+//==============================================================================
+// Release resources held by the resampler and the sources behind it
+void DJAudioPlayer::releaseResources()
+{
+    resampleSource.releaseResources();
+}
+
+//==============================================================================
+// Request a background load. The loader opens, probes and primes the file and
+// the audio thread swaps it in, so neither thread waits on the disk here.
+void DJAudioPlayer::loadURL(URL audioURL, bool startWhenLoaded)
+{
+    startOnInstall = startWhenLoaded;
+    loading = true;
+    loader->load(audioURL);
+
+    // Analyse the tempo alongside the load, ahead of anything else waiting
+    if (audioURL.isLocalFile())
+        analyser->analyse(audioURL.getLocalFile(), true);
+}
+
+void DJAudioPlayer::cancelLoad()
+{
+    loader->cancel();
+}
+
+bool DJAudioPlayer::isLoading() const
+{
+    return loading;
+}
+
+double DJAudioPlayer::getLastLoadLatencyMs() const
+{
+    return lastLoadLatencyMs;
+}
+
+void DJAudioPlayer::setReadAheadSeconds(double seconds)
+{
+    if (seconds < 2.0 || seconds > 10.0)
+    {
+        std::cout << "DJAudioPlayer::setReadAheadSeconds seconds should be between 2 and 10" << std::endl;
+    }
+    else {
+        loader->setReadAheadSeconds(seconds);
+    }
+}
+
+void DJAudioPlayer::setSeekIndexStorage(Mp3SeekIndex::Storage storage)
+{
+    loader->setSeekIndexStorage(storage);
+}
+
+float DJAudioPlayer::getReadAheadFillLevel() const
+{
+    return readAheadFill.load();
+}
+
+int DJAudioPlayer::getNumReadAheadUnderruns() const
+{
+    return numUnderruns.load();
+}
+
+void DJAudioPlayer::addListener(Listener* listener)
+{
+    listeners.add(listener);
+}
+
+void DJAudioPlayer::removeListener(Listener* listener)
+{
+    listeners.remove(listener);
+}
+
+//==============================================================================
+// Loader state changed: report cancellations and progress, and hand a finished
+// track to the audio thread. Updates may be coalesced, so counters and the
+// finished track are checked rather than relying on seeing every state.
+void DJAudioPlayer::handleAsyncUpdate()
+{
+    const int numCancelled = loader->getNumCancelled();
+    if (numCancelled != numCancelledSeen)
+    {
+        numCancelledSeen = numCancelled;
+        listeners.call([this](Listener& l) { l.loadCancelled(this); });
+    }
+
+    if (auto track = loader->takeLoadedTrack())
+    {
+        deleteRetiredTracks();
+
+        // A track whose loudness is already known plays at its trim from the first sample
+        publishedTrimDb = getNormalisationDb(track->analysis);
+        track->trimGain = Decibels::decibelsToGain((float) publishedTrimDb);
+
+        publishedTitle = track->title;
+        publishedFile = track->file;
+        publishedAnalysis = track->analysis;
+        publishedRequestTimeMs = track->requestTimeMs;
+        publishedOpenMs = track->openDurationMs;
+        publishedPrimeMs = track->primeDurationMs;
+        installTimeMs = 0.0;
+
+        const double deviceRate = outputSampleRate.load();
+        if (deviceRate > 0.0 && maxSpeed * track->sampleRate / deviceRate > SincResamplingSource::maxRatio)
+            std::cout << "DJAudioPlayer::loadURL " << track->title << " at " << track->sampleRate << " Hz plays at up to "
+                      << SincResamplingSource::maxRatio * deviceRate / track->sampleRate << "x speed without key lock" << std::endl;
+
+        // A track the audio thread never picked up can be deleted straight away
+        delete pendingTrack.exchange(track.release());
+        startTimer(10);
+        return;
+    }
+
+    switch (loader->getState())
+    {
+        case TrackLoader::State::loading:
+        {
+            const double progress = loader->getProgress();
+            listeners.call([this, progress](Listener& l) { l.loadProgressChanged(this, progress); });
+            break;
+        }
+        case TrackLoader::State::failed:
+            loading = false;
+            std::cout << "DJAudioPlayer::loadURL could not open the file" << std::endl;
+            listeners.call([this](Listener& l) { l.loadFinished(this, false); });
+            break;
+        case TrackLoader::State::idle:
+            if (! isTimerRunning())
+                loading = false;  // Cancelled with nothing else waiting
+            break;
+        case TrackLoader::State::finished:
+            break;
+    }
+}
+
+//==============================================================================
+// Poll until the audio thread has swapped the published track in, then report
+// the load-to-playable latency
+void DJAudioPlayer::timerCallback()
+{
+    const double installedAt = installTimeMs.load();
+
+    if (pendingTrack.load() != nullptr || installedAt <= 0.0)
+        return;
+
+    stopTimer();
+    deleteRetiredTracks();
+
+    lastLoadLatencyMs = installedAt - publishedRequestTimeMs;
+    std::cout << "DJAudioPlayer::loadURL " << publishedTitle << " playable after " << lastLoadLatencyMs
+              << " ms (open " << publishedOpenMs << " ms, prime " << publishedPrimeMs << " ms)" << std::endl;
+
+    // (PERSONAL CONTRIBUTION: Store the track title for display)
+    trackTitle = publishedTitle;
+    trackFile = publishedFile;
+    autoGainDb = publishedTrimDb;
+
+    // This session's analysis if it has finished, otherwise whatever the loader found in the cache
+    TrackAnalysis analysis = publishedAnalysis;
+    analyser->getAnalysis(trackFile, analysis);
+    setTrackAnalysis(analysis);
+
+    if (loader->getState() != TrackLoader::State::loading)
+        loading = false;
+
+    listeners.call([this](Listener& l) { l.loadFinished(this, true); });
+}
+
+//==============================================================================
+// Free the tracks the audio thread has replaced
+void DJAudioPlayer::deleteRetiredTracks()
+{
+    const int numReady = retiredFifo.getNumReady();
+    const auto scope = retiredFifo.read(numReady);
+
+    for (int i = 0; i < scope.blockSize1; ++i)
+        delete retiredTracks[(size_t) (scope.startIndex1 + i)];
+
+    for (int i = 0; i < scope.blockSize2; ++i)
+        delete retiredTracks[(size_t) (scope.startIndex2 + i)];
+}
+
+//==============================================================================
+// Get the title of the currently loaded track (PERSONAL CONTRIBUTION)
+String DJAudioPlayer::getTrackTitle() const
+{
+    return trackTitle;  // Return the stored track title
+}
+
+//==============================================================================
+// Tempo of the loaded track, from the background analysis
+double DJAudioPlayer::getTrackBpm() const
+{
+    return trackBpm.load();
+}
+
+double DJAudioPlayer::getFirstBeatSeconds() const
+{
+    return firstBeatSeconds.load();
+}
+
+//==============================================================================
+// Beats since the first beat, from the playhead published at the end of the last block
+bool DJAudioPlayer::getBeatInfo(BeatInfo& info) const
+{
+    const double bpm = trackBpm.load();
+    const double rate = sourceSampleRate.load();
+
+    if (activeTrack == nullptr || bpm <= 0.0 || rate <= 0.0)
+        return false;
+
+    info.beat = ((double) playheadSample.load() / rate - firstBeatSeconds.load()) * bpm / 60.0;
+    info.bpm = bpm;
+    info.speed = jlimit(keyLockOn ? minKeyLockSpeed : 0.0, getSpeedLimit(), (double) speedSmoother.getCurrentValue());
+    info.playing = playing.load();
+    return true;
+}
+
+// Without key lock the resampler applies the speed and the sample-rate
+// conversion together, and their product has to stay within its range
+double DJAudioPlayer::getSpeedLimit() const
+{
+    const double deviceRate = outputSampleRate.load();
+
+    if (activeTrack == nullptr || keyLockOn || deviceRate <= 0.0)
+        return maxSpeed;
+
+    return jmin(maxSpeed, SincResamplingSource::maxRatio * deviceRate / activeTrack->sampleRate);
+}
+
+void DJAudioPlayer::setSyncSpeed(double speed)
+{
+    syncSpeedOn = true;
+    speedSmoother.setTargetValue((float) jlimit(0.0, maxSpeed, speed));
+}
+
+void DJAudioPlayer::releaseSyncSpeed()
+{
+    syncSpeedOn = false;
+    speedSmoother.setTargetValue(ownSpeed);
+}
+
+//==============================================================================
+// Scripted loads are opened up front, so the audio thread only has to swap them in
+std::unique_ptr<LoadedTrack> DJAudioPlayer::loadTrackNow(const URL& audioURL)
+{
+    auto track = loader->loadWithSettings(audioURL);
+
+    if (track != nullptr)
+        track->trimGain = Decibels::decibelsToGain((float) getNormalisationDb(track->analysis));
+
+    return track;
+}
+
+std::unique_ptr<LoadedTrack> DJAudioPlayer::swapTrackNow(std::unique_ptr<LoadedTrack> track)
+{
+    // The old track goes back to the caller rather than through the retired queue
+    std::unique_ptr<LoadedTrack> previous(activeTrack);
+    activeTrack = nullptr;
+
+    installTrack(track.release());
+    playing = false;
+
+    const auto& analysis = activeTrack->analysis;
+    trackBpm = analysis.hasTempo() ? analysis.bpm : 0.0;
+    firstBeatSeconds = analysis.hasTempo() ? analysis.firstBeatSeconds : 0.0;
+
+    return previous;
+}
+
+void DJAudioPlayer::applyCommandNow(DeckCommand::Type type, double value)
+{
+    DeckCommand command;
+    command.type = type;
+    command.value = value;
+    command.sampleTime = sampleClock;
+    applyCommand(command);
+}
+
+// The settings a new deck starts with, so a script loads its tracks the same
+// way whichever deck it plays them on
+void DJAudioPlayer::restoreDefaultSettings()
+{
+    autoGainOn = true;
+    autoGainTargetLufs = defaultAutoGainTargetLufs;
+    updateTrim();
+    setAutoCue(true);
+    setResamplingQuality(SincResamplingSource::Quality::medium);
+    keyLockRequested = false;
+}
+
+// A new deck's playback state. Changes still queued from the controls are
+// dropped, or they would land part way through whatever comes next.
+void DJAudioPlayer::resetNow()
+{
+    DeckCommand command;
+    while (commandQueue.popDue(std::numeric_limits<int64>::max(), command))
+        continue;
+
+    playing = false;
+
+    for (auto* smoother : { &gainSmoother, &speedSmoother })
+    {
+        smoother->setCurve(SmoothedParameter::Curve::linear);
+        smoother->setRampLength(SmoothedParameter::defaultRampSeconds);
+        smoother->setCurrentAndTargetValue(1.0f);
+    }
+
+    ownSpeed = 1.0f;
+    syncSpeedOn = false;
+    playbackSpeed = 1.0;
+
+    keyLockOn = false;
+    stretchSource.setEnabled(false);
+    loopSource.setLoopEnabled(false);
+    loopSource.setLoopPoints(0, 0);
+    equaliser.resetControls();
+    seekTo(playheadSample.load());  // Clears what the stretcher and resampler hold
+}
+
+void DJAudioPlayer::trackAnalysed(const File& file, const TrackAnalysis& analysis)
+{
+    if (file == trackFile && trackFile != File())
+        setTrackAnalysis(analysis);
+}
+
+void DJAudioPlayer::setTrackAnalysis(const TrackAnalysis& analysis)
+{
+    trackAnalysis = analysis;
+    trackBpm = analysis.hasTempo() ? analysis.bpm : 0.0;
+    firstBeatSeconds = analysis.hasTempo() ? analysis.firstBeatSeconds : 0.0;
+
+    updateTrim();
+
+    if (autoCueOn && analysis.hasLoudness() && analysis.firstAudibleSample > 0)
+        postCommand(DeckCommand::Type::autoCue, (double) analysis.firstAudibleSample);
+}
+
+// A trim that changes while the track plays glides in rather than jumping
+void DJAudioPlayer::updateTrim()
+{
+    const double trimDb = getNormalisationDb(trackAnalysis);
+
+    if (trimDb != autoGainDb)
+    {
+        autoGainDb = trimDb;
+        postCommand(DeckCommand::Type::setTrim, Decibels::decibelsToGain(trimDb));
+    }
+}
+
+// Meet the target loudness unless that would push the true peak past the ceiling
+double DJAudioPlayer::getNormalisationDb(const TrackAnalysis& analysis) const
+{
+    if (! autoGainOn || ! analysis.hasLoudness())
+        return 0.0;
+
+    const double trimDb = jmin(autoGainTargetLufs - analysis.integratedLufs, trimPeakCeilingDb - analysis.truePeakDb);
+    return jlimit(maxTrimCutDb, maxTrimBoostDb, trimDb);
+}
+
+//==============================================================================
+// Set the playback gain (volume)
+void DJAudioPlayer::setGain(double gain)
+{
+    if (gain < 0 || gain > 1.0)
+    {
+        std::cout << "DJAudioPlayer::setGain gain should be between 0 and 1" << std::endl;
+    }
+    else {
+        postCommand(DeckCommand::Type::setGain, gain);
+    }
+}
+
+//==============================================================================
+// Set the playback speed
+void DJAudioPlayer::setSpeed(double ratio)
+{
+  if (ratio < 0 || ratio > maxSpeed)
+    {
+        std::cout << "DJAudioPlayer::setSpeed ratio should be between 0 and " << maxSpeed << std::endl;
+    }
+    else {
+        postCommand(DeckCommand::Type::setSpeed, ratio);
+    }
+}
+
+double DJAudioPlayer::getSpeed() const
+{
+    return playbackSpeed.load();
+}
+
+//==============================================================================
+// Loudness normalisation, applied as a trim before the gain
+void DJAudioPlayer::setAutoGain(bool shouldNormalise)
+{
+    autoGainOn = shouldNormalise;
+    updateTrim();
+}
+
+void DJAudioPlayer::setAutoGainTarget(double lufs)
+{
+    if (lufs < -30.0 || lufs > -5.0)
+    {
+        std::cout << "DJAudioPlayer::setAutoGainTarget lufs should be between -30 and -5" << std::endl;
+    }
+    else {
+        autoGainTargetLufs = lufs;
+        updateTrim();
+    }
+}
+
+double DJAudioPlayer::getAutoGainDb() const
+{
+    return autoGainDb;
+}
+
+void DJAudioPlayer::setAutoCue(bool shouldAutoCue)
+{
+    autoCueOn = shouldAutoCue;
+    loader->setAutoCue(shouldAutoCue);
+}
+
+//==============================================================================
+// Set how long gain and speed changes take to glide to their new value
+void DJAudioPlayer::setRampLength(double seconds)
+{
+    if (seconds < 0 || seconds > 1.0)
+    {
+        std::cout << "DJAudioPlayer::setRampLength seconds should be between 0 and 1" << std::endl;
+    }
+    else {
+        postCommand(DeckCommand::Type::setRampLength, seconds);
+    }
+}
+
+// Select the shape of the gain and speed glides
+void DJAudioPlayer::setRampCurve(SmoothedParameter::Curve curve)
+{
+    postCommand(DeckCommand::Type::setRampCurve, (double) (int) curve);
+}
+
+//==============================================================================
+// Select the resampler quality, picked up by the audio thread on the next block
+void DJAudioPlayer::setResamplingQuality(SincResamplingSource::Quality quality)
+{
+    resampleSource.setQuality(quality);
+}
+
+//==============================================================================
+// Enable or disable key lock
+void DJAudioPlayer::setKeyLock(bool shouldLockKey)
+{
+    keyLockRequested = shouldLockKey;
+    postCommand(DeckCommand::Type::setKeyLock, shouldLockKey ? 1.0 : 0.0);
+}
+
+bool DJAudioPlayer::getKeyLock() const
+{
+    return keyLockRequested;
+}
+
+//==============================================================================
+// Set the level of one EQ band
+void DJAudioPlayer::setEqGain(DeckEqualiser::Band band, double decibels)
+{
+    if (decibels < -24.0 || decibels > 6.0)
+    {
+        std::cout << "DJAudioPlayer::setEqGain decibels should be between -24 and 6" << std::endl;
+    }
+    else {
+        postCommand(band == DeckEqualiser::Band::low ? DeckCommand::Type::setEqLow
+                  : band == DeckEqualiser::Band::mid ? DeckCommand::Type::setEqMid
+                                                     : DeckCommand::Type::setEqHigh, decibels);
+    }
+}
+
+// Kill or restore one EQ band
+void DJAudioPlayer::setEqKill(DeckEqualiser::Band band, bool shouldKill)
+{
+    postCommand(band == DeckEqualiser::Band::low ? DeckCommand::Type::killEqLow
+              : band == DeckEqualiser::Band::mid ? DeckCommand::Type::killEqMid
+                                                 : DeckCommand::Type::killEqHigh, shouldKill ? 1.0 : 0.0);
+}
+
+// Move the filter knob
+void DJAudioPlayer::setFilter(double position)
+{
+    if (position < -1.0 || position > 1.0)
+    {
+        std::cout << "DJAudioPlayer::setFilter position should be between -1 and 1" << std::endl;
+    }
+    else {
+        postCommand(DeckCommand::Type::setFilter, position);
+    }
+}
+
+//==============================================================================
+// Set the playback position in seconds
+void DJAudioPlayer::setPosition(double posInSecs)
+{
+    postCommand(DeckCommand::Type::setPosition, posInSecs);
+}
+
+//==============================================================================
+// Set the playback position relative to the track's length (from 0 to 1)
+void DJAudioPlayer::setPositionRelative(double pos)
+{
+     if (pos < 0 || pos > 1.0)
+    {
+        std::cout << "DJAudioPlayer::setPositionRelative pos should be between 0 and 1" << std::endl;
+    }
+    else {
+        postCommand(DeckCommand::Type::setPositionRelative, pos);
+    }
+}
+
+//==============================================================================
+// Start audio playback
+void DJAudioPlayer::start()
+{
+    postCommand(DeckCommand::Type::start);
+}
+
+//==============================================================================
+// Stop audio playback
+void DJAudioPlayer::stop()
+{
+    postCommand(DeckCommand::Type::stop);
+}
+
+//==============================================================================
+// Queue a control change for the audio thread. It is timed one block after the
+// sample clock's current position, estimated from when the last block started,
+// so every change lands at the same delay after it was made.
+void DJAudioPlayer::postCommand(DeckCommand::Type type, double value)
+{
+    DeckCommand command;
+    command.type = type;
+    command.value = value;
+    command.postedAtMs = Time::getMillisecondCounterHiRes();
+
+    const int block = blockSize.load();
+    const double elapsedSamples = (command.postedAtMs - blockStartMs.load()) * outputSampleRate.load() / 1000.0;
+    command.sampleTime = blockStartClock.load() + jlimit((int64) 0, (int64) block, (int64) elapsedSamples) + block;
+
+    if (! commandQueue.push(command))
+        std::cout << "DJAudioPlayer::postCommand queue is full, command dropped" << std::endl;
+}
+
+double DJAudioPlayer::getLastCommandLatencyMs() const
+{
+    return lastCommandLatencyMs.load();
+}
+
+//==============================================================================
+// Get the current position of the playhead relative to the track's length (from 0 to 1)
+double DJAudioPlayer::getPositionRelative()
+{
+    const int64 length = totalLengthSamples.load();
+    return length > 0 ? (double) playheadSample.load() / (double) length : 0.0;
+}
@@ -1,147 +1,557 @@
-/*
-==============================================================================
-DJAudioPlayer.h
-Created: 13 Mar 2020 4:22:22pm
-Author:  matthew
-==============================================================================
-*/
-
-#pragma once
-
-#include "../JuceLibraryCode/JuceHeader.h"
-
-//==============================================================================
-// DJAudioPlayer class manages audio playback, including gain, speed, position, 
-// and looping functionality. It uses JUCE's AudioSource for managing audio streams.
-// (PERSONAL CONTRIBUTION: Looping functionality, track title management)
-class DJAudioPlayer : public AudioSource 
-{
-public:
-    /**
-     * Constructor for DJAudioPlayer.
-     * @param _formatManager Reference to AudioFormatManager for handling audio formats.
-     */
-    DJAudioPlayer(AudioFormatManager& _formatManager);
-
-    /** Destructor */
-    ~DJAudioPlayer() override;
-
-    /**
-     * Prepares the audio player to play, initializing resources based on the given 
-     * sample rate and block size.
-     * @param samplesPerBlockExpected Number of samples per block expected.
-     * @param sampleRate The audio sample rate.
-     */
-    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
-
-    /**
-     * Fills the next block of audio data, overriding JUCE's AudioSource method.
-     * Implements looping if enabled.
-     * (PERSONAL CONTRIBUTION: Overriding method for handling looping)
-     * @param bufferToFill The audio buffer to fill with audio data.
-     */
-    void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
-
-    /** Releases audio resources when no longer needed. */
-    void releaseResources() override;
-
-    //==============================================================================
-    // Looping functionality (PERSONAL CONTRIBUTION)
-    
-    /**
-     * Sets the start point for the loop.
-     * @param start The start position of the loop in seconds.
-     */
-    void setLoopStart(double start);
-
-    /**
-     * Sets the end point for the loop.
-     * @param end The end position of the loop in seconds.
-     */
-    void setLoopEnd(double end);
-
-    /**
-     * Enables or disables the loop.
-     * @param shouldLoop True if looping should be enabled, false otherwise.
-     */
-    void enableLoop(bool shouldLoop);
-
-    /**
-     * Checks if looping is currently enabled.
-     * @return True if looping is enabled, false otherwise.
-     */
-    bool getIsLooping() const;
-
-    //==============================================================================
-    
-    /**
-     * Loads an audio file from a URL and prepares it for playback.
-     * @param audioURL The URL of the audio file to load.
-     */
-    void loadURL(URL audioURL);
-
-    /**
-     * Sets the playback gain (volume).
-     * @param gain The gain value between 0.0 (mute) and 1.0 (full volume).
-     */
-    void setGain(double gain);
-
-    /**
-     * Sets the playback speed.
-     * @param ratio The speed ratio where 1.0 is normal speed, values greater than 1 speed up playback.
-     */
-    void setSpeed(double ratio);
-
-    /**
-     * Sets the playback position in seconds.
-     * @param posInSecs The playback position in seconds.
-     */
-    void setPosition(double posInSecs);
-
-    /**
-     * Sets the playback position relative to the track's length.
-     * @param pos A value between 0.0 and 1.0 representing the relative position.
-     */
-    void setPositionRelative(double pos);
-
-    /** Starts audio playback. */
-    void start();
-
-    /** Stops audio playback. */
-    void stop();
-
-    /**
-     * Gets the relative position of the playhead in the track.
-     * @return A value between 0.0 and 1.0 representing the relative position of the playhead.
-     */
-    double getPositionRelative();
-
-    /**
-     * Gets the title of the currently loaded track.
-     * (PERSONAL CONTRIBUTION: Track title handling)
-     * @return A string containing the track title.
-     */
-    String getTrackTitle() const;
-
-private:
-    /** Reference to the AudioFormatManager used to handle audio formats */
-    AudioFormatManager& formatManager;
-
-    /** Unique pointer to an AudioFormatReaderSource for managing audio reading */
-    std::unique_ptr<AudioFormatReaderSource> readerSource;
-
-    /** AudioTransportSource for managing playback control (play, stop, seek) */
-    AudioTransportSource transportSource;
-
-    /** ResamplingAudioSource for adjusting playback speed */
-    ResamplingAudioSource resampleSource{&transportSource, false, 2};
-
-    // Looping-related variables (PERSONAL CONTRIBUTION)
-    double loopStart = 0.0;  // The start point of the loop in seconds
-    double loopEnd = 0.0;    // The end point of the loop in seconds
-    bool isLooping = false;  // Boolean flag indicating whether looping is enabled
-
-    /** The title of the currently loaded track (PERSONAL CONTRIBUTION) */
-    String trackTitle;
-};
-
+/*
+==============================================================================
+DJAudioPlayer.h
+Created: 13 Mar 2020 4:22:22pm
+Author:  matthew
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "LoopingAudioSource.h"
+#include "SincResamplingSource.h"
+#include "TimeStretcher.h"
+#include "TrackLoader.h"
+#include "DeckCommandQueue.h"
+#include "SmoothedParameter.h"
+#include "DeckEqualiser.h"
+#include "TrackAnalyser.h"
+#include <array>
+#include <atomic>
+
+//==============================================================================
+// DJAudioPlayer class manages audio playback, including gain, speed, position, 
+// and looping functionality. It uses JUCE's AudioSource for managing audio streams.
+// (PERSONAL CONTRIBUTION: Looping functionality, track title management)
+class DJAudioPlayer : public AudioSource,
+                      private AsyncUpdater,
+                      private Timer,
+                      private TrackAnalyser::Listener
+{
+public:
+    //==============================================================================
+    /**
+     * Receives callbacks about background track loads. All callbacks are made
+     * on the message thread.
+     */
+    class Listener
+    {
+    public:
+        virtual ~Listener() = default;
+
+        /** Called as a load progresses, with progress from 0.0 to 1.0. */
+        virtual void loadProgressChanged(DJAudioPlayer* player, double progress) {}
+
+        /** Called when a load was cancelled or superseded by a newer one. */
+        virtual void loadCancelled(DJAudioPlayer* player) {}
+
+        /**
+         * Called when a load ends.
+         * @param succeeded True if the track is now playable, false if it could not be opened.
+         */
+        virtual void loadFinished(DJAudioPlayer* player, bool succeeded) {}
+    };
+
+    /**
+     * Constructor for DJAudioPlayer.
+     * @param _formatManager Reference to AudioFormatManager for handling audio formats.
+     */
+    DJAudioPlayer(AudioFormatManager& _formatManager);
+
+    /** Destructor */
+    ~DJAudioPlayer() override;
+
+    /**
+     * Prepares the audio player to play, initializing resources based on the given 
+     * sample rate and block size.
+     * @param samplesPerBlockExpected Number of samples per block expected.
+     * @param sampleRate The audio sample rate.
+     */
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+
+    /**
+     * Fills the next block of audio data, overriding JUCE's AudioSource method.
+     * Looping is rendered sample-accurately by the LoopingAudioSource in the chain.
+     * (PERSONAL CONTRIBUTION: Overriding method for handling looping)
+     * @param bufferToFill The audio buffer to fill with audio data.
+     */
+    void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
+
+    /** Releases audio resources when no longer needed. */
+    void releaseResources() override;
+
+    //==============================================================================
+    // Looping functionality (PERSONAL CONTRIBUTION)
+    
+    /**
+     * Sets the start point for the loop.
+     * @param start The start position of the loop in seconds.
+     */
+    void setLoopStart(double start);
+
+    /**
+     * Sets the end point for the loop.
+     * @param end The end position of the loop in seconds.
+     */
+    void setLoopEnd(double end);
+
+    /** Sets the loop start to the exact sample the playhead is currently on. */
+    void markLoopStart();
+
+    /** Sets the loop end to the exact sample the playhead is currently on. */
+    void markLoopEnd();
+
+    /**
+     * Enables or disables the loop.
+     * @param shouldLoop True if looping should be enabled, false otherwise.
+     */
+    void enableLoop(bool shouldLoop);
+
+    /**
+     * Checks if looping is currently enabled.
+     * @return True if looping is enabled, false otherwise.
+     */
+    bool getIsLooping() const;
+
+    //==============================================================================
+    
+    /**
+     * Loads an audio file from a URL in the background. The current track keeps
+     * playing until the new one has been opened and primed, then the audio
+     * thread swaps it in at the start of a block. A load in progress is cancelled.
+     * @param audioURL The URL of the audio file to load.
+     * @param startWhenLoaded True to start playing as soon as the track is swapped in.
+     */
+    void loadURL(URL audioURL, bool startWhenLoaded = false);
+
+    /** Cancels the load in progress, if any. */
+    void cancelLoad();
+
+    /** Returns true while a track is being loaded or waiting to be swapped in. */
+    bool isLoading() const;
+
+    /**
+     * Gets the time from the last load request to its track becoming playable.
+     * @return The latency in milliseconds, or 0 if no track has been loaded yet.
+     */
+    double getLastLoadLatencyMs() const;
+
+    /**
+     * Sets how much decoded audio each track keeps buffered ahead of the playhead.
+     * Applies to tracks loaded from now on.
+     * @param seconds The read-ahead depth, between 2 and 10 seconds.
+     */
+    void setReadAheadSeconds(double seconds);
+
+    /**
+     * Sets where MP3 seek indexes are kept between sessions. Applies to tracks
+     * loaded from now on.
+     * @param storage Beside each file, in the application's cache directory, or not kept.
+     */
+    void setSeekIndexStorage(Mp3SeekIndex::Storage storage);
+
+    /**
+     * Gets how full the current track's read-ahead buffer is.
+     * @return A value between 0.0 (empty) and 1.0 (full).
+     */
+    float getReadAheadFillLevel() const;
+
+    /**
+     * Gets the number of audio blocks that could not be served from the read-ahead buffer.
+     * @return The underrun count since the deck was created.
+     */
+    int getNumReadAheadUnderruns() const;
+
+    /**
+     * Gets the delay between the last control change being posted and the audio
+     * thread applying it, which is one block when the device is running steadily.
+     * @return The latency in milliseconds.
+     */
+    double getLastCommandLatencyMs() const;
+
+    /** Registers a listener for load progress, cancellation and completion. */
+    void addListener(Listener* listener);
+
+    /** Unregisters a previously added listener. */
+    void removeListener(Listener* listener);
+
+    /**
+     * Sets the playback gain (volume).
+     * @param gain The gain value between 0.0 (mute) and 1.0 (full volume).
+     */
+    void setGain(double gain);
+
+    /** Fastest playback speed. Without key lock, the speed times the conversion from
+        a track's sample rate to the device's must stay within SincResamplingSource::maxRatio,
+        so a track at more than twice the device rate plays at most at
+        maxRatio * device rate / track rate; getSpeed() reports the speed actually played. */
+    static constexpr double maxSpeed = 4.0;
+
+    /** Slowest playback speed with key lock on, the stretcher's lowest tempo. Slower
+        speeds play at this one while key lock is on, and getSpeed() reports it. */
+    static constexpr double minKeyLockSpeed = TimeStretcher::minTempo;
+
+    /**
+     * Sets the playback speed.
+     * @param ratio The speed ratio where 1.0 is normal speed, values greater than 1 speed up playback,
+     *              up to maxSpeed.
+     */
+    void setSpeed(double ratio);
+
+    /** Returns the speed the deck is playing at, which follows the master while synced
+        and is limited by the loaded track's sample rate. */
+    double getSpeed() const;
+
+    /**
+     * Enables or disables loudness normalisation. Each track is trimmed so its
+     * integrated loudness meets the target, as far as its true peak allows.
+     * @param shouldNormalise True to trim tracks to the target loudness.
+     */
+    void setAutoGain(bool shouldNormalise);
+
+    /** The loudness a new deck trims tracks to */
+    static constexpr double defaultAutoGainTargetLufs = -14.0;
+
+    /**
+     * Sets the loudness tracks are trimmed to when auto gain is on.
+     * @param lufs The target integrated loudness, between -30 and -5 LUFS.
+     */
+    void setAutoGainTarget(double lufs);
+
+    /** Returns the normalisation trim applied to the loaded track, in dB. */
+    double getAutoGainDb() const;
+
+    /**
+     * Enables or disables auto-cue. Tracks loaded from now on start at their first
+     * audible sample, skipping silence at the start.
+     * @param shouldAutoCue True to skip leading silence.
+     */
+    void setAutoCue(bool shouldAutoCue);
+
+    /**
+     * Sets how long gain and speed changes take to glide to their new value.
+     * @param seconds The ramp length, between 0 (instant) and 1 second.
+     */
+    void setRampLength(double seconds);
+
+    /**
+     * Selects the shape of the gain and speed glides.
+     * @param curve Linear or exponential.
+     */
+    void setRampCurve(SmoothedParameter::Curve curve);
+
+    /**
+     * Selects the quality of the resampler used for speed changes and sample-rate conversion.
+     * @param quality The resampler quality tier.
+     */
+    void setResamplingQuality(SincResamplingSource::Quality quality);
+
+    /**
+     * Enables or disables key lock. With key lock on, speed changes alter the
+     * tempo but leave the pitch where it is, down to minKeyLockSpeed.
+     * @param shouldLockKey True to keep the pitch constant.
+     */
+    void setKeyLock(bool shouldLockKey);
+
+    /**
+     * Checks whether key lock is enabled.
+     * @return True if speed changes keep the pitch constant.
+     */
+    bool getKeyLock() const;
+
+    /**
+     * Sets the level of one EQ band.
+     * @param band The band to change.
+     * @param decibels The band gain, between -24 and +6 dB.
+     */
+    void setEqGain(DeckEqualiser::Band band, double decibels);
+
+    /**
+     * Kills or restores one EQ band.
+     * @param band The band to change.
+     * @param shouldKill True to remove the band completely.
+     */
+    void setEqKill(DeckEqualiser::Band band, bool shouldKill);
+
+    /**
+     * Moves the filter knob.
+     * @param position -1.0 for a fully closed low-pass, 0.0 for no filtering, 1.0 for a fully closed high-pass.
+     */
+    void setFilter(double position);
+
+    /**
+     * Sets the playback position in seconds.
+     * @param posInSecs The playback position in seconds.
+     */
+    void setPosition(double posInSecs);
+
+    /**
+     * Sets the playback position relative to the track's length.
+     * @param pos A value between 0.0 and 1.0 representing the relative position.
+     */
+    void setPositionRelative(double pos);
+
+    /** Starts audio playback. */
+    void start();
+
+    /** Stops audio playback. */
+    void stop();
+
+    /**
+     * Gets the relative position of the playhead in the track.
+     * @return A value between 0.0 and 1.0 representing the relative position of the playhead.
+     */
+    double getPositionRelative();
+
+    /**
+     * Gets the title of the currently loaded track.
+     * (PERSONAL CONTRIBUTION: Track title handling)
+     * @return A string containing the track title.
+     */
+    String getTrackTitle() const;
+
+    /**
+     * Gets the loaded track's tempo, from the background analysis.
+     * @return The tempo at normal speed, or 0 if it is not known (yet).
+     */
+    double getTrackBpm() const;
+
+    /**
+     * Gets where the loaded track's beatgrid starts.
+     * @return The time of the first beat in seconds, or 0 if the tempo is not known.
+     */
+    double getFirstBeatSeconds() const;
+
+    //==============================================================================
+    // Tempo sync, driven by the SyncEngine between blocks
+
+    /** Where a deck is on its beatgrid */
+    struct BeatInfo
+    {
+        double beat = 0.0;      // Beats since the first beat of the grid
+        double bpm = 0.0;       // The track's tempo at normal speed
+        double speed = 1.0;     // The speed it is playing at
+        bool playing = false;
+    };
+
+    /**
+     * Gets where the playhead is on the track's beatgrid at the start of the next block.
+     * Audio thread only, between blocks.
+     * @param info Receives the position, tempo and speed.
+     * @return False if no track is loaded or its tempo is not known.
+     */
+    bool getBeatInfo(BeatInfo& info) const;
+
+    /**
+     * Takes over the deck's speed, gliding to the given value. Speed changes from
+     * setSpeed() are remembered but not applied until the speed is released.
+     * Audio thread only, between blocks.
+     * @param speed The speed ratio.
+     */
+    void setSyncSpeed(double speed);
+
+    /** Hands the speed back to setSpeed(), gliding back to it. Audio thread only, between blocks. */
+    void releaseSyncSpeed();
+
+    //==============================================================================
+    // Scripted control, for renders that must land every change on an exact sample
+
+    /**
+     * Loads a track on the calling thread, with its loudness trim worked out,
+     * ready for swapTrackNow(). Never to be called on the audio thread.
+     * @param audioURL The file to load.
+     * @return The track, or nullptr if it could not be opened.
+     */
+    std::unique_ptr<LoadedTrack> loadTrackNow(const URL& audioURL);
+
+    /**
+     * Swaps a track in straight away, stopped at its start position, with the
+     * tempo and grid it was loaded with. Audio thread only, between blocks.
+     * @param track The track to play.
+     * @return The track it replaced, for the caller to delete off the audio thread.
+     */
+    std::unique_ptr<LoadedTrack> swapTrackNow(std::unique_ptr<LoadedTrack> track);
+
+    /**
+     * Applies a control change straight away rather than timing it from the
+     * wall clock. Audio thread only, between blocks.
+     * @param type The change to make.
+     * @param value Its value, as for the matching control method.
+     */
+    void applyCommandNow(DeckCommand::Type type, double value = 0.0);
+
+    /**
+     * Puts the settings that shape how tracks are loaded and played back to a
+     * new deck's: auto gain on at the default target, auto-cue on, medium
+     * resampling quality and key lock off. Message thread only.
+     */
+    void restoreDefaultSettings();
+
+    /**
+     * Stops the deck and puts its controls back to a new deck's straight away:
+     * unity gain and speed with the default glides, no loop, key lock or sync
+     * speed, and a flat EQ with the filter off. Queued control changes are
+     * dropped. The loaded track stays. Audio thread only, between blocks.
+     */
+    void resetNow();
+
+private:
+    /** Picks up the analysis of the loaded track */
+    void trackAnalysed(const File& file, const TrackAnalysis& analysis) override;
+
+    /** Publishes the tempo and grid of the loaded track, or clears them, and applies
+        its loudness trim and auto-cue if they were not known when it was loaded */
+    void setTrackAnalysis(const TrackAnalysis& analysis);
+
+    /** Works out the trim for a track from its loudness and the auto gain settings, in dB */
+    double getNormalisationDb(const TrackAnalysis& analysis) const;
+
+    /** Sends the loaded track's trim to the audio thread if it has changed */
+    void updateTrim();
+
+    /** Picks up loader state changes on the message thread */
+    void handleAsyncUpdate() override;
+
+    /** Waits for the audio thread to swap in a published track */
+    void timerCallback() override;
+
+    /** Swaps a loaded track into the chain. Audio thread only. */
+    void installTrack(LoadedTrack* track);
+
+    /** Queues a control change, timed one block after the current sample clock. Message thread only. */
+    void postCommand(DeckCommand::Type type, double value = 0.0);
+
+    /** Applies a control change from the queue. Audio thread only. */
+    void applyCommand(const DeckCommand& command);
+
+    /** Returns the fastest speed the loaded track can play at with the current key lock. Audio thread only. */
+    double getSpeedLimit() const;
+
+    /** Restarts the chain from the given source position. Audio thread only. */
+    void seekTo(int64 position);
+
+    /** Renders part of a block with the current settings. Audio thread only. */
+    void renderSegment(const AudioSourceChannelInfo& bufferToFill, int offset, int numSamples);
+
+    /** Deletes the tracks the audio thread has finished with. Message thread only. */
+    void deleteRetiredTracks();
+
+    /** Reference to the AudioFormatManager used to handle audio formats */
+    AudioFormatManager& formatManager;
+
+    /** Track handed to the audio thread, waiting to be swapped in at the next block */
+    std::atomic<LoadedTrack*> pendingTrack{nullptr};
+
+    /** The track being played, owned by the audio thread */
+    LoadedTrack* activeTrack = nullptr;
+
+    /** Tracks replaced by the audio thread, waiting to be deleted on the message thread */
+    AbstractFifo retiredFifo{8};
+    std::array<LoadedTrack*, 8> retiredTracks{};
+
+    /** Sample-accurate loop engine reading from the track's read-ahead buffer.
+        Loop points live here as atomic sample positions owned by the audio thread. */
+    LoopingAudioSource loopSource;
+
+    /** WSOLA time-stretcher: with key lock on it applies the speed as a tempo
+        change, otherwise it passes its input straight through */
+    TimeStretcher stretchSource{&loopSource, 2};
+
+    /** Windowed-sinc resampler applying the playback speed (unless key lock is
+        on) and converting the file's sample rate to the device rate in one pass */
+    SincResamplingSource resampleSource{&stretchSource, 2};
+
+    /** Three-band EQ with kills and the filter, applied after the resampler */
+    DeckEqualiser equaliser;
+
+    /** Control changes from the message thread, drained at the start of every block */
+    DeckCommandQueue commandQueue;
+
+    /** Playback state, owned by the audio thread and changed only through commands */
+    std::atomic<bool> playing{false};
+    SmoothedParameter gainSmoother{1.0f};
+    SmoothedParameter speedSmoother{1.0f};
+    SmoothedParameter trimSmoother{1.0f};
+    bool keyLockOn = false;
+    std::atomic<bool> startOnInstall{false};
+
+    /** The speed last set through setSpeed(), and whether the sync engine has taken over */
+    float ownSpeed = 1.0f;
+    bool syncSpeedOn = false;
+
+    /** Key lock as last requested, for the message thread to read back */
+    bool keyLockRequested = false;
+
+    /** The speed being played at, published by the audio thread */
+    std::atomic<double> playbackSpeed{1.0};
+
+    /** Output samples rendered so far, and the clock and time at the start of the last block */
+    int64 sampleClock = 0;
+    std::atomic<int64> blockStartClock{0};
+    std::atomic<double> blockStartMs{0.0};
+    std::atomic<double> lastCommandLatencyMs{0.0};
+
+    /** Playhead and track length in source samples, published by the audio thread */
+    std::atomic<int64> playheadSample{0};
+    std::atomic<int64> totalLengthSamples{0};
+
+    /** Sample rate of the loaded file, used to convert loop points from seconds */
+    std::atomic<double> sourceSampleRate{0.0};
+
+    /** Samples rendered per resampler ratio update while the speed glides */
+    static constexpr int speedStepSize = 32;
+
+    /** Device settings from the last prepareToPlay call */
+    std::atomic<double> outputSampleRate{0.0};
+    std::atomic<int> blockSize{0};
+
+    /** The title of the currently loaded track (PERSONAL CONTRIBUTION) */
+    String trackTitle;
+
+    /** The loaded track's file and analysis, and its tempo and grid published for the audio thread */
+    File trackFile;
+    TrackAnalysis trackAnalysis;
+    std::atomic<double> trackBpm{0.0};
+    std::atomic<double> firstBeatSeconds{0.0};
+
+    /** Works out the tempo of every track loaded */
+    SharedResourcePointer<TrackAnalyser> analyser;
+
+    /** Details of the last published track, for the latency log */
+    String publishedTitle;
+    File publishedFile;
+    TrackAnalysis publishedAnalysis;
+    double publishedTrimDb = 0.0;
+    double publishedRequestTimeMs = 0.0;
+    double publishedOpenMs = 0.0;
+    double publishedPrimeMs = 0.0;
+
+    /** Read-ahead counters, published by the audio thread */
+    std::atomic<float> readAheadFill{0.0f};
+    std::atomic<int> numUnderruns{0};
+    int underrunsBeforeTrack = 0;
+
+    /** Keeps the shared read-ahead threads running while this deck exists */
+    SharedResourcePointer<ReadAheadPool> readAheadPool;
+
+    /** Millisecond counter when the audio thread last swapped a track in */
+    std::atomic<double> installTimeMs{0.0};
+
+    /** Auto gain and auto-cue settings, and the trim applied to the loaded track */
+    bool autoGainOn = true;
+    double autoGainTargetLufs = defaultAutoGainTargetLufs;
+    double autoGainDb = 0.0;
+    bool autoCueOn = true;
+
+    /** Load bookkeeping on the message thread */
+    bool loading = false;
+    double lastLoadLatencyMs = 0.0;
+    int numCancelledSeen = 0;
+
+    ListenerList<Listener> listeners;
+
+    /** Background loader, declared last so it stops before anything it calls back into */
+    std::unique_ptr<TrackLoader> loader;
+};
+
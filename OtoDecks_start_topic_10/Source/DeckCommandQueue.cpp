@@ -0,0 +1,55 @@
+/*
+==============================================================================
+DeckCommandQueue.cpp
+Created: 19 Oct 2026 9:12:40am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "DeckCommandQueue.h"
+
+//==============================================================================
+// Constructor: Allocates every slot up front
+DeckCommandQueue::DeckCommandQueue(int capacity)
+    : fifo(capacity),
+      commands((size_t) capacity)
+{
+}
+
+//==============================================================================
+// Producer side: copy the command into the next free slot
+bool DeckCommandQueue::push(const DeckCommand& command)
+{
+    const auto scope = fifo.write(1);
+
+    if (scope.blockSize1 + scope.blockSize2 == 0)
+        return false;
+
+    commands[(size_t) (scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2)] = command;
+    return true;
+}
+
+//==============================================================================
+// Consumer side: look at the oldest command and only take it if it is due
+bool DeckCommandQueue::popDue(int64 endSampleTime, DeckCommand& command)
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(1, start1, size1, start2, size2);
+
+    if (size1 + size2 == 0)
+        return false;
+
+    const auto& next = commands[(size_t) (size1 > 0 ? start1 : start2)];
+
+    if (next.sampleTime >= endSampleTime)
+        return false;
+
+    command = next;
+    fifo.finishedRead(1);
+    return true;
+}
+
+int DeckCommandQueue::getNumReady() const
+{
+    return fifo.getNumReady();
+}
@@ -0,0 +1,98 @@
+/*
+==============================================================================
+DeckCommandQueue.h
+Created: 19 Oct 2026 9:12:40am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <vector>
+
+//==============================================================================
+/*
+    A single control change for a deck. The audio thread applies it at the
+    given time on the deck's output sample clock, splitting the block there.
+*/
+struct DeckCommand
+{
+    enum class Type
+    {
+        start,
+        stop,
+        setGain,
+        setSpeed,
+        setPosition,          // value in seconds
+        setPositionRelative,  // value from 0 to 1
+        setLoopStart,         // value in seconds
+        setLoopEnd,           // value in seconds
+        markLoopStart,
+        markLoopEnd,
+        enableLoop,
+        setKeyLock,
+        setRampLength,        // value in seconds
+        setRampCurve,         // value is a SmoothedParameter::Curve
+        setEqLow,             // value in dB
+        setEqMid,             // value in dB
+        setEqHigh,            // value in dB
+        killEqLow,
+        killEqMid,
+        killEqHigh,
+        setFilter,            // value from -1 (low-pass) to 1 (high-pass)
+        setTrim,              // value is a linear gain
+        autoCue               // value in source samples; ignored once the deck has played or moved
+    };
+
+    Type type = Type::stop;
+    double value = 0.0;
+
+    /** Output sample clock time at which the command takes effect */
+    int64 sampleTime = 0;
+
+    /** Millisecond counter when the command was posted, for latency measurement */
+    double postedAtMs = 0.0;
+};
+
+//==============================================================================
+/*
+    DeckCommandQueue carries DeckCommands from the message thread to the audio
+    thread. It is a fixed-size single-producer, single-consumer FIFO, so both
+    sides are wait-free and nothing is allocated after construction.
+*/
+class DeckCommandQueue
+{
+public:
+    /**
+     * Constructor for DeckCommandQueue.
+     * @param capacity The maximum number of commands waiting at once.
+     */
+    DeckCommandQueue(int capacity = 256);
+
+    /**
+     * Adds a command. Producer (message) thread only.
+     * @param command The command to add.
+     * @return False if the queue is full and the command was dropped.
+     */
+    bool push(const DeckCommand& command);
+
+    /**
+     * Takes the oldest command if it is due before the given time. Consumer (audio) thread only.
+     * Commands are taken strictly in order, so a command scheduled for later holds
+     * back the ones behind it.
+     * @param endSampleTime Commands timed before this are due.
+     * @param command Receives the command.
+     * @return True if a command was taken.
+     */
+    bool popDue(int64 endSampleTime, DeckCommand& command);
+
+    /** Returns the number of commands waiting. */
+    int getNumReady() const;
+
+private:
+    AbstractFifo fifo;
+    std::vector<DeckCommand> commands;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckCommandQueue)
+};
@@ -0,0 +1,329 @@
+/*
+==============================================================================
+DeckEqualiser.cpp
+Created: 21 Oct 2026 4:16:52pm
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "DeckEqualiser.h"
+
+namespace
+{
+    /** Filter knob positions closer to the centre than this leave the filter off */
+    constexpr float filterDeadZone = 0.02f;
+
+    /** Filter cutoff at the ends of the knob's travel */
+    constexpr double lowPassLowestHz = 80.0;
+    constexpr double lowPassHighestHz = 20000.0;
+    constexpr double highPassLowestHz = 20.0;
+    constexpr double highPassHighestHz = 8000.0;
+
+    /** Glide times for band gains, the filter knob, and fading the filter in and out */
+    constexpr double bandRampSeconds = 0.01;
+    constexpr double filterRampSeconds = 0.05;
+    constexpr double filterFadeSeconds = 0.01;
+}
+
+//==============================================================================
+// Constructor: Flat bands and the filter switched out, ready for 44.1 kHz
+DeckEqualiser::DeckEqualiser()
+{
+    for (auto& smoother : bandSmoother)
+        smoother.setCurrentAndTargetValue(1.0f);
+
+    prepare(sampleRate);
+}
+
+void DeckEqualiser::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+
+    for (auto& smoother : bandSmoother)
+    {
+        smoother.prepare(sampleRate, 1);
+        smoother.setRampLength(bandRampSeconds);
+    }
+
+    filterPosition.prepare(sampleRate, 1);
+    filterPosition.setRampLength(filterRampSeconds);
+    filterMix.prepare(sampleRate, 1);
+    filterMix.setRampLength(filterFadeSeconds);
+
+    for (auto& stage : lowCrossover)
+        stage.setCoefficients(makeLowPass(sampleRate, lowCrossoverHz, butterworthQ),
+                              makeHighPass(sampleRate, lowCrossoverHz, butterworthQ));
+
+    for (auto& stage : highCrossover)
+        stage.setCoefficients(makeLowPass(sampleRate, highCrossoverHz, butterworthQ),
+                              makeHighPass(sampleRate, highCrossoverHz, butterworthQ));
+
+    // The sum of a Linkwitz-Riley low-pass and high-pass is a Butterworth-Q allpass
+    const auto allPass = makeAllPass(sampleRate, highCrossoverHz, butterworthQ);
+    lowAllPass.setCoefficients(allPass, allPass);
+
+    updateFilterCoefficients();
+    reset();
+}
+
+void DeckEqualiser::reset()
+{
+    for (auto& stage : lowCrossover)
+        stage.reset();
+
+    for (auto& stage : highCrossover)
+        stage.reset();
+
+    lowAllPass.reset();
+    filter.reset();
+}
+
+// Back to how the constructor left it, so what follows sounds the same as on a new deck
+void DeckEqualiser::resetControls()
+{
+    for (int band = 0; band < 3; ++band)
+    {
+        bandGain[band] = 1.0f;
+        bandKilled[band] = false;
+        bandSmoother[band].setCurrentAndTargetValue(1.0f);
+    }
+
+    filterType = FilterType::none;
+    filterPosition.setCurrentAndTargetValue(0.0f);
+    filterMix.setCurrentAndTargetValue(0.0f);
+    updateFilterCoefficients();
+    reset();
+}
+
+//==============================================================================
+void DeckEqualiser::setBandGain(Band band, float decibels)
+{
+    if (decibels < -24.0f || decibels > 6.0f)
+    {
+        std::cout << "DeckEqualiser::setBandGain decibels should be between -24 and 6" << std::endl;
+    }
+    else {
+        bandGain[(int) band] = Decibels::decibelsToGain(decibels);
+        updateBandTarget((int) band);
+    }
+}
+
+void DeckEqualiser::setBandKill(Band band, bool shouldKill)
+{
+    bandKilled[(int) band] = shouldKill;
+    updateBandTarget((int) band);
+}
+
+void DeckEqualiser::updateBandTarget(int band)
+{
+    bandSmoother[band].setTargetValue(bandKilled[band] ? 0.0f : bandGain[band]);
+}
+
+void DeckEqualiser::setFilter(float position)
+{
+    if (position < -1.0f || position > 1.0f)
+    {
+        std::cout << "DeckEqualiser::setFilter position should be between -1 and 1" << std::endl;
+    }
+    else {
+        filterPosition.setTargetValue(position);
+    }
+}
+
+//==============================================================================
+void DeckEqualiser::process(AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    if (buffer.getNumChannels() == 0 || numSamples <= 0)
+        return;
+
+    const ScopedNoDenormals noDenormals;
+
+    float* left = buffer.getWritePointer(0, startSample);
+    float* right = buffer.getNumChannels() > 1 ? buffer.getWritePointer(1, startSample) : left;
+
+    processBands(left, right, numSamples);
+    processFilter(left, right, numSamples);
+}
+
+// Split into bands and apply each band's gain, sample by sample
+void DeckEqualiser::processBands(float* left, float* right, int numSamples)
+{
+    using namespace SimdKernels;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float low = bandSmoother[0].getNextValue();
+        const float mid = bandSmoother[1].getNextValue();
+        const float high = bandSmoother[2].getNextValue();
+
+        const float l = left[i];
+        const float r = right[i];
+
+        // Low band and the rest, then the rest split into mid and high
+        float lowAndRest[4];
+        store4(lowAndRest, lowCrossover[1].process(lowCrossover[0].process(set4(l, r, l, r))));
+
+        const auto midAndHigh = highCrossover[1].process(highCrossover[0].process(
+                                    set4(lowAndRest[2], lowAndRest[3], lowAndRest[2], lowAndRest[3])));
+        const auto lowBand = lowAllPass.process(set4(lowAndRest[0], lowAndRest[1], 0.0f, 0.0f));
+
+        float bands[4];
+        float lows[4];
+        store4(bands, mul4(midAndHigh, set4(mid, mid, high, high)));
+        store4(lows, lowBand);
+
+        left[i] = low * lows[0] + bands[0] + bands[2];
+        right[i] = low * lows[1] + bands[1] + bands[3];
+    }
+}
+
+// The filter type only changes while the filter is faded out, so the state
+// of one type is never run through the coefficients of the other
+void DeckEqualiser::processFilter(float* left, float* right, int numSamples)
+{
+    using namespace SimdKernels;
+    int numDone = 0;
+
+    while (numDone < numSamples)
+    {
+        const float position = filterPosition.getCurrentValue();
+        const FilterType wanted = std::abs(position) < filterDeadZone ? FilterType::none
+                                : position < 0.0f                     ? FilterType::lowPass
+                                                                      : FilterType::highPass;
+
+        if (wanted != filterType)
+        {
+            if (filterMix.getCurrentValue() == 0.0f)
+            {
+                filterType = wanted;
+                filter.reset();
+                filterMix.setTargetValue(wanted == FilterType::none ? 0.0f : 1.0f);
+            }
+            else if (filterMix.getTargetValue() != 0.0f)
+            {
+                filterMix.setTargetValue(0.0f);
+            }
+        }
+        else if (filterType != FilterType::none && filterMix.getTargetValue() != 1.0f)
+        {
+            filterMix.setTargetValue(1.0f);  // Turned back before the fade-out finished
+        }
+
+        const bool gliding = filterPosition.isSmoothing() || filterMix.isSmoothing();
+        const int numThisTime = gliding ? jmin(filterStepSize, numSamples - numDone) : numSamples - numDone;
+
+        if (filterType == FilterType::none && ! filterMix.isSmoothing())
+        {
+            filterPosition.skip(numThisTime);  // Switched out: nothing to do
+            numDone += numThisTime;
+            continue;
+        }
+
+        updateFilterCoefficients();
+        filterPosition.skip(numThisTime);
+
+        for (int i = numDone; i < numDone + numThisTime; ++i)
+        {
+            const float mix = filterMix.getNextValue();
+            const float l = left[i];
+            const float r = right[i];
+
+            float wet[4];
+            store4(wet, filter.process(set4(l, r, 0.0f, 0.0f)));
+
+            left[i] = l + mix * (wet[0] - l);
+            right[i] = r + mix * (wet[1] - r);
+        }
+
+        numDone += numThisTime;
+    }
+}
+
+//==============================================================================
+// The cutoff sweeps exponentially from the centre outwards and the resonance
+// rises with it. A filter being faded out after the knob crossed the centre
+// uses the knob's distance from the centre, which keeps it near open.
+void DeckEqualiser::updateFilterCoefficients()
+{
+    const double amount = jlimit(filterDeadZone, 1.0f, std::abs(filterPosition.getCurrentValue()));
+    const double q = butterworthQ + 0.6 * amount;
+
+    Coefficients coefficients;
+
+    if (filterType == FilterType::lowPass)
+    {
+        const double cutoff = lowPassHighestHz * std::pow(lowPassLowestHz / lowPassHighestHz, amount);
+        coefficients = makeLowPass(sampleRate, jmin(cutoff, sampleRate * 0.45), q);
+    }
+    else if (filterType == FilterType::highPass)
+    {
+        const double cutoff = highPassLowestHz * std::pow(highPassHighestHz / highPassLowestHz, amount);
+        coefficients = makeHighPass(sampleRate, jmin(cutoff, sampleRate * 0.45), q);
+    }
+
+    filter.setCoefficients(coefficients, coefficients);
+}
+
+DeckEqualiser::Coefficients DeckEqualiser::makeLowPass(double rate, double frequency, double q)
+{
+    const double k = std::tan(MathConstants<double>::pi * frequency / rate);
+    const double norm = 1.0 / (1.0 + k / q + k * k);
+
+    Coefficients c;
+    c.b0 = (float) (k * k * norm);
+    c.b1 = 2.0f * c.b0;
+    c.b2 = c.b0;
+    c.a1 = (float) (2.0 * (k * k - 1.0) * norm);
+    c.a2 = (float) ((1.0 - k / q + k * k) * norm);
+    return c;
+}
+
+DeckEqualiser::Coefficients DeckEqualiser::makeHighPass(double rate, double frequency, double q)
+{
+    const double k = std::tan(MathConstants<double>::pi * frequency / rate);
+    const double norm = 1.0 / (1.0 + k / q + k * k);
+
+    Coefficients c;
+    c.b0 = (float) norm;
+    c.b1 = -2.0f * c.b0;
+    c.b2 = c.b0;
+    c.a1 = (float) (2.0 * (k * k - 1.0) * norm);
+    c.a2 = (float) ((1.0 - k / q + k * k) * norm);
+    return c;
+}
+
+DeckEqualiser::Coefficients DeckEqualiser::makeAllPass(double rate, double frequency, double q)
+{
+    const double k = std::tan(MathConstants<double>::pi * frequency / rate);
+    const double norm = 1.0 / (1.0 + k / q + k * k);
+
+    Coefficients c;
+    c.b0 = (float) ((1.0 - k / q + k * k) * norm);
+    c.b1 = (float) (2.0 * (k * k - 1.0) * norm);
+    c.b2 = 1.0f;
+    c.a1 = c.b1;
+    c.a2 = c.b0;
+    return c;
+}
+
+//==============================================================================
+void DeckEqualiser::Biquad4::setCoefficients(const Coefficients& lanes01, const Coefficients& lanes23)
+{
+    setCoefficients(lanes01, lanes01, lanes23, lanes23);
+}
+
+void DeckEqualiser::Biquad4::setCoefficients(const Coefficients& lane0, const Coefficients& lane1,
+                                             const Coefficients& lane2, const Coefficients& lane3)
+{
+    using namespace SimdKernels;
+    b0 = set4(lane0.b0, lane1.b0, lane2.b0, lane3.b0);
+    b1 = set4(lane0.b1, lane1.b1, lane2.b1, lane3.b1);
+    b2 = set4(lane0.b2, lane1.b2, lane2.b2, lane3.b2);
+    a1 = set4(lane0.a1, lane1.a1, lane2.a1, lane3.a1);
+    a2 = set4(lane0.a2, lane1.a2, lane2.a2, lane3.a2);
+}
+
+void DeckEqualiser::Biquad4::reset()
+{
+    z1 = z2 = SimdKernels::broadcast4(0.0f);
+}
@@ -0,0 +1,187 @@
+/*
+==============================================================================
+DeckEqualiser.h
+Created: 21 Oct 2026 4:16:52pm
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "SimdKernels.h"
+#include "SmoothedParameter.h"
+
+//==============================================================================
+/*
+    DeckEqualiser is a DJ-style three-band EQ with kill switches, followed by
+    a one-knob filter: turning left sweeps a low-pass down, turning right
+    sweeps a high-pass up, and the centre leaves the sound alone.
+
+    The EQ is an isolator built from Linkwitz-Riley crossovers. The first
+    splits the input into low and the rest, the second splits the rest into
+    mid and high, and the low band goes through the allpass the second
+    crossover applies to the others. The bands therefore sum to an allpass
+    of the input, so a flat EQ changes only the phase and a killed band is
+    removed completely. Each crossover stage is a low-pass and a high-pass
+    for both stereo channels: four independent biquads, which run side by
+    side in the lanes of one Vec4. The filter runs the two channels in the
+    lanes of another.
+
+    Band gains glide per sample with SmoothedParameters. The filter knob
+    glides too, and its coefficients are recomputed every few samples while
+    it moves. Switching between low-pass and high-pass fades the filter out
+    and back in. With the filter centred it costs nothing.
+
+    All methods are meant for the audio thread. Nothing is allocated after
+    construction.
+*/
+class DeckEqualiser
+{
+public:
+    /** The EQ bands */
+    enum class Band
+    {
+        low,
+        mid,
+        high
+    };
+
+    /** Crossover frequencies between the low, mid and high bands */
+    static constexpr double lowCrossoverHz = 250.0;
+    static constexpr double highCrossoverHz = 2500.0;
+
+    /** One set of biquad coefficients, normalised so a0 is 1 */
+    struct Coefficients
+    {
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+    };
+
+    /** Low-pass, high-pass and allpass coefficients from the bilinear transform (RBJ cookbook) */
+    static Coefficients makeLowPass(double sampleRate, double frequency, double q);
+    static Coefficients makeHighPass(double sampleRate, double frequency, double q);
+    static Coefficients makeAllPass(double sampleRate, double frequency, double q);
+
+    /** Butterworth Q; two Butterworth stages in series make a Linkwitz-Riley crossover */
+    static constexpr double butterworthQ = 0.70710678;
+
+    /** Four transposed direct form II biquads, one per lane, stepped together.
+        WaveformPyramid splits its bands with these too, at the same crossovers. */
+    struct Biquad4
+    {
+        /** Sets lanes 0 and 1 to one filter and lanes 2 and 3 to another */
+        void setCoefficients(const Coefficients& lanes01, const Coefficients& lanes23);
+
+        /** Sets each lane to its own filter */
+        void setCoefficients(const Coefficients& lane0, const Coefficients& lane1,
+                             const Coefficients& lane2, const Coefficients& lane3);
+
+        void reset();
+
+        inline SimdKernels::Vec4 process(SimdKernels::Vec4 x)
+        {
+            using namespace SimdKernels;
+            const auto y = add4(mul4(b0, x), z1);
+            z1 = sub4(add4(mul4(b1, x), z2), mul4(a1, y));
+            z2 = sub4(mul4(b2, x), mul4(a2, y));
+            return y;
+        }
+
+        SimdKernels::Vec4 b0, b1, b2, a1, a2;
+        SimdKernels::Vec4 z1 = SimdKernels::broadcast4(0.0f);
+        SimdKernels::Vec4 z2 = SimdKernels::broadcast4(0.0f);
+    };
+
+    /** Constructor for DeckEqualiser. Starts flat, with the filter centred. */
+    DeckEqualiser();
+
+    /**
+     * Sets the sample rate and clears the filters.
+     * @param sampleRate The rate of the audio to be processed.
+     */
+    void prepare(double sampleRate);
+
+    /** Clears the filter state, e.g. after a jump in the audio. */
+    void reset();
+
+    /** Returns to flat bands with no kills and the filter switched out, straight
+        away rather than gliding, and clears the filter state. */
+    void resetControls();
+
+    /**
+     * Sets the level of one band.
+     * @param band The band to change.
+     * @param decibels The band gain, between -24 and +6 dB.
+     */
+    void setBandGain(Band band, float decibels);
+
+    /**
+     * Kills or restores one band. A killed band is silent whatever its gain.
+     * @param band The band to change.
+     * @param shouldKill True to remove the band.
+     */
+    void setBandKill(Band band, bool shouldKill);
+
+    /**
+     * Moves the filter knob.
+     * @param position -1.0 for the lowest low-pass cutoff, 0.0 for no filtering,
+     *                 1.0 for the highest high-pass cutoff.
+     */
+    void setFilter(float position);
+
+    /**
+     * Filters a region of a buffer in place. Only the first two channels are
+     * processed; a mono buffer is treated as both.
+     * @param buffer The audio to process.
+     * @param startSample The first sample to process.
+     * @param numSamples The number of samples to process.
+     */
+    void process(AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+private:
+    /** Which filter is switched in */
+    enum class FilterType
+    {
+        none,
+        lowPass,
+        highPass
+    };
+
+    /** Processes the EQ bands, sample by sample */
+    void processBands(float* left, float* right, int numSamples);
+
+    /** Processes the filter, in steps short enough for the cutoff to glide */
+    void processFilter(float* left, float* right, int numSamples);
+
+    /** Sets a band's gain target from its level and kill switch */
+    void updateBandTarget(int band);
+
+    /** Recomputes the filter coefficients for the knob's current position */
+    void updateFilterCoefficients();
+
+    double sampleRate = 44100.0;
+
+    /** The two crossovers, two Butterworth stages each. Lanes are the low-pass
+        for left and right, then the high-pass for left and right. */
+    Biquad4 lowCrossover[2];
+    Biquad4 highCrossover[2];
+
+    /** Matches the low band's phase to the other two; lanes are left and right */
+    Biquad4 lowAllPass;
+
+    /** Band levels and kills as set, and the gains actually applied */
+    float bandGain[3] = { 1.0f, 1.0f, 1.0f };
+    bool bandKilled[3] = { false, false, false };
+    SmoothedParameter bandSmoother[3];
+
+    /** The filter: lanes are left and right, the other two are unused */
+    Biquad4 filter;
+    FilterType filterType = FilterType::none;
+    SmoothedParameter filterPosition{0.0f};
+    SmoothedParameter filterMix{0.0f};
+
+    /** Samples rendered per coefficient update while the filter knob glides */
+    static constexpr int filterStepSize = 32;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckEqualiser)
+};
@@ -0,0 +1,428 @@
+/*
+==============================================================================
+DecodedTrackCache.cpp
+Created: 20 Oct 2026 10:12:55am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "DecodedTrackCache.h"
+
+//==============================================================================
+// Constructor: Allocates (and clears) the whole track up front
+DecodedTrack::DecodedTrack(const String& _key, int numChannels, int64 numSamples, double _sampleRate)
+    : key(_key),
+      audio(numChannels, (int) numSamples),
+      sampleRate(_sampleRate)
+{
+}
+
+const String& DecodedTrack::getKey() const
+{
+    return key;
+}
+
+const AudioBuffer<float>& DecodedTrack::getAudio() const
+{
+    return audio;
+}
+
+double DecodedTrack::getSampleRate() const
+{
+    return sampleRate;
+}
+
+int64 DecodedTrack::getSizeInBytes() const
+{
+    return (int64) audio.getNumChannels() * audio.getNumSamples() * (int64) sizeof(float);
+}
+
+int64 DecodedTrack::getNumDecoded() const
+{
+    return numDecoded.load();
+}
+
+bool DecodedTrack::isComplete() const
+{
+    return complete.load();
+}
+
+bool DecodedTrack::isAbandoned() const
+{
+    return abandoned.load();
+}
+
+bool DecodedTrack::waitUntilComplete(int timeoutMs) const
+{
+    const double giveUpMs = Time::getMillisecondCounterHiRes() + timeoutMs;
+
+    while (! isComplete() && ! isAbandoned() && (timeoutMs < 0 || Time::getMillisecondCounterHiRes() < giveUpMs))
+        Thread::sleep(5);
+
+    return isComplete();
+}
+
+//==============================================================================
+// Constructor: The decode thread runs at normal priority, below the read-ahead
+// threads, since a deck waiting on the decode is streaming in the meantime
+DecodedTrackCache::DecodedTrackCache()
+    : Thread("Track Decoder")
+{
+    formatManager.registerBasicFormats();
+    startThread();
+}
+
+DecodedTrackCache::~DecodedTrackCache()
+{
+    {
+        const ScopedLock sl(lock);
+
+        for (auto& job : decodeQueue)
+            job.track->abandoned = true;
+
+        decodeQueue.clear();
+    }
+
+    signalThreadShouldExit();
+    notify();
+    stopThread(4000);
+}
+
+//==============================================================================
+void DecodedTrackCache::setMemoryBudget(int64 bytes)
+{
+    const ScopedLock sl(lock);
+    budgetBytes = jmax((int64) 0, bytes);
+    evictFor(0);
+}
+
+int64 DecodedTrackCache::getMemoryBudget() const
+{
+    const ScopedLock sl(lock);
+    return budgetBytes;
+}
+
+DecodedTrackCache::Stats DecodedTrackCache::getStats() const
+{
+    const ScopedLock sl(lock);
+
+    Stats stats;
+    stats.hits = hits;
+    stats.misses = misses;
+    stats.evictions = evictions;
+    stats.numTracks = tracks.size();
+    stats.bytesInUse = bytesInUse;
+    stats.budgetBytes = budgetBytes;
+    return stats;
+}
+
+String DecodedTrackCache::getKey(const File& file)
+{
+    return file.getFullPathName()
+         + "|" + String(file.getSize())
+         + "|" + String(file.getLastModificationTime().toMilliseconds());
+}
+
+//==============================================================================
+DecodedTrack::Ptr DecodedTrackCache::find(const File& file)
+{
+    const String key = getKey(file);
+    const ScopedLock sl(lock);
+
+    for (int i = 0; i < tracks.size(); ++i)
+    {
+        auto track = tracks.getUnchecked(i);
+
+        if (track->getKey() == key && track->isComplete())
+        {
+            tracks.move(i, -1);
+            return track;
+        }
+    }
+
+    return nullptr;
+}
+
+//==============================================================================
+// Called with the lock held
+DecodedTrack::Ptr DecodedTrackCache::lookUp(const String& key)
+{
+    for (int i = 0; i < tracks.size(); ++i)
+    {
+        if (tracks.getUnchecked(i)->getKey() == key)
+        {
+            DecodedTrack::Ptr track = tracks.getUnchecked(i);
+            tracks.move(i, -1);  // Most recently used goes to the end
+            ++hits;
+            return track;
+        }
+    }
+
+    ++misses;
+    return nullptr;
+}
+
+// Look the file up and, on a miss, reserve its entry under the same lock, so
+// two decks loading the same file at once decode it only once. The decode
+// itself runs outside the lock.
+DecodedTrack::Ptr DecodedTrackCache::getOrDecode(const File& file,
+                                                 AudioFormatReader& reader,
+                                                 const std::function<bool(double)>& onProgress)
+{
+    const String key = getKey(file);
+    const int64 length = reader.lengthInSamples;
+    DecodedTrack::Ptr track;
+    bool decodeHere = false;
+
+    {
+        const ScopedLock sl(lock);
+        track = lookUp(key);
+
+        if (track == nullptr)
+        {
+            track = reserve(key, jmin(2, (int) reader.numChannels), length, reader.sampleRate);
+            decodeHere = track != nullptr;
+        }
+    }
+
+    if (track == nullptr)
+        return nullptr;
+
+    if (decodeHere)
+    {
+        if (! decodeInto(*track, reader, onProgress))
+        {
+            abandon(track.get());
+            return nullptr;
+        }
+
+        return track;
+    }
+
+    // This file is being decoded elsewhere: wait for it rather than decoding it again
+    while (! track->isComplete())
+    {
+        if (track->isAbandoned() || ! onProgress((double) track->getNumDecoded() / (double) length))
+            return nullptr;
+
+        Thread::sleep(20);
+    }
+
+    return track;
+}
+
+// The same lookup, but a miss is handed to the decode thread instead of decoded here
+DecodedTrack::Ptr DecodedTrackCache::getOrStartDecode(const File& file, const AudioFormatReader& reader)
+{
+    const String key = getKey(file);
+    DecodedTrack::Ptr track;
+
+    {
+        const ScopedLock sl(lock);
+        track = lookUp(key);
+
+        if (track != nullptr)
+            return track;
+
+        track = reserve(key, jmin(2, (int) reader.numChannels), reader.lengthInSamples, reader.sampleRate);
+
+        if (track == nullptr)
+            return nullptr;
+
+        decodeQueue.push_back({ file, track });
+    }
+
+    notify();
+    return track;
+}
+
+// Publishing the count after each chunk lets a CachedTrackSource play the
+// part decoded so far
+bool DecodedTrackCache::decodeInto(DecodedTrack& track, AudioFormatReader& reader, const std::function<bool(double)>& onProgress)
+{
+    constexpr int chunkSize = 65536;
+    const int64 length = track.audio.getNumSamples();
+
+    if (reader.lengthInSamples < length)
+        return false;
+
+    for (int64 start = 0; start < length; start += chunkSize)
+    {
+        const int numThisTime = (int) jmin((int64) chunkSize, length - start);
+
+        if (! onProgress((double) start / (double) length)
+             || ! reader.read(&track.audio, (int) start, numThisTime, start, true, true))
+            return false;
+
+        track.numDecoded = start + numThisTime;
+    }
+
+    track.complete = true;
+    return true;
+}
+
+// The thread opens its own reader, since the loader's goes on to stream the
+// track while this one decodes it
+void DecodedTrackCache::run()
+{
+    while (! threadShouldExit())
+    {
+        DecodeJob job;
+
+        {
+            const ScopedLock sl(lock);
+
+            if (! decodeQueue.empty())
+            {
+                job = decodeQueue.front();
+                decodeQueue.pop_front();
+            }
+        }
+
+        if (job.track == nullptr)
+        {
+            wait(-1);
+            continue;
+        }
+
+        std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(job.file));
+
+        if (reader == nullptr || ! decodeInto(*job.track, *reader, [this](double) { return ! threadShouldExit(); }))
+        {
+            if (! threadShouldExit())
+                std::cout << "DecodedTrackCache could not decode " << job.file.getFullPathName() << std::endl;
+
+            abandon(job.track.get());
+        }
+    }
+}
+
+//==============================================================================
+// Tracks bigger than half the budget would push everything else out, so they stream instead
+DecodedTrack::Ptr DecodedTrackCache::reserve(const String& key, int numChannels, int64 numSamples, double sampleRate)
+{
+    const int64 bytes = (int64) numChannels * numSamples * (int64) sizeof(float);
+
+    if (numChannels <= 0 || numSamples <= 0 || numSamples > std::numeric_limits<int>::max()
+         || bytes > budgetBytes / 2 || ! evictFor(bytes))
+        return nullptr;
+
+    DecodedTrack::Ptr track = new DecodedTrack(key, numChannels, numSamples, sampleRate);
+    tracks.add(track);
+    bytesInUse += bytes;
+    return track;
+}
+
+// A track is only evicted when the cache holds the last reference to it, so
+// nothing a deck is playing ever disappears. The track is looked at through a
+// raw pointer: holding a Ptr here would itself be a second reference.
+bool DecodedTrackCache::evictFor(int64 bytesNeeded)
+{
+    for (int i = 0; i < tracks.size() && bytesInUse + bytesNeeded > budgetBytes;)
+    {
+        auto* track = tracks.getObjectPointerUnchecked(i);
+
+        if (track->getReferenceCount() == 1 && track->isComplete())
+        {
+            bytesInUse -= track->getSizeInBytes();
+            tracks.remove(i);
+            ++evictions;
+        }
+        else {
+            ++i;
+        }
+    }
+
+    return bytesInUse + bytesNeeded <= budgetBytes;
+}
+
+void DecodedTrackCache::abandon(DecodedTrack* track)
+{
+    const ScopedLock sl(lock);
+
+    track->abandoned = true;
+
+    if (tracks.contains(track))
+    {
+        bytesInUse -= track->getSizeInBytes();
+        tracks.removeObject(track);
+    }
+}
+
+//==============================================================================
+// Constructor: Starts at the top of the track
+CachedTrackSource::CachedTrackSource(DecodedTrack::Ptr _track, PositionableAudioSource* _fallback)
+    : track(std::move(_track)),
+      fallback(_fallback)
+{
+}
+
+const DecodedTrack& CachedTrackSource::getTrack() const
+{
+    return *track;
+}
+
+void CachedTrackSource::prepareToPlay(int, double)
+{
+}
+
+void CachedTrackSource::releaseResources()
+{
+}
+
+//==============================================================================
+// Copy straight out of the shared buffer; a mono track feeds both channels.
+// A block the decode has not reached is streamed, with the fallback moved
+// to this source's position first if it has fallen out of step.
+void CachedTrackSource::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill)
+{
+    const auto& audio = track->getAudio();
+    const int64 start = position.load();
+    const int64 numDecoded = track->getNumDecoded();
+
+    if (fallback != nullptr && jmin(start + bufferToFill.numSamples, (int64) audio.getNumSamples()) > numDecoded)
+    {
+        if (fallback->getNextReadPosition() != start)
+            fallback->setNextReadPosition(start);
+
+        fallback->getNextAudioBlock(bufferToFill);
+        position = start + bufferToFill.numSamples;
+        return;
+    }
+
+    const int numAvailable = (start < 0 || start >= numDecoded)
+                                 ? 0
+                                 : (int) jmin((int64) bufferToFill.numSamples, numDecoded - start);
+
+    for (int channel = 0; channel < bufferToFill.buffer->getNumChannels(); ++channel)
+    {
+        if (numAvailable > 0)
+            bufferToFill.buffer->copyFrom(channel, bufferToFill.startSample,
+                                          audio, jmin(channel, audio.getNumChannels() - 1), (int) start, numAvailable);
+
+        if (numAvailable < bufferToFill.numSamples)
+            bufferToFill.buffer->clear(channel, bufferToFill.startSample + numAvailable, bufferToFill.numSamples - numAvailable);
+    }
+
+    position = start + bufferToFill.numSamples;
+}
+
+void CachedTrackSource::setNextReadPosition(int64 newPosition)
+{
+    position = newPosition;
+}
+
+int64 CachedTrackSource::getNextReadPosition() const
+{
+    return position.load();
+}
+
+int64 CachedTrackSource::getTotalLength() const
+{
+    return track->getAudio().getNumSamples();
+}
+
+bool CachedTrackSource::isLooping() const
+{
+    return false;
+}
@@ -0,0 +1,246 @@
+/*
+==============================================================================
+DecodedTrackCache.h
+Created: 20 Oct 2026 10:12:55am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <atomic>
+#include <deque>
+#include <functional>
+
+//==============================================================================
+/*
+    A whole track decoded to float PCM and shared by every deck that plays it.
+    The samples are written once, in order, by whichever thread decodes the
+    track, and the number written so far is published as they go. Nothing
+    past that number is read until it has been written.
+
+    Instances are reference counted. The last reference to go is always
+    dropped on the message thread or a loader thread, never the audio thread.
+*/
+class DecodedTrack : public ReferenceCountedObject
+{
+public:
+    using Ptr = ReferenceCountedObjectPtr<DecodedTrack>;
+
+    /**
+     * Constructor for DecodedTrack. Allocates space for the whole track.
+     * @param _key The file identity the track is cached under.
+     * @param numChannels The number of channels to keep (at most 2).
+     * @param numSamples The length of the track.
+     * @param _sampleRate The file's sample rate.
+     */
+    DecodedTrack(const String& _key, int numChannels, int64 numSamples, double _sampleRate);
+
+    /** Returns the file identity the track is cached under. */
+    const String& getKey() const;
+
+    /** Returns the decoded audio. Until the track is complete, only the first getNumDecoded() samples are valid. */
+    const AudioBuffer<float>& getAudio() const;
+
+    /** Returns the file's sample rate. */
+    double getSampleRate() const;
+
+    /** Returns the memory held by the samples, in bytes. */
+    int64 getSizeInBytes() const;
+
+    /** Returns the number of samples decoded so far. */
+    int64 getNumDecoded() const;
+
+    /** Returns true once the whole track has been decoded. */
+    bool isComplete() const;
+
+    /** Returns true if the decode was given up and the track will never be complete. */
+    bool isAbandoned() const;
+
+    /**
+     * Waits for a background decode to finish. Not for the audio thread.
+     * @param timeoutMs The longest to wait, or -1 for as long as it takes.
+     * @return True if the track is complete.
+     */
+    bool waitUntilComplete(int timeoutMs) const;
+
+private:
+    friend class DecodedTrackCache;
+
+    String key;
+    AudioBuffer<float> audio;
+    double sampleRate;
+
+    std::atomic<int64> numDecoded{0};
+    std::atomic<bool> complete{false};
+    std::atomic<bool> abandoned{false};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DecodedTrack)
+};
+
+//==============================================================================
+/*
+    DecodedTrackCache keeps decoded tracks in memory across the whole process,
+    keyed by file identity (path, size and modification time). Loading a track
+    that is already playing on another deck, or that was played recently,
+    costs no decoding at all.
+
+    The cache works to a RAM budget. When a new track needs room, the least
+    recently used tracks that no deck is playing are evicted. Tracks too big
+    to fit in half the budget are not cached and are streamed instead.
+
+    A track can be decoded on the caller's thread, or queued for the cache's
+    own thread so a deck can stream it in the meantime and move over to the
+    decoded audio as the decode overtakes it (see CachedTrackSource).
+
+    Use it through SharedResourcePointer<DecodedTrackCache>. Not for the
+    audio thread.
+*/
+class DecodedTrackCache : private Thread
+{
+public:
+    /** Counters describing how well the cache is doing */
+    struct Stats
+    {
+        int hits = 0;
+        int misses = 0;
+        int evictions = 0;
+        int numTracks = 0;
+        int64 bytesInUse = 0;
+        int64 budgetBytes = 0;
+    };
+
+    /** Constructor: starts with a 1 GB budget, and starts the decode thread */
+    DecodedTrackCache();
+
+    /** Destructor: abandons the decodes still queued or in progress */
+    ~DecodedTrackCache() override;
+
+    /**
+     * Sets the memory budget, evicting unused tracks if it has shrunk.
+     * @param bytes The most decoded audio to keep in memory.
+     */
+    void setMemoryBudget(int64 bytes);
+
+    /** Returns the memory budget in bytes. */
+    int64 getMemoryBudget() const;
+
+    /**
+     * Gets a file's decoded audio, decoding it into the cache on a miss.
+     * If the file is already being decoded, by another loader or in the background, waits for it.
+     * @param file The file the reader was opened on, which identifies the track.
+     * @param reader A reader for the file, used only on a miss.
+     * @param onProgress Called with the decode progress; returning false abandons it.
+     * @return The complete track, or nullptr if it is too big to cache, could not be decoded or was abandoned.
+     */
+    DecodedTrack::Ptr getOrDecode(const File& file,
+                                  AudioFormatReader& reader,
+                                  const std::function<bool(double)>& onProgress);
+
+    /**
+     * Gets a file's decoded audio, queueing it to be decoded in the background on a miss.
+     * Returns at once, so the track may still be decoding: getNumDecoded() says how far it has got.
+     * @param file The file the reader was opened on, which identifies the track.
+     * @param reader A reader for the file, whose length and format the track is sized from.
+     * @return The track, complete or on its way, or nullptr if it is too big to cache.
+     */
+    DecodedTrack::Ptr getOrStartDecode(const File& file, const AudioFormatReader& reader);
+
+    /**
+     * Gets a file's decoded audio if it is already in the cache, without decoding
+     * anything. Does not count as a hit or a miss.
+     * @param file The file to look for.
+     * @return The complete track, or nullptr if it is not cached or still being decoded.
+     */
+    DecodedTrack::Ptr find(const File& file);
+
+    /** Returns a snapshot of the counters. */
+    Stats getStats() const;
+
+private:
+    /** A track waiting for the decode thread, and the file to decode it from */
+    struct DecodeJob
+    {
+        File file;
+        DecodedTrack::Ptr track;
+    };
+
+    /** Finds a track by key and marks it most recently used, counting a hit or a miss */
+    DecodedTrack::Ptr lookUp(const String& key);
+
+    /** Decodes a whole reader into a reserved track, returning false if it was abandoned or failed */
+    static bool decodeInto(DecodedTrack& track, AudioFormatReader& reader, const std::function<bool(double)>& onProgress);
+
+    /** Decode thread: works through the queue until asked to stop */
+    void run() override;
+
+    /** Makes room for a new track and adds it, or returns nullptr if it cannot fit */
+    DecodedTrack::Ptr reserve(const String& key, int numChannels, int64 numSamples, double sampleRate);
+
+    /** Evicts unused tracks, oldest first, until bytesInUse + bytesNeeded fits the budget */
+    bool evictFor(int64 bytesNeeded);
+
+    /** Takes a track that failed to decode out of the cache */
+    void abandon(DecodedTrack* track);
+
+    /** Returns the identity a file is cached under */
+    static String getKey(const File& file);
+
+    mutable CriticalSection lock;
+
+    /** Cached tracks, least recently used first */
+    ReferenceCountedArray<DecodedTrack> tracks;
+
+    int64 budgetBytes = (int64) 1 << 30;
+    int64 bytesInUse = 0;
+    int hits = 0;
+    int misses = 0;
+    int evictions = 0;
+
+    /** Tracks waiting for the decode thread, oldest first, and the readers it opens */
+    std::deque<DecodeJob> decodeQueue;
+    AudioFormatManager formatManager;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DecodedTrackCache)
+};
+
+//==============================================================================
+/*
+    CachedTrackSource plays a DecodedTrack straight out of the shared buffer.
+    Nothing is copied per deck, and reads never wait or allocate, so it can be
+    used on the audio thread.
+
+    A track still being decoded can be given a fallback that streams the same
+    file. Any block the decode has not reached yet is read from the fallback,
+    so playback starts, and seeks anywhere, without waiting for the decode.
+*/
+class CachedTrackSource : public PositionableAudioSource
+{
+public:
+    /**
+     * Constructor for CachedTrackSource.
+     * @param _track A decoded track, complete or still decoding.
+     * @param _fallback Streams the same audio until the decode has caught up (not owned), or nullptr.
+     */
+    CachedTrackSource(DecodedTrack::Ptr _track, PositionableAudioSource* _fallback = nullptr);
+
+    /** Returns the track being played. */
+    const DecodedTrack& getTrack() const;
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
+
+    void setNextReadPosition(int64 newPosition) override;
+    int64 getNextReadPosition() const override;
+    int64 getTotalLength() const override;
+    bool isLooping() const override;
+
+private:
+    DecodedTrack::Ptr track;
+    PositionableAudioSource* fallback;
+    std::atomic<int64> position{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CachedTrackSource)
+};
@@ -0,0 +1,206 @@
+/*
+==============================================================================
+KeyDetector.cpp
+Created: 23 Oct 2026 9:47:20am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "KeyDetector.h"
+
+namespace
+{
+    /** The rate the audio is decimated towards before the FFT */
+    constexpr double targetRate = 11025.0;
+
+    /** Anti-alias cutoff before decimation; nothing above it matters for pitch */
+    constexpr double antiAliasHz = 2500.0;
+
+    /** The range of the spectrum folded onto pitch classes, C2 to C7 */
+    constexpr double lowestHz = 65.4;
+    constexpr double highestHz = 2093.0;
+
+    /** Frames quieter than this, in summed magnitude per bin, are treated as silence */
+    constexpr float silenceThreshold = 0.01f;
+
+    /** Krumhansl-Kessler key profiles, from the tonic up */
+    constexpr double majorProfile[12] = { 6.35, 2.23, 3.48, 2.33, 4.38, 4.09, 2.52, 5.19, 2.39, 3.66, 2.29, 2.88 };
+    constexpr double minorProfile[12] = { 6.33, 2.68, 3.52, 5.38, 2.60, 3.53, 2.54, 4.75, 3.98, 2.69, 3.34, 3.17 };
+
+    /** Pearson correlation of the chroma with a profile rotated to the given tonic */
+    double correlate(const std::array<double, 12>& chroma, const double* profile, int tonic)
+    {
+        double chromaMean = 0.0, profileMean = 0.0;
+
+        for (int i = 0; i < 12; ++i)
+        {
+            chromaMean += chroma[(size_t) i];
+            profileMean += profile[i];
+        }
+
+        chromaMean /= 12.0;
+        profileMean /= 12.0;
+
+        double product = 0.0, chromaSquares = 0.0, profileSquares = 0.0;
+
+        for (int i = 0; i < 12; ++i)
+        {
+            const double c = chroma[(size_t) ((tonic + i) % 12)] - chromaMean;
+            const double p = profile[i] - profileMean;
+            product += c * p;
+            chromaSquares += c * c;
+            profileSquares += p * p;
+        }
+
+        return chromaSquares > 0.0 ? product / std::sqrt(chromaSquares * profileSquares) : 0.0;
+    }
+}
+
+//==============================================================================
+// Constructor: Decimate to around 11 kHz, and work out which pitch class each
+// FFT bin in the range belongs to
+KeyDetector::KeyDetector(double sampleRate)
+    : decimation(jmax(1, (int) (sampleRate / targetRate))),
+      analysisRate(sampleRate / decimation),
+      window((size_t) fftSize),
+      frame((size_t) fftSize),
+      spectrum((size_t) fftSize * 2)
+{
+    for (auto& filter : antiAlias)
+        filter.setup(sampleRate, antiAliasHz);
+
+    for (int i = 0; i < fftSize; ++i)
+        window[(size_t) i] = 0.5f - 0.5f * std::cos(MathConstants<float>::twoPi * (float) i / (float) fftSize);
+
+    const double binHz = analysisRate / fftSize;
+    lowestBin = (int) std::ceil(lowestHz / binHz);
+    const int highestBin = jmin(fftSize / 2 - 1, (int) std::floor(highestHz / binHz));
+
+    for (int bin = lowestBin; bin <= highestBin; ++bin)
+    {
+        const double midiNote = 69.0 + 12.0 * std::log2(bin * binHz / 440.0);
+        binPitchClass.push_back(((int) std::lround(midiNote)) % 12);
+    }
+}
+
+void KeyDetector::reset()
+{
+    for (auto& filter : antiAlias)
+        filter.x1 = filter.x2 = filter.y1 = filter.y2 = 0.0f;
+
+    decimationPhase = 0;
+    samplesInFrame = 0;
+    chroma.fill(0.0);
+}
+
+const std::array<double, 12>& KeyDetector::getChroma() const
+{
+    return chroma;
+}
+
+size_t KeyDetector::getMemoryUsage() const
+{
+    return sizeof(*this)
+         + (window.capacity() + frame.capacity() + spectrum.capacity()) * sizeof(float)
+         + binPitchClass.capacity() * sizeof(int)
+         + (size_t) fftSize * 2 * sizeof(float);  // The FFT's own tables, roughly
+}
+
+//==============================================================================
+void KeyDetector::process(const float* samples, int numSamples)
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float x = antiAlias[1].process(antiAlias[0].process(samples[i]));
+
+        if (++decimationPhase < decimation)
+            continue;
+
+        decimationPhase = 0;
+        frame[(size_t) samplesInFrame] = x;
+
+        if (++samplesInFrame == fftSize)
+            finishFrame();
+    }
+}
+
+// Window the frame, fold its magnitudes onto the pitch classes, and keep the
+// second half as the start of the next frame
+void KeyDetector::finishFrame()
+{
+    FloatVectorOperations::multiply(spectrum.data(), frame.data(), window.data(), fftSize);
+    fft.performFrequencyOnlyForwardTransform(spectrum.data(), true);
+
+    std::array<double, 12> frameChroma{};
+    double total = 0.0;
+
+    for (size_t i = 0; i < binPitchClass.size(); ++i)
+    {
+        const double magnitude = spectrum[(size_t) lowestBin + i];
+        frameChroma[(size_t) binPitchClass[i]] += magnitude;
+        total += magnitude;
+    }
+
+    if (total > silenceThreshold * (double) binPitchClass.size())
+    {
+        for (size_t pc = 0; pc < 12; ++pc)
+            chroma[pc] += frameChroma[pc] / total;
+    }
+
+    FloatVectorOperations::copy(frame.data(), frame.data() + hopSize, fftSize - hopSize);
+    samplesInFrame = fftSize - hopSize;
+}
+
+//==============================================================================
+bool KeyDetector::analyse(Result& result) const
+{
+    double bestScore = -1.0;
+
+    for (int tonic = 0; tonic < 12; ++tonic)
+    {
+        for (int minor = 0; minor < 2; ++minor)
+        {
+            const double score = correlate(chroma, minor != 0 ? minorProfile : majorProfile, tonic);
+
+            if (score > bestScore)
+            {
+                bestScore = score;
+                result.key = tonic + 12 * minor;
+            }
+        }
+    }
+
+    if (bestScore <= 0.0)
+    {
+        result = Result();
+        return false;
+    }
+
+    result.confidence = (float) bestScore;
+    return true;
+}
+
+//==============================================================================
+// RBJ low-pass, Butterworth Q
+void KeyDetector::LowPass::setup(double sampleRate, double cutoff)
+{
+    const double w = MathConstants<double>::twoPi * jmin(cutoff, sampleRate * 0.45) / sampleRate;
+    const double alpha = std::sin(w) / MathConstants<double>::sqrt2;  // sin(w) / 2Q
+    const double a0 = 1.0 + alpha;
+
+    b0 = (float) ((1.0 - std::cos(w)) / 2.0 / a0);
+    b1 = (float) ((1.0 - std::cos(w)) / a0);
+    b2 = b0;
+    a1 = (float) (-2.0 * std::cos(w) / a0);
+    a2 = (float) ((1.0 - alpha) / a0);
+}
+
+float KeyDetector::LowPass::process(float x)
+{
+    const float y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+    x2 = x1;
+    x1 = x;
+    y2 = y1;
+    y1 = y;
+    return y;
+}
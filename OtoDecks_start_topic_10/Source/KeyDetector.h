@@ -0,0 +1,111 @@
+/*
+==============================================================================
+KeyDetector.h
+Created: 23 Oct 2026 9:47:20am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <array>
+#include <vector>
+
+//==============================================================================
+/*
+    KeyDetector estimates a track's musical key from its audio.
+
+    Mono audio is fed in any block size. It is low-passed and decimated to
+    about 11 kHz, then cut into half-overlapping Hann-windowed frames of 4096
+    samples, whose FFT magnitudes from C2 to C7 are folded onto the twelve
+    pitch classes. Each frame's chroma is normalised before it is added to
+    the track's, so quiet breakdowns count as much as loud drops and silence
+    counts for nothing. analyse() correlates the track's chroma with the
+    Krumhansl-Kessler major and minor profiles in all twelve keys and picks
+    the best fit.
+
+    Memory use is fixed, a few tens of kilobytes, however long the track is.
+*/
+class KeyDetector
+{
+public:
+    /** The result of an analysis */
+    struct Result
+    {
+        /** 0 to 11 for C major to B major, 12 to 23 for C minor to B minor */
+        int key = -1;
+
+        /** How well the chroma fits the key's profile, from 0 to 1 */
+        float confidence = 0.0f;
+    };
+
+    /**
+     * Constructor for KeyDetector.
+     * @param sampleRate The rate of the audio to be fed in.
+     */
+    KeyDetector(double sampleRate);
+
+    /** Clears the chroma, to start on another track at the same sample rate. */
+    void reset();
+
+    /**
+     * Feeds the next block of mono audio.
+     * @param samples The audio.
+     * @param numSamples The number of samples.
+     */
+    void process(const float* samples, int numSamples);
+
+    /**
+     * Estimates the key from everything fed since the last reset.
+     * @param result Receives the key.
+     * @return False if there was no pitched audio to go on.
+     */
+    bool analyse(Result& result) const;
+
+    /** Returns the chroma built so far, starting from C. */
+    const std::array<double, 12>& getChroma() const;
+
+    /** Returns the number of bytes the detector holds. */
+    size_t getMemoryUsage() const;
+
+private:
+    /** Folds the spectrum of the frame just completed into the chroma */
+    void finishFrame();
+
+    /** A low-pass biquad, direct form I, for the anti-alias filter before decimation */
+    struct LowPass
+    {
+        void setup(double sampleRate, double cutoff);
+        float process(float x);
+
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+        float x1 = 0.0f, x2 = 0.0f, y1 = 0.0f, y2 = 0.0f;
+    };
+
+    static constexpr int fftOrder = 12;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int hopSize = fftSize / 2;
+
+    const int decimation;
+    const double analysisRate;
+
+    std::array<LowPass, 2> antiAlias;
+    int decimationPhase = 0;
+
+    dsp::FFT fft{fftOrder};
+    std::vector<float> window;
+
+    /** Decimated samples waiting for the next frame, and the FFT's working buffer */
+    std::vector<float> frame;
+    int samplesInFrame = 0;
+    std::vector<float> spectrum;
+
+    /** The pitch class of each FFT bin from the lowest to the highest used */
+    int lowestBin = 0;
+    std::vector<int> binPitchClass;
+
+    std::array<double, 12> chroma{};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(KeyDetector)
+};
@@ -0,0 +1,215 @@
+/*
+==============================================================================
+LoopingAudioSource.cpp
+Created: 17 Oct 2026 9:41:10am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "LoopingAudioSource.h"
+
+//==============================================================================
+// Constructor: Wraps the given source, the loop starts out disabled
+LoopingAudioSource::LoopingAudioSource(PositionableAudioSource* source)
+    : input(source)
+{
+}
+
+LoopingAudioSource::~LoopingAudioSource()
+{
+}
+
+//==============================================================================
+// Swap the wrapped source and forget any loop that referred to the old one
+void LoopingAudioSource::setSource(PositionableAudioSource* newSource)
+{
+    input = newSource;
+    loopEnabled = false;
+    loopStart = 0;
+    loopEnd = 0;
+    crossfadeSamples = 0;
+    crossfadePosition = 0;
+}
+
+//==============================================================================
+// Loop point setters and getters, safe to call from any thread
+void LoopingAudioSource::setLoopPoints(int64 startSample, int64 endSample)
+{
+    loopStart = jmax((int64) 0, startSample);
+    loopEnd = jmax((int64) 0, endSample);
+}
+
+void LoopingAudioSource::setLoopStart(int64 startSample)
+{
+    loopStart = jmax((int64) 0, startSample);
+}
+
+void LoopingAudioSource::setLoopEnd(int64 endSample)
+{
+    loopEnd = jmax((int64) 0, endSample);
+}
+
+int64 LoopingAudioSource::getLoopStart() const
+{
+    return loopStart.load();
+}
+
+int64 LoopingAudioSource::getLoopEnd() const
+{
+    return loopEnd.load();
+}
+
+void LoopingAudioSource::setLoopEnabled(bool shouldLoop)
+{
+    loopEnabled = shouldLoop;
+}
+
+bool LoopingAudioSource::isLoopEnabled() const
+{
+    return loopEnabled.load();
+}
+
+void LoopingAudioSource::setCrossfadeLength(int numSamples)
+{
+    crossfadeLength = jlimit(0, maxCrossfadeSamples, numSamples);
+}
+
+//==============================================================================
+// Allocate everything the seam crossfade needs up front so the audio thread never allocates
+void LoopingAudioSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    tailBuffer.setSize(2, maxCrossfadeSamples);
+    tailBuffer.clear();
+
+    fadeTable.malloc(maxCrossfadeSamples);
+    for (int i = 0; i < maxCrossfadeSamples; ++i)
+    {
+        auto proportion = (double) i / (double) (maxCrossfadeSamples - 1);
+        fadeTable[i] = (float) (0.5 - 0.5 * std::cos(MathConstants<double>::pi * proportion));
+    }
+
+    crossfadeSamples = 0;
+    crossfadePosition = 0;
+
+    if (input != nullptr)
+        input->prepareToPlay(samplesPerBlockExpected, sampleRate);
+}
+
+void LoopingAudioSource::releaseResources()
+{
+    if (input != nullptr)
+        input->releaseResources();
+}
+
+//==============================================================================
+// Render the block in segments that never cross the loop end. Whenever the read
+// position reaches the loop end the source jumps back to the loop start and the
+// rest of the block is rendered from there, within this same callback.
+void LoopingAudioSource::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill)
+{
+    if (input == nullptr)
+    {
+        bufferToFill.clearActiveBufferRegion();
+        return;
+    }
+
+    int offset = bufferToFill.startSample;
+    int remaining = bufferToFill.numSamples;
+
+    while (remaining > 0)
+    {
+        const int64 start = loopStart.load();
+        const int64 end = loopEnd.load();
+        const bool looping = loopEnabled.load() && end > start;
+        const int64 position = input->getNextReadPosition();
+
+        if (looping && position >= end)
+        {
+            wrapToLoopStart(start, end);
+            continue;
+        }
+
+        int numThisTime = remaining;
+        if (looping)
+            numThisTime = (int) jmin((int64) remaining, end - position);
+
+        AudioSourceChannelInfo region(bufferToFill.buffer, offset, numThisTime);
+        input->getNextAudioBlock(region);
+
+        if (crossfadePosition < crossfadeSamples)
+            applyCrossfade(region);
+
+        offset += numThisTime;
+        remaining -= numThisTime;
+    }
+}
+
+//==============================================================================
+// Capture what would have played after the loop end so it can be faded out
+// underneath the loop start, then jump back. The crossfade is kept to at most
+// half the loop so it always finishes before the next wrap.
+void LoopingAudioSource::wrapToLoopStart(int64 start, int64 end)
+{
+    const int length = (int) jmin((int64) crossfadeLength.load(),
+                                  (int64) tailBuffer.getNumSamples(),
+                                  (end - start) / 2);
+
+    if (length > 0)
+    {
+        AudioSourceChannelInfo tail(&tailBuffer, 0, length);
+        input->getNextAudioBlock(tail);
+    }
+
+    input->setNextReadPosition(start);
+    crossfadePosition = 0;
+    crossfadeSamples = jmax(0, length);
+}
+
+//==============================================================================
+// Blend the tail (fading out) with the freshly rendered loop start (fading in)
+void LoopingAudioSource::applyCrossfade(const AudioSourceChannelInfo& region)
+{
+    const int numSamples = jmin(region.numSamples, crossfadeSamples - crossfadePosition);
+    const int numChannels = jmin(region.buffer->getNumChannels(), tailBuffer.getNumChannels());
+    const int tableScale = jmax(1, crossfadeSamples - 1);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* dest = region.buffer->getWritePointer(channel, region.startSample);
+        auto* tail = tailBuffer.getReadPointer(channel, crossfadePosition);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto fadeIn = fadeTable[((crossfadePosition + i) * (maxCrossfadeSamples - 1)) / tableScale];
+            dest[i] = dest[i] * fadeIn + tail[i] * (1.0f - fadeIn);
+        }
+    }
+
+    crossfadePosition += numSamples;
+}
+
+//==============================================================================
+// PositionableAudioSource interface, forwarded to the wrapped source
+void LoopingAudioSource::setNextReadPosition(int64 newPosition)
+{
+    crossfadeSamples = 0;
+    crossfadePosition = 0;
+
+    if (input != nullptr)
+        input->setNextReadPosition(newPosition);
+}
+
+int64 LoopingAudioSource::getNextReadPosition() const
+{
+    return input != nullptr ? input->getNextReadPosition() : 0;
+}
+
+int64 LoopingAudioSource::getTotalLength() const
+{
+    return input != nullptr ? input->getTotalLength() : 0;
+}
+
+bool LoopingAudioSource::isLooping() const
+{
+    return loopEnabled.load() && loopEnd.load() > loopStart.load();
+}
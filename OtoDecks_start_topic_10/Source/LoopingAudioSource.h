@@ -0,0 +1,130 @@
+/*
+==============================================================================
+LoopingAudioSource.h
+Created: 17 Oct 2026 9:41:10am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <atomic>
+
+//==============================================================================
+/*
+    LoopingAudioSource wraps a PositionableAudioSource and implements a
+    sample-accurate loop. Each render block is split at the exact loop-end
+    sample and the remainder is read from the loop start within the same
+    callback. A short raised-cosine crossfade between the audio that would
+    have followed the loop end and the loop start hides the seam.
+
+    Loop points are stored as atomic sample positions (in the wrapped
+    source's sample rate) so they can be published from any thread and are
+    only ever acted on by the audio thread.
+*/
+class LoopingAudioSource : public PositionableAudioSource
+{
+public:
+    /**
+     * Constructor for LoopingAudioSource.
+     * @param source The source to read from (not owned), may be nullptr.
+     */
+    explicit LoopingAudioSource(PositionableAudioSource* source = nullptr);
+
+    /** Destructor */
+    ~LoopingAudioSource() override;
+
+    /**
+     * Changes the wrapped source. Must not be called while the audio thread
+     * is rendering this source. Any loop in progress is cleared.
+     * @param newSource The new source to read from (not owned), may be nullptr.
+     */
+    void setSource(PositionableAudioSource* newSource);
+
+    //==============================================================================
+    /**
+     * Sets both loop points at once.
+     * @param startSample Loop start in source samples.
+     * @param endSample Loop end in source samples (exclusive).
+     */
+    void setLoopPoints(int64 startSample, int64 endSample);
+
+    /** Sets the loop start in source samples. */
+    void setLoopStart(int64 startSample);
+
+    /** Sets the loop end in source samples (exclusive). */
+    void setLoopEnd(int64 endSample);
+
+    /** Returns the loop start in source samples. */
+    int64 getLoopStart() const;
+
+    /** Returns the loop end in source samples. */
+    int64 getLoopEnd() const;
+
+    /**
+     * Enables or disables the loop.
+     * @param shouldLoop True to loop between the loop points.
+     */
+    void setLoopEnabled(bool shouldLoop);
+
+    /** Returns true if the loop is enabled. */
+    bool isLoopEnabled() const;
+
+    /**
+     * Sets the length of the crossfade applied at the loop seam.
+     * @param numSamples Crossfade length in source samples, clamped to maxCrossfadeSamples.
+     */
+    void setCrossfadeLength(int numSamples);
+
+    /** Upper bound for the seam crossfade, used to size the preallocated buffers. */
+    static constexpr int maxCrossfadeSamples = 2048;
+
+    //==============================================================================
+    /** Prepares the wrapped source and preallocates the crossfade buffers. */
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+
+    /** Releases the wrapped source's resources. */
+    void releaseResources() override;
+
+    /**
+     * Renders the next block, splitting it at the loop end and wrapping to
+     * the loop start as many times as needed.
+     * @param bufferToFill The buffer region to fill.
+     */
+    void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
+
+    //==============================================================================
+    void setNextReadPosition(int64 newPosition) override;
+    int64 getNextReadPosition() const override;
+    int64 getTotalLength() const override;
+    bool isLooping() const override;
+
+private:
+    /** Reads the continuation after the loop end into the tail buffer and jumps to the loop start. */
+    void wrapToLoopStart(int64 start, int64 end);
+
+    /** Mixes the pending crossfade tail into the region that was just rendered. */
+    void applyCrossfade(const AudioSourceChannelInfo& region);
+
+    /** The wrapped source (not owned) */
+    PositionableAudioSource* input = nullptr;
+
+    /** Loop points in source samples and the enabled flag, published to the audio thread */
+    std::atomic<int64> loopStart{0};
+    std::atomic<int64> loopEnd{0};
+    std::atomic<bool> loopEnabled{false};
+    std::atomic<int> crossfadeLength{256};
+
+    /** Holds the audio that followed the loop end, faded out over the crossfade */
+    AudioBuffer<float> tailBuffer;
+
+    /** Precomputed fade-in curve for the seam (the tail fades out as its complement) */
+    HeapBlock<float> fadeTable;
+
+    /** Crossfade progress: samples of the tail already mixed, and the tail length */
+    int crossfadePosition = 0;
+    int crossfadeSamples = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoopingAudioSource)
+};
@@ -0,0 +1,233 @@
+/*
+==============================================================================
+LoudnessMeter.cpp
+Created: 23 Oct 2026 2:38:51pm
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "LoudnessMeter.h"
+
+namespace
+{
+    /** Gating blocks are four 100 ms steps long, so successive blocks overlap by 75% */
+    constexpr double stepSeconds = 0.1;
+    constexpr int stepsPerBlock = 4;
+
+    /** The absolute gate, and how far below the ungated loudness the relative gate sits */
+    constexpr double absoluteGateLufs = -70.0;
+    constexpr double relativeGateLu = 10.0;
+
+    /** Samples above -60 dBFS count as audible */
+    constexpr float audibleLevel = 0.001f;
+
+    /** Loudness of a mean square, per BS.1770 */
+    double toLufs(double meanSquare)
+    {
+        return meanSquare > 0.0 ? -0.691 + 10.0 * std::log10(meanSquare) : -std::numeric_limits<double>::infinity();
+    }
+}
+
+//==============================================================================
+// Constructor: K-weighting coefficients for this sample rate, from the analogue
+// prototypes behind the 48 kHz coefficients in BS.1770, and a windowed-sinc
+// interpolator split into its four phases
+LoudnessMeter::LoudnessMeter(double sampleRate)
+    : stepSize(jmax(1, roundToInt(sampleRate * stepSeconds)))
+{
+    // High shelf of about +4 dB above 1.5 kHz, modelling the head
+    {
+        const double f0 = 1681.974450955533, gain = 3.999843853973347, q = 0.7071752369554196;
+        const double k = std::tan(MathConstants<double>::pi * f0 / sampleRate);
+        const double vh = std::pow(10.0, gain / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+
+        for (auto& filter : preFilter)
+        {
+            filter.b0 = (vh + vb * k / q + k * k) / a0;
+            filter.b1 = 2.0 * (k * k - vh) / a0;
+            filter.b2 = (vh - vb * k / q + k * k) / a0;
+            filter.a1 = 2.0 * (k * k - 1.0) / a0;
+            filter.a2 = (1.0 - k / q + k * k) / a0;
+        }
+    }
+
+    // RLB high-pass around 38 Hz
+    {
+        const double f0 = 38.13547087602444, q = 0.5003270373238773;
+        const double k = std::tan(MathConstants<double>::pi * f0 / sampleRate);
+        const double a0 = 1.0 + k / q + k * k;
+
+        for (auto& filter : highPass)
+        {
+            filter.b0 = 1.0;
+            filter.b1 = -2.0;
+            filter.b2 = 1.0;
+            filter.a1 = 2.0 * (k * k - 1.0) / a0;
+            filter.a2 = (1.0 - k / q + k * k) / a0;
+        }
+    }
+
+    // Blackman-windowed sinc at a quarter of the oversampled rate; each phase
+    // is scaled to unity gain at DC
+    constexpr int numTaps = oversampling * tapsPerPhase;
+    const double centre = (numTaps - 1) / 2.0;
+
+    for (int phase = 0; phase < oversampling; ++phase)
+    {
+        double sum = 0.0;
+
+        for (int tap = 0; tap < tapsPerPhase; ++tap)
+        {
+            const int i = tap * oversampling + phase;
+            const double t = (i - centre) / oversampling;
+            const double sinc = t == 0.0 ? 1.0 : std::sin(MathConstants<double>::pi * t) / (MathConstants<double>::pi * t);
+            const double window = 0.42 - 0.5 * std::cos(MathConstants<double>::twoPi * i / (numTaps - 1))
+                                + 0.08 * std::cos(2.0 * MathConstants<double>::twoPi * i / (numTaps - 1));
+
+            interpolator[(size_t) phase][(size_t) tap] = (float) (sinc * window);
+            sum += sinc * window;
+        }
+
+        for (auto& coefficient : interpolator[(size_t) phase])
+            coefficient = (float) (coefficient / sum);
+    }
+}
+
+void LoudnessMeter::reset()
+{
+    for (auto* filters : { &preFilter, &highPass })
+        for (auto& filter : *filters)
+            filter.x1 = filter.x2 = filter.y1 = filter.y2 = 0.0;
+
+    stepEnergy = 0.0;
+    samplesInStep = 0;
+    stepPowers.clear();
+
+    for (auto& channel : history)
+        channel.fill(0.0f);
+
+    peak = 0.0f;
+    samplesFed = 0;
+    firstAudible = lastAudible = -1;
+}
+
+size_t LoudnessMeter::getMemoryUsage() const
+{
+    return sizeof(*this) + stepPowers.capacity() * sizeof(float);
+}
+
+//==============================================================================
+double LoudnessMeter::Biquad::process(double x)
+{
+    const double y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+    x2 = x1;
+    x1 = x;
+    y2 = y1;
+    y1 = y;
+    return y;
+}
+
+void LoudnessMeter::process(const float* const* channels, int numChannels, int numSamples)
+{
+    numChannels = jmin(numChannels, maxChannels);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        bool audible = false;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const float x = channels[channel][i];
+            const double weighted = highPass[(size_t) channel].process(preFilter[(size_t) channel].process(x));
+            stepEnergy += weighted * weighted;
+
+            // Shift the sample into the history and interpolate between it and the one before
+            auto& recent = history[(size_t) channel];
+            std::memmove(recent.data() + 1, recent.data(), (tapsPerPhase - 1) * sizeof(float));
+            recent[0] = x;
+
+            for (const auto& phase : interpolator)
+            {
+                float y = 0.0f;
+
+                for (int tap = 0; tap < tapsPerPhase; ++tap)
+                    y += phase[(size_t) tap] * recent[(size_t) tap];
+
+                peak = jmax(peak, std::abs(y));
+            }
+
+            peak = jmax(peak, std::abs(x));
+            audible = audible || std::abs(x) > audibleLevel;
+        }
+
+        if (audible)
+        {
+            if (firstAudible < 0)
+                firstAudible = samplesFed;
+
+            lastAudible = samplesFed;
+        }
+
+        ++samplesFed;
+
+        if (++samplesInStep == stepSize)
+            finishStep();
+    }
+}
+
+void LoudnessMeter::finishStep()
+{
+    stepPowers.push_back((float) (stepEnergy / stepSize));
+    stepEnergy = 0.0;
+    samplesInStep = 0;
+}
+
+//==============================================================================
+// Gate the 400 ms blocks twice: first against silence, then against the
+// ungated level, so quiet passages do not drag the result down
+bool LoudnessMeter::analyse(Result& result) const
+{
+    result.truePeakDb = Decibels::gainToDecibels((double) peak, -200.0);
+    result.firstAudibleSample = jmax((int64) 0, firstAudible);
+    result.lastAudibleSample = jmax((int64) 0, lastAudible);
+
+    const int numBlocks = (int) stepPowers.size() - stepsPerBlock + 1;
+    std::vector<double> blockPowers;
+
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        double sum = 0.0;
+
+        for (int step = 0; step < stepsPerBlock; ++step)
+            sum += stepPowers[(size_t) (block + step)];
+
+        if (toLufs(sum / stepsPerBlock) > absoluteGateLufs)
+            blockPowers.push_back(sum / stepsPerBlock);
+    }
+
+    if (blockPowers.empty())
+        return false;
+
+    double ungated = 0.0;
+
+    for (const double power : blockPowers)
+        ungated += power;
+
+    const double relativeGate = toLufs(ungated / (double) blockPowers.size()) - relativeGateLu;
+    double gated = 0.0;
+    int numGated = 0;
+
+    for (const double power : blockPowers)
+    {
+        if (toLufs(power) > relativeGate)
+        {
+            gated += power;
+            ++numGated;
+        }
+    }
+
+    result.integratedLufs = toLufs(gated / jmax(1, numGated));
+    return true;
+}
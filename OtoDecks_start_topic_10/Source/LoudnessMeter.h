@@ -0,0 +1,116 @@
+/*
+==============================================================================
+LoudnessMeter.h
+Created: 23 Oct 2026 2:38:51pm
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <array>
+#include <vector>
+
+//==============================================================================
+/*
+    LoudnessMeter measures a whole track's loudness the way EBU R128 does,
+    along with its true peak and where its audible part starts and ends.
+
+    Audio of one or two channels is fed in any block size. Each channel is
+    K-weighted (the ITU-R BS.1770 pre-filter and RLB high-pass, with
+    coefficients worked out for the sample rate) and its mean square kept
+    for every 100 ms. analyse() combines these into the overlapping 400 ms
+    gating blocks and applies the absolute gate at -70 LUFS and the relative
+    gate 10 LU below the ungated level, giving the integrated loudness.
+
+    The true peak is the largest sample of the signal oversampled four times
+    through a 48-tap polyphase interpolator, as BS.1770 describes. The first
+    and last audible samples are the first and last above -60 dBFS.
+
+    Memory grows by one value per 100 ms, so even a long mix needs very little.
+*/
+class LoudnessMeter
+{
+public:
+    /** The result of a measurement */
+    struct Result
+    {
+        /** Integrated loudness in LUFS */
+        double integratedLufs = 0.0;
+
+        /** True peak in dB relative to full scale */
+        double truePeakDb = 0.0;
+
+        /** The first and last samples above the audibility threshold */
+        int64 firstAudibleSample = 0;
+        int64 lastAudibleSample = 0;
+    };
+
+    /**
+     * Constructor for LoudnessMeter.
+     * @param sampleRate The rate of the audio to be fed in.
+     */
+    LoudnessMeter(double sampleRate);
+
+    /** Clears everything measured, to start on another track at the same sample rate. */
+    void reset();
+
+    /**
+     * Feeds the next block of audio.
+     * @param channels The channels' samples.
+     * @param numChannels One or two; any more are ignored.
+     * @param numSamples The number of samples in each channel.
+     */
+    void process(const float* const* channels, int numChannels, int numSamples);
+
+    /**
+     * Works out the loudness of everything fed since the last reset.
+     * @param result Receives the loudness, peak and audible range.
+     * @return False if nothing was loud enough to pass the absolute gate.
+     */
+    bool analyse(Result& result) const;
+
+    /** Returns the number of bytes the meter holds, which grows with the track. */
+    size_t getMemoryUsage() const;
+
+private:
+    /** A biquad in direct form I, in double precision so the long integration stays exact */
+    struct Biquad
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+        double x1 = 0.0, x2 = 0.0, y1 = 0.0, y2 = 0.0;
+
+        double process(double x);
+    };
+
+    /** Finishes the 100 ms step in progress */
+    void finishStep();
+
+    static constexpr int maxChannels = 2;
+    static constexpr int oversampling = 4;
+    static constexpr int tapsPerPhase = 12;
+
+    const int stepSize;
+
+    /** K-weighting per channel: the pre-filter, then the RLB high-pass */
+    std::array<Biquad, maxChannels> preFilter;
+    std::array<Biquad, maxChannels> highPass;
+
+    /** Sum of the channels' weighted squares in the step in progress, and the mean square of every step so far */
+    double stepEnergy = 0.0;
+    int samplesInStep = 0;
+    std::vector<float> stepPowers;
+
+    /** Interpolator coefficients by phase, and the recent samples of each channel, newest first */
+    std::array<std::array<float, tapsPerPhase>, oversampling> interpolator{};
+    std::array<std::array<float, tapsPerPhase>, maxChannels> history{};
+    float peak = 0.0f;
+
+    /** Samples fed so far, and the audible range found */
+    int64 samplesFed = 0;
+    int64 firstAudible = -1;
+    int64 lastAudible = -1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoudnessMeter)
+};
@@ -1,147 +1,313 @@
-/*
-==============================================================================
-    This file was auto-generated!
-==============================================================================
-*/
-
-#include "MainComponent.h"
-
-//==============================================================================
-// Constructor: Initializes the main component of the application, adds 3 decks,
-// playlist, and sets up audio mixing. (PERSONAL CONTRIBUTION: Added third deck, 
-// theme toggle button, and audio mixing setup.)
-MainComponent::MainComponent()
-    : AudioAppComponent(),
-      player1{formatManager},
-      deckGUI1{&player1, formatManager, thumbCache, &playlistComponent},
-      player2{formatManager},
-      deckGUI2{&player2, formatManager, thumbCache, &playlistComponent},
-      player3{formatManager},  // Added third deck (PERSONAL CONTRIBUTION)
-      deckGUI3{&player3, formatManager, thumbCache, &playlistComponent},  // Third deck GUI
-      playlistComponent(&player1)  // Pass player1 to PlaylistComponent
-{
-    // Set the size of the main window
-    setSize(800, 600);
-
-    // Check for audio recording permissions
-    if (RuntimePermissions::isRequired(RuntimePermissions::recordAudio)
-        && !RuntimePermissions::isGranted(RuntimePermissions::recordAudio))
-    {
-        RuntimePermissions::request(RuntimePermissions::recordAudio,
-            [&](bool granted) { if (granted) setAudioChannels(2, 2); });
-    }
-    else
-    {
-        setAudioChannels(0, 2);  // Specify 0 input channels and 2 output channels
-    }
-
-    // Make the decks and playlist component visible
-    addAndMakeVisible(deckGUI1);
-    addAndMakeVisible(deckGUI2);
-    addAndMakeVisible(deckGUI3);  // Add third deck to the GUI (PERSONAL CONTRIBUTION)
-    addAndMakeVisible(playlistComponent);
-
-    // Make the theme toggle button visible and set its click behavior
-    addAndMakeVisible(themeToggleButton);  // (PERSONAL CONTRIBUTION)
-    themeToggleButton.onClick = [this]() { toggleTheme(); };  // Toggle theme on button click
-
-    // Register audio formats and start mixing audio from the three players
-    formatManager.registerBasicFormats();
-    mixerSource.addInputSource(&player1, false);
-    mixerSource.addInputSource(&player2, false);
-    mixerSource.addInputSource(&player3, false);  // Add third player to the mixer (PERSONAL CONTRIBUTION)
-
-    applyTheme();  // Apply the initial theme (default is Light)
-}
-
-MainComponent::~MainComponent()
-{
-    shutdownAudio();  // Shut down the audio system when the component is destroyed
-}
-
-//==============================================================================
-// Toggle between Light and Dark themes (PERSONAL CONTRIBUTION)
-void MainComponent::toggleTheme()
-{
-    currentTheme = (currentTheme == Theme::Light) ? Theme::Dark : Theme::Light;
-    applyTheme();  // Apply the newly selected theme
-}
-
-// Apply the current theme to the component and child components (PERSONAL CONTRIBUTION)
-void MainComponent::applyTheme()
-{
-    if (currentTheme == Theme::Light)
-    {
-        getLookAndFeel().setColour(ResizableWindow::backgroundColourId, juce::Colours::white);
-        getLookAndFeel().setColour(juce::Slider::thumbColourId, juce::Colours::grey);
-        getLookAndFeel().setColour(juce::Slider::trackColourId, juce::Colours::lightgrey);
-        getLookAndFeel().setColour(juce::Label::textColourId, juce::Colours::black);
-    }
-    else
-    {
-        getLookAndFeel().setColour(ResizableWindow::backgroundColourId, juce::Colours::black);
-        getLookAndFeel().setColour(juce::Slider::thumbColourId, juce::Colours::white);
-        getLookAndFeel().setColour(juce::Slider::trackColourId, juce::Colours::darkgrey);
-        getLookAndFeel().setColour(juce::Label::textColourId, juce::Colours::white);
-    }
-    repaint();  // Repaint the component to reflect the new theme
-}
-
-//==============================================================================
-// Prepare the audio players and mixer for playback (called before playback starts)
-void MainComponent::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
-{
-    player1.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    player2.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    player3.prepareToPlay(samplesPerBlockExpected, sampleRate);  // Prepare third deck for playback (PERSONAL CONTRIBUTION)
-
-    mixerSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    mixerSource.removeAllInputs();  // Ensure no duplicate inputs
-    mixerSource.addInputSource(&player1, false);
-    mixerSource.addInputSource(&player2, false);
-    mixerSource.addInputSource(&player3, false);  // Add third player to the mixer (PERSONAL CONTRIBUTION)
-}
-
-//==============================================================================
-// Retrieve the next block of audio data and pass it to the mixer source
-void MainComponent::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill)
-{
-    mixerSource.getNextAudioBlock(bufferToFill);
-}
-
-//==============================================================================
-// Release the audio resources when they are no longer needed
-void MainComponent::releaseResources()
-{
-    player1.releaseResources();
-    player2.releaseResources();
-    player3.releaseResources();  // Release resources for the third player (PERSONAL CONTRIBUTION)
-    mixerSource.releaseResources();
-}
-
-//==============================================================================
-// Paint method to fill the background with the current theme's color
-void MainComponent::paint(Graphics& g)
-{
-    g.fillAll(getLookAndFeel().findColour(ResizableWindow::backgroundColourId));
-}
-
-//==============================================================================
-// Resize and position the components (3 decks, playlist, and theme toggle button)
-void MainComponent::resized()
-{
-    int deckWidth = getWidth() / 3;  // Divide the window width into thirds for the decks
-    int deckHeight = getHeight() / 2;  // Use the top half for the decks
-    int playlistHeight = 150;  // Adjust as needed
-
-    // Set bounds for each deck
-    deckGUI1.setBounds(0, 0, deckWidth, deckHeight);
-    deckGUI2.setBounds(deckWidth, 0, deckWidth, deckHeight);
-    deckGUI3.setBounds(2 * deckWidth, 0, deckWidth, deckHeight);  // Third deck (PERSONAL CONTRIBUTION)
-
-    // Set bounds for the playlist component at the bottom of the window
-    playlistComponent.setBounds(0, getHeight() - playlistHeight, getWidth(), playlistHeight);
-
-    // Set bounds for the theme toggle button (centered horizontally at the bottom)
-    themeToggleButton.setBounds((getWidth() / 2) - 50, getHeight() - 40, 100, 30);  // Theme toggle button (PERSONAL CONTRIBUTION)
-}
+/*
+==============================================================================
+    This file was auto-generated!
+==============================================================================
+*/
+
+#include "MainComponent.h"
+#include "MixRenderer.h"
+
+//==============================================================================
+// Constructor: Initializes the main component of the application, builds the deck
+// pool, playlist, and sets up audio mixing. (PERSONAL CONTRIBUTION: Added third deck, 
+// theme toggle button, and audio mixing setup.)
+MainComponent::MainComponent()
+    : AudioAppComponent(),
+      players(createPlayers(formatManager)),
+      playlistComponent(players[0])  // Pass the first player to PlaylistComponent
+{
+    // Set the size of the main window
+    setSize(800, 600);
+
+    // One GUI per player; only the decks in use are shown
+    for (auto* player : players)
+    {
+        auto* deckGUI = deckGUIs.add(new DeckGUI(player, &playlistComponent));
+        addChildComponent(deckGUI);
+    }
+
+    // Sync buttons: any deck can follow the master, and any deck can become it
+    for (int i = 0; i < deckGUIs.size(); ++i)
+    {
+        deckGUIs[i]->onSyncChanged = [this, i](bool shouldSync) { syncEngine.setSynced(i, shouldSync); };
+        deckGUIs[i]->onMasterClicked = [this, i]()
+        {
+            syncEngine.setMaster(i);
+            for (int d = 0; d < deckGUIs.size(); ++d)
+                deckGUIs[d]->setIsSyncMaster(d == i);
+        };
+    }
+    deckGUIs[syncEngine.getMaster()]->setIsSyncMaster(true);
+
+    addAndMakeVisible(playlistComponent);
+
+    // Make the theme toggle button visible and set its click behavior
+    addAndMakeVisible(themeToggleButton);  // (PERSONAL CONTRIBUTION)
+    themeToggleButton.onClick = [this]() { toggleTheme(); };  // Toggle theme on button click
+
+    // Crossfader between the first two decks
+    addAndMakeVisible(crossfaderSlider);
+    crossfaderSlider.setSliderStyle(Slider::LinearHorizontal);
+    crossfaderSlider.setTextBoxStyle(Slider::NoTextBox, false, 0, 0);
+    crossfaderSlider.setRange(0.0, 1.0);
+    crossfaderSlider.setValue(0.5, dontSendNotification);
+    crossfaderSlider.onValueChange = [this]() { mixer.setCrossfader((float) crossfaderSlider.getValue()); };
+
+    addAndMakeVisible(crossfaderCurveBox);
+    crossfaderCurveBox.addItem("Equal power", 1);
+    crossfaderCurveBox.addItem("Linear", 2);
+    crossfaderCurveBox.addItem("Cut", 3);
+    crossfaderCurveBox.setSelectedId(1, dontSendNotification);
+    crossfaderCurveBox.onChange = [this]()
+    {
+        const int id = crossfaderCurveBox.getSelectedId();
+        mixer.setCrossfaderCurve(id == 2 ? MixerEngine::CrossfaderCurve::linear
+                               : id == 3 ? MixerEngine::CrossfaderCurve::cut
+                                         : MixerEngine::CrossfaderCurve::equalPower);
+    };
+
+    // Deck count, from 1 to maxDecks
+    addAndMakeVisible(deckCountBox);
+    for (int i = 1; i <= maxDecks; ++i)
+        deckCountBox.addItem(String(i) + (i == 1 ? " deck" : " decks"), i);
+    deckCountBox.onChange = [this]() { setNumDecks(deckCountBox.getSelectedId()); };
+
+    // Register audio formats and connect every player in the pool to the mixer.
+    // Decks 1 and 2 sit on either side of the crossfader; the rest bypass it.
+    formatManager.registerBasicFormats();
+    for (int i = 0; i < players.size(); ++i)
+        mixer.setInput(i, players[i]);
+    mixer.setChannelCrossfaderSide(0, MixerEngine::CrossfaderSide::a);
+    mixer.setChannelCrossfaderSide(1, MixerEngine::CrossfaderSide::b);
+    mixer.setTimingMonitor(&timingMonitor);
+
+    addAndMakeVisible(statsPanel);
+    statsPanel.onParallelRenderingChanged = [this](bool shouldRenderInParallel) { mixer.setParallelRendering(shouldRenderInParallel); };
+
+    setNumDecks(numDecks);
+    applyTheme();  // Apply the initial theme (default is Light)
+
+    // Start the audio last, once the mixer has all its inputs
+    if (RuntimePermissions::isRequired(RuntimePermissions::recordAudio)
+        && !RuntimePermissions::isGranted(RuntimePermissions::recordAudio))
+    {
+        RuntimePermissions::request(RuntimePermissions::recordAudio,
+            [&](bool granted) { if (granted) setAudioChannels(2, 2); });
+    }
+    else
+    {
+        setAudioChannels(0, 2);  // Specify 0 input channels and 2 output channels
+    }
+}
+
+OwnedArray<DJAudioPlayer> MainComponent::createPlayers(AudioFormatManager& manager)
+{
+    OwnedArray<DJAudioPlayer> pool;
+
+    for (int i = 0; i < maxDecks; ++i)
+        pool.add(new DJAudioPlayer(manager));
+
+    return pool;
+}
+
+MainComponent::~MainComponent()
+{
+    shutdownAudio();  // Shut down the audio system when the component is destroyed
+    recorder.reset();  // Flushes the end of a recorded mix
+    recordingThread.stopThread(4000);
+}
+
+//==============================================================================
+// Toggle between Light and Dark themes (PERSONAL CONTRIBUTION)
+void MainComponent::toggleTheme()
+{
+    currentTheme = (currentTheme == Theme::Light) ? Theme::Dark : Theme::Light;
+    applyTheme();  // Apply the newly selected theme
+}
+
+// Apply the current theme to the component and child components (PERSONAL CONTRIBUTION)
+void MainComponent::applyTheme()
+{
+    if (currentTheme == Theme::Light)
+    {
+        getLookAndFeel().setColour(ResizableWindow::backgroundColourId, juce::Colours::white);
+        getLookAndFeel().setColour(juce::Slider::thumbColourId, juce::Colours::grey);
+        getLookAndFeel().setColour(juce::Slider::trackColourId, juce::Colours::lightgrey);
+        getLookAndFeel().setColour(juce::Label::textColourId, juce::Colours::black);
+    }
+    else
+    {
+        getLookAndFeel().setColour(ResizableWindow::backgroundColourId, juce::Colours::black);
+        getLookAndFeel().setColour(juce::Slider::thumbColourId, juce::Colours::white);
+        getLookAndFeel().setColour(juce::Slider::trackColourId, juce::Colours::darkgrey);
+        getLookAndFeel().setColour(juce::Label::textColourId, juce::Colours::white);
+    }
+    repaint();  // Repaint the component to reflect the new theme
+}
+
+//==============================================================================
+// Show the decks in use and switch the mixer strips of the others off, so an
+// unused deck is neither drawn nor rendered
+void MainComponent::setNumDecks(int newNumDecks)
+{
+    if (newNumDecks < 1 || newNumDecks > maxDecks)
+    {
+        std::cout << "MainComponent::setNumDecks numDecks should be between 1 and " << maxDecks << std::endl;
+        return;
+    }
+
+    numDecks = newNumDecks;
+
+    for (int i = 0; i < maxDecks; ++i)
+    {
+        const bool inUse = i < numDecks;
+
+        if (! inUse)
+            players[i]->stop();
+
+        mixer.setChannelActive(i, inUse);
+        deckGUIs[i]->setVisible(inUse);
+    }
+
+    statsPanel.setNumDecks(numDecks);
+
+    deckCountBox.setSelectedId(numDecks, dontSendNotification);
+    resized();
+}
+
+int MainComponent::getNumDecks() const
+{
+    return numDecks;
+}
+
+//==============================================================================
+// Everything is loaded before the script is handed to the audio thread, which
+// starts it at the next block
+bool MainComponent::playScript(const File& scriptFile, const File& recordFile)
+{
+    if (playingScript.load() != nullptr || scriptPlayer != nullptr)
+    {
+        std::cout << "MainComponent::playScript a script has already been played" << std::endl;
+        return false;
+    }
+
+    const double sampleRate = deviceSampleRate.load();
+
+    if (sampleRate <= 0.0 || ! script.loadFromFile(scriptFile))
+        return false;
+
+    if (script.getNumDecks() > numDecks)
+        setNumDecks(jmin(maxDecks, script.getNumDecks()));
+
+    auto newPlayer = std::make_unique<MixScriptPlayer>(script, formatManager, players, mixer, syncEngine);
+
+    if (! newPlayer->prepareTracks())
+        return false;
+
+    newPlayer->prepareToPlay(sampleRate);
+
+    if (recordFile != File())
+    {
+        auto writer = MixRenderer::createWriter(recordFile, sampleRate, 0);
+
+        if (writer == nullptr)
+            return false;
+
+        recordingThread.startThread();
+        recorder = std::make_unique<AudioFormatWriter::ThreadedWriter>(writer.release(), recordingThread, 1 << 18);
+    }
+
+    std::cout << "MainComponent::playScript playing " << scriptFile.getFileName() << " at " << sampleRate
+              << " Hz in blocks of " << deviceBlockSize.load() << "; render at the same settings for an identical mix" << std::endl;
+
+    scriptPlayer = std::move(newPlayer);
+    playingScript = scriptPlayer.get();
+    return true;
+}
+
+//==============================================================================
+// Prepare the mixer, which prepares the players connected to it (called before playback starts)
+void MainComponent::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    deviceSampleRate = sampleRate;
+    deviceBlockSize = samplesPerBlockExpected;
+    timingMonitor.prepare(sampleRate);
+    mixer.prepareToPlay(samplesPerBlockExpected, sampleRate);
+}
+
+//==============================================================================
+// Retrieve the next block of audio data from the mixer, once the sync engine has
+// set the synced decks' speeds from where every deck's playhead now is. While a
+// script plays, it drives the decks and mixer instead, and its mix is recorded.
+// Either way the whole callback is timed against its deadline.
+void MainComponent::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill)
+{
+    const RealtimeSafetyChecker::ScopedRealtimeThread realtime;
+    const int64 startTicks = Time::getHighResolutionTicks();
+
+    if (auto* player = playingScript.load())
+    {
+        const int64 remaining = player->getLengthInSamples() - player->getPosition();
+        player->renderNextBlock(bufferToFill);
+
+        if (recorder != nullptr && remaining > 0 && bufferToFill.buffer->getNumChannels() >= 2)
+        {
+            const float* channels[] = { bufferToFill.buffer->getReadPointer(0, bufferToFill.startSample),
+                                        bufferToFill.buffer->getReadPointer(1, bufferToFill.startSample) };
+            recorder->write(channels, (int) jmin((int64) bufferToFill.numSamples, remaining));
+        }
+
+        if (player->isFinished())
+            playingScript = nullptr;  // Back to the decks' own controls from the next block
+    }
+    else {
+        syncEngine.process();
+        mixer.getNextAudioBlock(bufferToFill);
+    }
+
+    timingMonitor.recordCallback(startTicks, bufferToFill.numSamples);
+}
+
+//==============================================================================
+// Release the audio resources when they are no longer needed
+void MainComponent::releaseResources()
+{
+    mixer.releaseResources();
+}
+
+//==============================================================================
+// Paint method to fill the background with the current theme's color
+void MainComponent::paint(Graphics& g)
+{
+    g.fillAll(getLookAndFeel().findColour(ResizableWindow::backgroundColourId));
+}
+
+//==============================================================================
+// Resize and position the components: the decks in a grid of up to four per row
+// across the top half, then the crossfader, playlist, and theme toggle button
+void MainComponent::resized()
+{
+    const int columns = jmin(numDecks, 4);
+    const int rows = (numDecks + columns - 1) / columns;
+    int deckWidth = getWidth() / columns;
+    int deckHeight = getHeight() / 2;  // Use the top half for the decks
+    int playlistHeight = 150;  // Adjust as needed
+
+    // Set bounds for each deck in use
+    for (int i = 0; i < numDecks; ++i)
+        deckGUIs[i]->setBounds((i % columns) * deckWidth, (i / columns) * (deckHeight / rows), deckWidth, deckHeight / rows);
+
+    // Crossfader and its curve selector just below the decks, deck count to the left
+    crossfaderSlider.setBounds((getWidth() / 2) - 150, deckHeight + 5, 300, 30);
+    crossfaderCurveBox.setBounds((getWidth() / 2) + 160, deckHeight + 8, 120, 24);
+    deckCountBox.setBounds((getWidth() / 2) - 280, deckHeight + 8, 120, 24);
+
+    // Audio timings in the space between the crossfader and the playlist
+    statsPanel.setBounds(10, deckHeight + 42, getWidth() - 20, jmax(0, getHeight() - playlistHeight - deckHeight - 50));
+
+    // Set bounds for the playlist component at the bottom of the window
+    playlistComponent.setBounds(0, getHeight() - playlistHeight, getWidth(), playlistHeight);
+
+    // Set bounds for the theme toggle button (centered horizontally at the bottom)
+    themeToggleButton.setBounds((getWidth() / 2) - 50, getHeight() - 40, 100, 30);  // Theme toggle button (PERSONAL CONTRIBUTION)
+}
@@ -0,0 +1,168 @@
+/*
+==============================================================================
+MixRenderer.cpp
+Created: 24 Oct 2026 2:26:08pm
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "MixRenderer.h"
+#include "RealtimeSafetyChecker.h"
+
+//==============================================================================
+// Build the app's graph for as many decks as the script uses, load every
+// track, then pull fixed blocks through it as fast as they can be made. The
+// last block is rendered whole, as a device would ask for it, and trimmed
+// when it is written.
+bool MixRenderer::render(const MixScript& script, const File& outputFile, const Options& options, Result& result)
+{
+    if (options.sampleRate < 8000.0 || options.sampleRate > 384000.0 || options.blockSize < 1 || options.blockSize > 8192)
+    {
+        std::cout << "MixRenderer::render sample rate should be between 8000 and 384000 and block size between 1 and 8192" << std::endl;
+        return false;
+    }
+
+    const double startMs = Time::getMillisecondCounterHiRes();
+
+    AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    OwnedArray<DJAudioPlayer> decks;
+    for (int i = 0; i < jmax(2, script.getNumDecks()); ++i)
+        decks.add(new DJAudioPlayer(formatManager));
+
+    // The script player puts decks 1 and 2 either side of the crossfader
+    MixerEngine mixer(decks.size());
+    for (int i = 0; i < decks.size(); ++i)
+        mixer.setInput(i, decks[i]);
+    mixer.setParallelRendering(options.parallel);
+
+    SyncEngine syncEngine(decks);
+    MixScriptPlayer player(script, formatManager, decks, mixer, syncEngine);
+
+    if (! player.prepareTracks())
+        return false;
+
+    auto writer = createWriter(outputFile, options.sampleRate, options.bitsPerSample);
+    if (writer == nullptr)
+        return false;
+
+    mixer.prepareToPlay(options.blockSize, options.sampleRate);
+    player.prepareToPlay(options.sampleRate);
+
+    AudioBuffer<float> buffer(2, options.blockSize);
+    const int64 length = player.getLengthInSamples();
+    const double renderStartMs = Time::getMillisecondCounterHiRes();
+    int64 engineTicks = 0;
+    bool written = true;
+
+    for (int64 done = 0; done < length && written; done += options.blockSize)
+    {
+        const int64 blockStartTicks = Time::getHighResolutionTicks();
+        {
+            const RealtimeSafetyChecker::ScopedRealtimeThread realtime;  // Held to the live callback's rules
+            player.renderNextBlock(AudioSourceChannelInfo(&buffer, 0, options.blockSize));
+        }
+        engineTicks += Time::getHighResolutionTicks() - blockStartTicks;
+
+        written = writer->writeFromAudioSampleBuffer(buffer, 0, (int) jmin((int64) options.blockSize, length - done));
+    }
+
+    writer.reset();
+    mixer.releaseResources();
+
+    if (! written)
+    {
+        std::cout << "MixRenderer::render could not write " << outputFile.getFullPathName() << std::endl;
+        return false;
+    }
+
+    result.mixSeconds = (double) length / options.sampleRate;
+    result.engineSeconds = Time::highResolutionTicksToSeconds(engineTicks);
+    result.totalSeconds = (Time::getMillisecondCounterHiRes() - renderStartMs) / 1000.0;
+
+    std::cout << "MixRenderer::render " << outputFile.getFileName() << ": " << String(result.mixSeconds, 1) << " s of audio in "
+              << String(result.totalSeconds, 2) << " s, " << String(result.mixSeconds / jmax(0.001, result.totalSeconds), 1)
+              << "x real time (engine alone " << String(result.mixSeconds / jmax(0.001, result.engineSeconds), 1)
+              << "x) at " << options.sampleRate << " Hz in blocks of " << options.blockSize << ", "
+              << String((renderStartMs - startMs) / 1000.0, 2) << " s loading" << std::endl;
+    return true;
+}
+
+//==============================================================================
+std::unique_ptr<AudioFormatWriter> MixRenderer::createWriter(const File& file, double sampleRate, int bitsPerSample)
+{
+    std::unique_ptr<AudioFormat> format;
+
+    if (file.hasFileExtension(".wav"))
+    {
+        format = std::make_unique<WavAudioFormat>();
+        bitsPerSample = bitsPerSample == 0 ? 32 : bitsPerSample;
+    }
+    else if (file.hasFileExtension(".flac"))
+    {
+        format = std::make_unique<FlacAudioFormat>();
+        bitsPerSample = bitsPerSample == 0 ? 24 : bitsPerSample;
+    }
+    else {
+        std::cout << "MixRenderer::createWriter " << file.getFileName() << " should be a .wav or .flac file" << std::endl;
+        return nullptr;
+    }
+
+    if (! format->getPossibleBitDepths().contains(bitsPerSample))
+    {
+        std::cout << "MixRenderer::createWriter " << format->getFormatName() << " cannot be written at "
+                  << bitsPerSample << " bits" << std::endl;
+        return nullptr;
+    }
+
+    file.deleteFile();
+    std::unique_ptr<FileOutputStream> stream(file.createOutputStream());
+
+    if (stream == nullptr)
+    {
+        std::cout << "MixRenderer::createWriter could not open " << file.getFullPathName() << std::endl;
+        return nullptr;
+    }
+
+    std::unique_ptr<AudioFormatWriter> writer(format->createWriterFor(stream.get(), sampleRate, 2,
+                                                                      bitsPerSample, {}, 0));
+    if (writer != nullptr)
+        stream.release();  // The writer owns it now
+
+    return writer;
+}
+
+//==============================================================================
+int MixRenderer::renderFromCommandLine(const StringArray& args)
+{
+    const int index = args.indexOf("--render");
+
+    if (index < 0 || index + 2 >= args.size())
+    {
+        std::cout << "Usage: --render <script> <output.wav|flac> [--rate <Hz>] [--block <samples>] "
+                     "[--bits <16|24|32>] [--parallel]" << std::endl;
+        return 1;
+    }
+
+    const auto option = [&args](const String& name, double fallback)
+    {
+        const int i = args.indexOf(name);
+        return i >= 0 && i + 1 < args.size() ? args[i + 1].getDoubleValue() : fallback;
+    };
+
+    const File cwd = File::getCurrentWorkingDirectory();
+    MixScript script;
+
+    if (! script.loadFromFile(cwd.getChildFile(args[index + 1].unquoted())))
+        return 1;
+
+    Options options;
+    options.sampleRate = option("--rate", options.sampleRate);
+    options.blockSize = (int) option("--block", options.blockSize);
+    options.bitsPerSample = (int) option("--bits", options.bitsPerSample);
+    options.parallel = args.contains("--parallel");
+
+    Result result;
+    return render(script, cwd.getChildFile(args[index + 2].unquoted()), options, result) ? 0 : 1;
+}
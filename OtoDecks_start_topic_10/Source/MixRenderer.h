@@ -0,0 +1,77 @@
+/*
+==============================================================================
+MixRenderer.h
+Created: 24 Oct 2026 2:26:08pm
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "MixScript.h"
+
+//==============================================================================
+/*
+    MixRenderer renders a MixScript to a WAV or FLAC file without an audio
+    device, as fast as the CPU allows.
+
+    It builds the same graph the app plays through: DJAudioPlayers on the
+    strips of a MixerEngine, decks 1 and 2 either side of the crossfader,
+    and a SyncEngine. The script is played through it by a MixScriptPlayer
+    in fixed blocks, exactly as the audio device would pull them, so a
+    render matches a live playback of the script (see MainComponent::playScript)
+    sample for sample when the sample rate and block size are the same.
+    Rendering the decks in parallel changes the speed but not the samples.
+
+    The wall time taken is reported as a real-time factor, both for the
+    engine alone and including the file writing.
+*/
+class MixRenderer
+{
+public:
+    /** How the mix is rendered */
+    struct Options
+    {
+        double sampleRate = 44100.0;
+        int blockSize = 512;
+        int bitsPerSample = 0;      // 0 for the format's default: 32-bit float WAV or 24-bit FLAC
+        bool parallel = false;      // Render the decks on the worker pool
+    };
+
+    /** What a render achieved */
+    struct Result
+    {
+        double mixSeconds = 0.0;        // Length of the mix
+        double engineSeconds = 0.0;     // Wall time spent in the engine
+        double totalSeconds = 0.0;      // Wall time including writing the file
+    };
+
+    /**
+     * Renders a script to a file, replacing it if it exists. Call on the
+     * message thread with no audio device running the same decks.
+     * @param script The mix to render.
+     * @param outputFile A .wav or .flac file.
+     * @param options The sample rate, block size, bit depth and threading.
+     * @param result Receives the timings.
+     * @return False if a track could not be loaded or the file could not be written.
+     */
+    static bool render(const MixScript& script, const File& outputFile, const Options& options, Result& result);
+
+    /**
+     * Opens a stereo WAV or FLAC writer, chosen by the file's extension.
+     * @param file The file to write, replaced if it exists.
+     * @param sampleRate The rate of the audio.
+     * @param bitsPerSample 16, 24, or 32 for float WAV; 0 for the format's default.
+     * @return The writer, or nullptr if the file or bit depth is not supported.
+     */
+    static std::unique_ptr<AudioFormatWriter> createWriter(const File& file, double sampleRate, int bitsPerSample);
+
+    /**
+     * Handles "--render <script> <output> [--rate <Hz>] [--block <samples>]
+     * [--bits <16|24|32>] [--parallel]" from the command line.
+     * @param args The command-line arguments.
+     * @return The process exit code.
+     */
+    static int renderFromCommandLine(const StringArray& args);
+};
@@ -0,0 +1,571 @@
+/*
+==============================================================================
+MixScript.cpp
+Created: 24 Oct 2026 10:12:37am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "MixScript.h"
+#include <algorithm>
+
+namespace
+{
+    /** How long prepareTracks() waits for the analyser before giving up on a track */
+    constexpr double analysisTimeoutSeconds = 600.0;
+
+    /** Reads "90.5" or "1:30.5" as seconds, or returns a negative number */
+    double parseTime(const String& text)
+    {
+        if (text.isEmpty() || ! text.containsOnly("0123456789.:"))
+            return -1.0;
+
+        double seconds = 0.0;
+
+        for (const auto& part : StringArray::fromTokens(text, ":", ""))
+            seconds = seconds * 60.0 + part.getDoubleValue();
+
+        return seconds;
+    }
+
+    bool isNumber(const String& text)
+    {
+        return text.isNotEmpty() && text.containsOnly("-+0123456789.");
+    }
+
+    /** Cuts a comment off a line, leaving any # inside quotes alone */
+    String stripComment(const String& line)
+    {
+        bool quoted = false;
+
+        for (int i = 0; i < line.length(); ++i)
+        {
+            if (line[i] == '"')
+                quoted = ! quoted;
+            else if (line[i] == '#' && ! quoted)
+                return line.substring(0, i);
+        }
+
+        return line;
+    }
+}
+
+//==============================================================================
+bool MixScript::loadFromFile(const File& scriptFile)
+{
+    if (! scriptFile.existsAsFile())
+    {
+        std::cout << "MixScript::loadFromFile " << scriptFile.getFullPathName() << " does not exist" << std::endl;
+        actions.clear();
+        return false;
+    }
+
+    return loadFromText(scriptFile.loadFileAsString(), scriptFile.getParentDirectory());
+}
+
+// Every line is checked before anything is kept, so a script with a mistake
+// in it is never half played
+bool MixScript::loadFromText(const String& text, const File& baseDirectory)
+{
+    std::vector<Action> parsed;
+    const StringArray lines = StringArray::fromLines(text);
+
+    for (int i = 0; i < lines.size(); ++i)
+    {
+        StringArray tokens = StringArray::fromTokens(stripComment(lines[i]), " \t", "\"");
+        tokens.removeEmptyStrings();
+
+        if (tokens.isEmpty())
+            continue;
+
+        for (auto& token : tokens)
+            token = token.unquoted();
+
+        Action action;
+        const String error = parseLine(tokens, baseDirectory, action);
+
+        if (error.isNotEmpty())
+        {
+            std::cout << "MixScript::loadFromText line " << i + 1 << ": " << error << std::endl;
+            actions.clear();
+            return false;
+        }
+
+        parsed.push_back(action);
+    }
+
+    // Stable, so actions at the same time keep the order they were written in
+    std::stable_sort(parsed.begin(), parsed.end(), [](const Action& a, const Action& b) { return a.time < b.time; });
+
+    const auto end = std::find_if(parsed.begin(), parsed.end(), [](const Action& a) { return a.type == Action::Type::end; });
+
+    if (end == parsed.end())
+    {
+        std::cout << "MixScript::loadFromText the script has no end action" << std::endl;
+        actions.clear();
+        return false;
+    }
+
+    // Nothing after the end is ever played
+    parsed.erase(end + 1, parsed.end());
+
+    actions = std::move(parsed);
+    lengthSeconds = actions.back().time;
+    numDecks = 0;
+
+    for (const auto& action : actions)
+        numDecks = jmax(numDecks, action.deck + 1);
+
+    return true;
+}
+
+const std::vector<MixScript::Action>& MixScript::getActions() const
+{
+    return actions;
+}
+
+int MixScript::getNumDecks() const
+{
+    return numDecks;
+}
+
+double MixScript::getLengthSeconds() const
+{
+    return lengthSeconds;
+}
+
+//==============================================================================
+String MixScript::parseLine(const StringArray& tokens, const File& baseDirectory, Action& action)
+{
+    if (tokens.size() < 3)
+        return "expected a time, a deck and an action";
+
+    action.time = parseTime(tokens[0]);
+    if (action.time < 0.0)
+        return "\"" + tokens[0] + "\" is not a time";
+
+    const bool onMixer = tokens[1] == "-";
+    action.deck = onMixer ? -1 : tokens[1].getIntValue() - 1;
+    if (! onMixer && (! tokens[1].containsOnly("0123456789") || action.deck < 0))
+        return "\"" + tokens[1] + "\" is not a deck number or -";
+
+    const String verb = tokens[2].toLowerCase();
+    const StringArray args(tokens.begin() + 3, tokens.size() - 3);
+
+    const auto numberArg = [&args](int index, double low, double high, double& value) -> bool
+    {
+        if (index >= args.size() || ! isNumber(args[index]))
+            return false;
+
+        value = args[index].getDoubleValue();
+        return value >= low && value <= high;
+    };
+
+    const auto switchArg = [&args](double& value) -> bool
+    {
+        value = args[0] == "on" ? 1.0 : 0.0;
+        return args.size() == 1 && (args[0] == "on" || args[0] == "off");
+    };
+
+    const auto bandArg = [&args](int& band) -> bool
+    {
+        band = args[0] == "low" ? (int) DeckEqualiser::Band::low
+             : args[0] == "mid" ? (int) DeckEqualiser::Band::mid
+                                : (int) DeckEqualiser::Band::high;
+        return args.size() == 2 && (args[0] == "low" || args[0] == "mid" || args[0] == "high");
+    };
+
+    // Mixer actions
+    if (verb == "crossfade" || verb == "curve" || verb == "end")
+    {
+        if (! onMixer)
+            return verb + " is a mixer action, so its deck should be -";
+
+        if (verb == "crossfade")
+        {
+            action.type = Action::Type::crossfade;
+            if (! numberArg(0, 0.0, 1.0, action.value))
+                return "crossfade position should be between 0 and 1";
+            if (args.size() > 1 && ! numberArg(1, 0.0, 600.0, action.value2))
+                return "crossfade glide should be between 0 and 600 seconds";
+        }
+        else if (verb == "curve")
+        {
+            action.type = Action::Type::crossfaderCurve;
+            const String curve = args[0].toLowerCase();
+            if (curve != "equalpower" && curve != "linear" && curve != "cut")
+                return "curve should be equalpower, linear or cut";
+            action.band = (int) (curve == "linear" ? MixerEngine::CrossfaderCurve::linear
+                               : curve == "cut" ? MixerEngine::CrossfaderCurve::cut
+                                                : MixerEngine::CrossfaderCurve::equalPower);
+        }
+        else {
+            action.type = Action::Type::end;
+        }
+
+        return {};
+    }
+
+    if (onMixer)
+        return verb + " is a deck action, so it needs a deck number";
+
+    // Deck actions
+    if (verb == "load")
+    {
+        action.type = Action::Type::load;
+        if (args.size() != 1)
+            return "load needs one file, quoted if its path has spaces";
+        action.file = baseDirectory.getChildFile(args[0]);
+        if (! action.file.existsAsFile())
+            return action.file.getFullPathName() + " does not exist";
+    }
+    else if (verb == "play")
+        action.type = Action::Type::play;
+    else if (verb == "stop")
+        action.type = Action::Type::stop;
+    else if (verb == "gain")
+    {
+        action.type = Action::Type::gain;
+        if (! numberArg(0, 0.0, 1.0, action.value))
+            return "gain should be between 0 and 1";
+    }
+    else if (verb == "speed")
+    {
+        action.type = Action::Type::speed;
+        if (! numberArg(0, 0.0, DJAudioPlayer::maxSpeed, action.value))
+            return "speed should be between 0 and " + String(DJAudioPlayer::maxSpeed);
+    }
+    else if (verb == "seek")
+    {
+        action.type = Action::Type::seek;
+        if (! numberArg(0, 0.0, 86400.0, action.value))
+            return "seek needs a position in seconds";
+    }
+    else if (verb == "loop")
+    {
+        if (args.size() == 1 && args[0] == "off")
+        {
+            action.type = Action::Type::loopOff;
+        }
+        else {
+            action.type = Action::Type::loop;
+            if (! numberArg(0, 0.0, 86400.0, action.value) || ! numberArg(1, action.value, 86400.0, action.value2)
+                || action.value2 <= action.value)
+                return "loop needs a start and a later end in seconds, or off";
+        }
+    }
+    else if (verb == "sync")
+    {
+        action.type = Action::Type::sync;
+        if (! switchArg(action.value))
+            return "sync should be on or off";
+    }
+    else if (verb == "master")
+        action.type = Action::Type::master;
+    else if (verb == "keylock")
+    {
+        action.type = Action::Type::keyLock;
+        if (! switchArg(action.value))
+            return "keylock should be on or off";
+    }
+    else if (verb == "eq")
+    {
+        action.type = Action::Type::eq;
+        if (! bandArg(action.band) || ! numberArg(1, -24.0, 6.0, action.value))
+            return "eq needs low, mid or high and a gain between -24 and 6 dB";
+    }
+    else if (verb == "kill")
+    {
+        action.type = Action::Type::kill;
+        if (! bandArg(action.band) || (args[1] != "on" && args[1] != "off"))
+            return "kill needs low, mid or high and on or off";
+        action.value = args[1] == "on" ? 1.0 : 0.0;
+    }
+    else if (verb == "filter")
+    {
+        action.type = Action::Type::filter;
+        if (! numberArg(0, -1.0, 1.0, action.value))
+            return "filter should be between -1 and 1";
+    }
+    else {
+        return "unknown action \"" + tokens[2] + "\"";
+    }
+
+    return {};
+}
+
+//==============================================================================
+// Constructor
+MixScriptPlayer::MixScriptPlayer(const MixScript& _script,
+                                 AudioFormatManager& _formatManager,
+                                 const OwnedArray<DJAudioPlayer>& _decks,
+                                 MixerEngine& _mixer,
+                                 SyncEngine& _syncEngine)
+    : script(_script),
+      formatManager(_formatManager),
+      decks(_decks),
+      mixer(_mixer),
+      syncEngine(_syncEngine)
+{
+}
+
+//==============================================================================
+// Analysis comes first, so every track is loaded with its tempo, loudness trim
+// and auto-cue point already known; a track analysed part way through playback
+// would change the mix depending on how long the analyser took. The decoded
+// cache is then grown to hold every track, so none of them has to stream.
+bool MixScriptPlayer::prepareTracks()
+{
+    const auto& actions = script.getActions();
+
+    if (script.getNumDecks() > decks.size())
+    {
+        std::cout << "MixScriptPlayer::prepareTracks the script uses " << script.getNumDecks()
+                  << " decks, but there are only " << decks.size() << std::endl;
+        return false;
+    }
+
+    for (auto* deck : decks)
+        deck->restoreDefaultSettings();
+
+    SharedResourcePointer<TrackAnalyser> analyser;
+    Array<File> files;
+    int64 bytesNeeded = 0;
+
+    for (const auto& action : actions)
+    {
+        if (action.type != MixScript::Action::Type::load || files.contains(action.file))
+            continue;
+
+        std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(action.file));
+
+        if (reader == nullptr)
+        {
+            std::cout << "MixScriptPlayer::prepareTracks could not open " << action.file.getFullPathName() << std::endl;
+            return false;
+        }
+
+        files.add(action.file);
+        bytesNeeded += reader->lengthInSamples * (int64) jmin(2, (int) reader->numChannels) * (int64) sizeof(float);
+        analyser->analyse(action.file, true);
+    }
+
+    for (const auto& file : files)
+    {
+        TrackAnalysis analysis;
+        const double giveUpMs = Time::getMillisecondCounterHiRes() + analysisTimeoutSeconds * 1000.0;
+
+        while (! analyser->getAnalysis(file, analysis) && Time::getMillisecondCounterHiRes() < giveUpMs)
+            Thread::sleep(20);
+    }
+
+    // A track bigger than half the budget is never cached
+    SharedResourcePointer<DecodedTrackCache> decodedCache;
+    decodedCache->setMemoryBudget(jmax(decodedCache->getMemoryBudget(), 2 * bytesNeeded));
+
+    tracks.clear();
+    tracks.resize(actions.size());
+    retiredTracks.clear();
+    retiredTracks.reserve(actions.size() + (size_t) decks.size());
+
+    for (size_t i = 0; i < actions.size(); ++i)
+    {
+        if (actions[i].type != MixScript::Action::Type::load)
+            continue;
+
+        tracks[i] = decks[actions[i].deck]->loadTrackNow(URL(actions[i].file));
+
+        // A streamed block could come out differently from one render to the next
+        if (tracks[i] == nullptr || tracks[i]->cachedSource == nullptr
+             || ! tracks[i]->cachedSource->getTrack().waitUntilComplete(-1))
+        {
+            std::cout << "MixScriptPlayer::prepareTracks could not load " << actions[i].file.getFullPathName()
+                      << " into memory" << std::endl;
+            tracks.clear();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//==============================================================================
+// The engine itself is reset on the audio thread, at the start of the first block
+void MixScriptPlayer::prepareToPlay(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    actionSamples.clear();
+
+    for (const auto& action : script.getActions())
+        actionSamples.push_back((int64) std::llround(action.time * sampleRate));
+
+    lengthInSamples = (int64) std::llround(script.getLengthSeconds() * sampleRate);
+    nextAction = 0;
+    resetPending = true;
+    position = 0;
+    finished = false;
+
+    crossfaderPosition = fadeFrom = fadeTo = 0.5f;
+    fadeStart = fadeLength = 0;
+}
+
+// Every script starts from the state MixRenderer builds, whatever the decks,
+// sync engine and mixer were left at by hand
+void MixScriptPlayer::resetEngine()
+{
+    for (auto* deck : decks)
+        deck->resetNow();
+
+    syncEngine.reset();
+
+    mixer.resetChannels();
+    mixer.setChannelCrossfaderSide(0, MixerEngine::CrossfaderSide::a);
+    mixer.setChannelCrossfaderSide(1, MixerEngine::CrossfaderSide::b);
+    mixer.setCrossfader(crossfaderPosition);
+    mixer.setCrossfaderCurve(MixerEngine::CrossfaderCurve::equalPower);
+}
+
+//==============================================================================
+// Render the block in pieces, applying the actions due between them. The sync
+// engine runs before every piece, as it does before every block when no script is playing.
+void MixScriptPlayer::renderNextBlock(const AudioSourceChannelInfo& bufferToFill)
+{
+    const auto& actions = script.getActions();
+    const int64 blockStart = position.load();
+    int offset = 0;
+
+    if (resetPending)
+    {
+        resetEngine();
+        resetPending = false;
+    }
+
+    while (offset < bufferToFill.numSamples && ! finished.load())
+    {
+        // Everything due at this sample happens before it is rendered
+        while (nextAction < actions.size() && actionSamples[nextAction] <= blockStart + offset)
+        {
+            applyAction(nextAction++);
+
+            if (finished.load())
+                break;
+        }
+
+        if (finished.load())
+            break;
+
+        const int64 nextSample = nextAction < actions.size() ? actionSamples[nextAction] : lengthInSamples;
+        const int numSamples = (int) jmin((int64) (bufferToFill.numSamples - offset), nextSample - (blockStart + offset));
+
+        updateCrossfade();
+        syncEngine.process();
+        mixer.getNextAudioBlock(AudioSourceChannelInfo(bufferToFill.buffer, bufferToFill.startSample + offset, numSamples));
+
+        offset += numSamples;
+        position = blockStart + offset;
+    }
+
+    if (offset < bufferToFill.numSamples)
+        bufferToFill.buffer->clear(bufferToFill.startSample + offset, bufferToFill.numSamples - offset);
+}
+
+void MixScriptPlayer::applyAction(size_t index)
+{
+    using Type = MixScript::Action::Type;
+    const auto& action = script.getActions()[index];
+    auto* deck = action.deck >= 0 ? decks[action.deck] : nullptr;
+
+    switch (action.type)
+    {
+        case Type::load:
+            retiredTracks.push_back(deck->swapTrackNow(std::move(tracks[index])));
+            break;
+        case Type::play:
+            deck->applyCommandNow(DeckCommand::Type::start);
+            break;
+        case Type::stop:
+            deck->applyCommandNow(DeckCommand::Type::stop);
+            break;
+        case Type::gain:
+            deck->applyCommandNow(DeckCommand::Type::setGain, action.value);
+            break;
+        case Type::speed:
+            deck->applyCommandNow(DeckCommand::Type::setSpeed, action.value);
+            break;
+        case Type::seek:
+            deck->applyCommandNow(DeckCommand::Type::setPosition, action.value);
+            break;
+        case Type::loop:
+            deck->applyCommandNow(DeckCommand::Type::setLoopStart, action.value);
+            deck->applyCommandNow(DeckCommand::Type::setLoopEnd, action.value2);
+            deck->applyCommandNow(DeckCommand::Type::enableLoop, 1.0);
+            break;
+        case Type::loopOff:
+            deck->applyCommandNow(DeckCommand::Type::enableLoop, 0.0);
+            break;
+        case Type::sync:
+            syncEngine.setSynced(action.deck, action.value != 0.0);
+            break;
+        case Type::master:
+            syncEngine.setMaster(action.deck);
+            break;
+        case Type::keyLock:
+            deck->applyCommandNow(DeckCommand::Type::setKeyLock, action.value);
+            break;
+        case Type::eq:
+            deck->applyCommandNow(action.band == (int) DeckEqualiser::Band::low ? DeckCommand::Type::setEqLow
+                                : action.band == (int) DeckEqualiser::Band::mid ? DeckCommand::Type::setEqMid
+                                                                                 : DeckCommand::Type::setEqHigh, action.value);
+            break;
+        case Type::kill:
+            deck->applyCommandNow(action.band == (int) DeckEqualiser::Band::low ? DeckCommand::Type::killEqLow
+                                : action.band == (int) DeckEqualiser::Band::mid ? DeckCommand::Type::killEqMid
+                                                                                 : DeckCommand::Type::killEqHigh, action.value);
+            break;
+        case Type::filter:
+            deck->applyCommandNow(DeckCommand::Type::setFilter, action.value);
+            break;
+        case Type::crossfade:
+            // A glide starts from wherever the crossfader is now, even part way through another one
+            updateCrossfade();
+            fadeFrom = crossfaderPosition;
+            fadeTo = (float) action.value;
+            fadeStart = position.load();
+            fadeLength = (int64) std::llround(action.value2 * sampleRate);
+            updateCrossfade();
+            break;
+        case Type::crossfaderCurve:
+            mixer.setCrossfaderCurve((MixerEngine::CrossfaderCurve) action.band);
+            break;
+        case Type::end:
+            finished = true;
+            break;
+    }
+}
+
+// The crossfader moves once per piece of a block, and the mixer's strips glide
+// between its positions
+void MixScriptPlayer::updateCrossfade()
+{
+    const int64 elapsed = position.load() - fadeStart;
+    const float progress = fadeLength > 0 ? (float) jlimit((int64) 0, fadeLength, elapsed) / (float) fadeLength : 1.0f;
+
+    crossfaderPosition = fadeFrom + (fadeTo - fadeFrom) * progress;
+    mixer.setCrossfader(crossfaderPosition);
+}
+
+//==============================================================================
+int64 MixScriptPlayer::getLengthInSamples() const
+{
+    return lengthInSamples;
+}
+
+int64 MixScriptPlayer::getPosition() const
+{
+    return position.load();
+}
+
+bool MixScriptPlayer::isFinished() const
+{
+    return finished.load();
+}
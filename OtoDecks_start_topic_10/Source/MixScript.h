@@ -0,0 +1,217 @@
+/*
+==============================================================================
+MixScript.h
+Created: 24 Oct 2026 10:12:37am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "DJAudioPlayer.h"
+#include "MixerEngine.h"
+#include "SyncEngine.h"
+#include <atomic>
+#include <vector>
+
+//==============================================================================
+/*
+    MixScript is a mix written down as deck actions at times from the start,
+    one per line:
+
+        # time     deck  action     arguments
+        0:00       1     load       "/music/intro.flac"
+        0:00       1     play
+        1:30       2     load       "/music/next.wav"
+        1:44       2     sync       on
+        1:44       2     play
+        2:00       -     crossfade  1.0  16
+        3:10       1     loop       200.0  204.0
+        3:30       1     stop
+        4:00       -     end
+
+    Times are seconds, or minutes and seconds. Decks are numbered from 1, and
+    "-" marks an action on the mixer. Deck actions are load <file>, play,
+    stop, gain <0-1>, speed <0-4>, seek <seconds>, loop <start> <end>,
+    loop off, sync on|off, master, keylock on|off, eq low|mid|high <dB>,
+    kill low|mid|high on|off and filter <-1 to 1>. Mixer actions are
+    crossfade <0-1> [<seconds to glide over>], curve equalpower|linear|cut,
+    and end, which every script needs. Actions at the same time happen in
+    the order they are written. Anything after a # is a comment.
+*/
+class MixScript
+{
+public:
+    /** One scripted action */
+    struct Action
+    {
+        enum class Type
+        {
+            load,
+            play,
+            stop,
+            gain,
+            speed,
+            seek,
+            loop,
+            loopOff,
+            sync,
+            master,
+            keyLock,
+            eq,
+            kill,
+            filter,
+            crossfade,
+            crossfaderCurve,
+            end
+        };
+
+        double time = 0.0;      // Seconds from the start of the mix
+        int deck = -1;          // From 0, or -1 for the mixer
+        Type type = Type::end;
+        double value = 0.0;     // The first numeric argument, or 1 for on
+        double value2 = 0.0;    // The loop end, or the crossfade glide in seconds
+        int band = 0;           // The EQ band, or the crossfader curve
+        File file;              // The track to load
+    };
+
+    /**
+     * Reads and checks a script, reporting the first problem found.
+     * @param scriptFile The script to read.
+     * @return True if the script was read; false leaves the script empty.
+     */
+    bool loadFromFile(const File& scriptFile);
+
+    /**
+     * Reads and checks a script from text.
+     * @param text The script.
+     * @param baseDirectory Relative track paths are resolved against this.
+     * @return True if the script was read; false leaves the script empty.
+     */
+    bool loadFromText(const String& text, const File& baseDirectory);
+
+    /** Returns the actions in time order. */
+    const std::vector<Action>& getActions() const;
+
+    /** Returns the number of decks the script uses. */
+    int getNumDecks() const;
+
+    /** Returns the time of the end action, in seconds. */
+    double getLengthSeconds() const;
+
+private:
+    /** Reads one non-empty line into an action, returning an error message if it cannot */
+    static String parseLine(const StringArray& tokens, const File& baseDirectory, Action& action);
+
+    std::vector<Action> actions;
+    int numDecks = 0;
+    double lengthSeconds = 0.0;
+};
+
+//==============================================================================
+/*
+    MixScriptPlayer plays a MixScript through a set of decks, their mixer and
+    sync engine, with every action landing on its exact sample.
+
+    Each block is split at the actions due within it. The mixer renders up
+    to an action, the action is applied between the pieces, and the next
+    piece is rendered, just as a deck splits its blocks at queued commands.
+    Nothing depends on the wall clock, the disk or other threads: every track
+    is loaded and analysed before the first block and played from memory, so
+    the same script at the same sample rate and block size renders the same
+    samples whether it is played live or offline. The first block starts by
+    putting every deck, the sync engine and the mixer strips back to how they
+    are built new, with deck 1 on side A of the crossfader and deck 2 on side
+    B, so nothing left over from playing the decks by hand reaches the mix.
+
+    prepareTracks() runs on the message thread (or the thread rendering an
+    offline mix) before playback; renderNextBlock() runs on the audio thread.
+*/
+class MixScriptPlayer
+{
+public:
+    /**
+     * Constructor for MixScriptPlayer.
+     * @param _script The script to play, which must outlive the player.
+     * @param _formatManager Used to size the tracks before they are loaded.
+     * @param _decks The decks, numbered as in the script.
+     * @param _mixer The mixer the decks are connected to, deck n on strip n.
+     * @param _syncEngine The sync engine for the decks.
+     */
+    MixScriptPlayer(const MixScript& _script,
+                    AudioFormatManager& _formatManager,
+                    const OwnedArray<DJAudioPlayer>& _decks,
+                    MixerEngine& _mixer,
+                    SyncEngine& _syncEngine);
+
+    /**
+     * Analyses and loads every track the script plays, waiting for the
+     * background analyser. Every deck's load and resampler settings are put
+     * back to a new deck's first. Never to be called on the audio thread.
+     * @return False if the script needs more decks than there are, or a track could not be loaded into memory.
+     */
+    bool prepareTracks();
+
+    /**
+     * Works out the actions' sample times and rewinds to the start of the script.
+     * Call after prepareTracks() and before the first block.
+     * @param sampleRate The rate the mix is rendered at.
+     */
+    void prepareToPlay(double sampleRate);
+
+    /**
+     * Renders the next block of the mix. Once the script has ended the rest is silent.
+     * Audio thread only, and only once prepareTracks() has succeeded.
+     * @param bufferToFill The buffer to mix into.
+     */
+    void renderNextBlock(const AudioSourceChannelInfo& bufferToFill);
+
+    /** Returns the length of the mix in samples, at the rate it was prepared for. */
+    int64 getLengthInSamples() const;
+
+    /** Returns the number of samples rendered so far. */
+    int64 getPosition() const;
+
+    /** Returns true once the end action has been reached. */
+    bool isFinished() const;
+
+private:
+    /** Puts the decks, sync engine and mixer into the state every script starts from */
+    void resetEngine();
+
+    /** Applies one action between two pieces of a block */
+    void applyAction(size_t index);
+
+    /** Moves the crossfader along its glide, if one is running */
+    void updateCrossfade();
+
+    const MixScript& script;
+    AudioFormatManager& formatManager;
+    const OwnedArray<DJAudioPlayer>& decks;
+    MixerEngine& mixer;
+    SyncEngine& syncEngine;
+
+    /** Each action's sample time, and the track each load action swaps in */
+    std::vector<int64> actionSamples;
+    std::vector<std::unique_ptr<LoadedTrack>> tracks;
+
+    /** Tracks swapped out, kept until the player is deleted off the audio thread */
+    std::vector<std::unique_ptr<LoadedTrack>> retiredTracks;
+
+    double sampleRate = 0.0;
+    int64 lengthInSamples = 0;
+    size_t nextAction = 0;
+    bool resetPending = false;
+    std::atomic<int64> position{0};
+    std::atomic<bool> finished{false};
+
+    /** The crossfader position, and its glide: where it started, when, and where it is heading */
+    float crossfaderPosition = 0.5f;
+    float fadeFrom = 0.5f;
+    float fadeTo = 0.5f;
+    int64 fadeStart = 0;
+    int64 fadeLength = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MixScriptPlayer)
+};
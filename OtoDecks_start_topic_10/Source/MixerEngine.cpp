@@ -0,0 +1,303 @@
+/*
+==============================================================================
+MixerEngine.cpp
+Created: 20 Oct 2026 2:47:06pm
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "MixerEngine.h"
+
+namespace
+{
+    /** Fraction of the travel at each end over which the cut curve fades */
+    constexpr float cutWidth = 0.05f;
+}
+
+//==============================================================================
+// Constructor: Builds every strip up front; none are added or removed later.
+// The worker pool is left until parallel rendering is first switched on.
+MixerEngine::MixerEngine(int numChannels)
+{
+    for (int i = 0; i < numChannels; ++i)
+        strips.add(new ChannelStrip())->index = i;
+
+    activeStrips.ensureStorageAllocated(numChannels);
+}
+
+void MixerEngine::setInput(int channel, AudioSource* source)
+{
+    if (! isPositiveAndBelow(channel, strips.size()))
+    {
+        std::cout << "MixerEngine::setInput channel should be between 0 and " << strips.size() - 1 << std::endl;
+        return;
+    }
+
+    strips[channel]->source = source;
+}
+
+int MixerEngine::getNumChannels() const
+{
+    return strips.size();
+}
+
+//==============================================================================
+void MixerEngine::setChannelGain(int channel, float gain)
+{
+    if (! isPositiveAndBelow(channel, strips.size()) || gain < 0.0f || gain > 1.0f)
+    {
+        std::cout << "MixerEngine::setChannelGain gain should be between 0 and 1" << std::endl;
+    }
+    else {
+        strips[channel]->gain = gain;
+    }
+}
+
+void MixerEngine::setChannelTrim(int channel, float decibels)
+{
+    if (! isPositiveAndBelow(channel, strips.size()) || decibels < -24.0f || decibels > 12.0f)
+    {
+        std::cout << "MixerEngine::setChannelTrim decibels should be between -24 and 12" << std::endl;
+    }
+    else {
+        strips[channel]->trim = Decibels::decibelsToGain(decibels);
+    }
+}
+
+void MixerEngine::setChannelMute(int channel, bool shouldMute)
+{
+    if (isPositiveAndBelow(channel, strips.size()))
+        strips[channel]->muted = shouldMute;
+}
+
+void MixerEngine::setChannelActive(int channel, bool shouldBeActive)
+{
+    if (isPositiveAndBelow(channel, strips.size()))
+        strips[channel]->active = shouldBeActive;
+}
+
+void MixerEngine::setChannelCrossfaderSide(int channel, CrossfaderSide side)
+{
+    if (isPositiveAndBelow(channel, strips.size()))
+        strips[channel]->side = side;
+}
+
+void MixerEngine::setCrossfader(float position)
+{
+    if (position < 0.0f || position > 1.0f)
+    {
+        std::cout << "MixerEngine::setCrossfader position should be between 0 and 1" << std::endl;
+    }
+    else {
+        crossfader = position;
+    }
+}
+
+void MixerEngine::setCrossfaderCurve(CrossfaderCurve curve)
+{
+    crossfaderCurve = curve;
+}
+
+// A new strip starts at a level of 1 and glides from there to its first target
+void MixerEngine::resetChannels()
+{
+    for (auto* strip : strips)
+    {
+        strip->gain = 1.0f;
+        strip->trim = 1.0f;
+        strip->muted = false;
+        strip->active = true;
+        strip->side = CrossfaderSide::thru;
+        strip->level.setCurrentAndTargetValue(1.0f);
+        strip->rampApplied = false;
+    }
+}
+
+//==============================================================================
+// Crossfader curves. Each side's gain falls from 1 to 0 as the fader moves
+// away from it.
+void MixerEngine::getCrossfaderGains(CrossfaderCurve curve, float position, float& gainA, float& gainB)
+{
+    position = jlimit(0.0f, 1.0f, position);
+
+    switch (curve)
+    {
+        case CrossfaderCurve::linear:
+            gainA = 1.0f - position;
+            gainB = position;
+            break;
+        case CrossfaderCurve::equalPower:
+            gainA = std::cos(position * MathConstants<float>::halfPi);
+            gainB = std::sin(position * MathConstants<float>::halfPi);
+            break;
+        case CrossfaderCurve::cut:
+            gainA = jlimit(0.0f, 1.0f, (1.0f - position) / cutWidth);
+            gainB = jlimit(0.0f, 1.0f, position / cutWidth);
+            break;
+    }
+}
+
+// The worker pool gets one thread per spare core, up to one per extra strip.
+// It is published to the audio thread only once it is fully built, and then
+// kept until the mixer is deleted.
+void MixerEngine::setParallelRendering(bool shouldRenderInParallel, int minimumDecks)
+{
+    if (shouldRenderInParallel && ownedWorkerPool == nullptr)
+    {
+        ownedWorkerPool = std::make_unique<RenderWorkerPool>(jlimit(0, strips.size() - 1, SystemStats::getNumCpus() - 1));
+        workerPool = ownedWorkerPool.get();
+    }
+
+    parallelRendering = shouldRenderInParallel;
+    minimumParallelDecks = jmax(2, minimumDecks);
+}
+
+bool MixerEngine::isRenderingInParallel() const
+{
+    return parallelRendering.load();
+}
+
+double MixerEngine::getAverageCallbackMicros(bool parallel) const
+{
+    return parallel ? parallelCallbackMicros.load() : serialCallbackMicros.load();
+}
+
+RenderWorkerPool* MixerEngine::getWorkerPool()
+{
+    return ownedWorkerPool.get();
+}
+
+void MixerEngine::setTimingMonitor(AudioTimingMonitor* monitor)
+{
+    timingMonitor = monitor;
+}
+
+//==============================================================================
+// Prepare every input and size the strip buffers, so the callback never allocates
+void MixerEngine::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    maxSegmentSize = jmax(1, samplesPerBlockExpected);
+
+    for (auto* strip : strips)
+    {
+        strip->buffer.setSize(2, maxSegmentSize);
+        strip->level.prepare(sampleRate, samplesPerBlockExpected);
+
+        if (strip->source != nullptr)
+            strip->source->prepareToPlay(samplesPerBlockExpected, sampleRate);
+    }
+}
+
+void MixerEngine::releaseResources()
+{
+    for (auto* strip : strips)
+        if (strip->source != nullptr)
+            strip->source->releaseResources();
+}
+
+//==============================================================================
+// Blocks longer than the strip buffers (some drivers send the odd one) are
+// mixed in pieces
+void MixerEngine::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill)
+{
+    bufferToFill.clearActiveBufferRegion();
+
+    if (maxSegmentSize == 0)
+        return;  // Not prepared yet
+
+    const int64 startTicks = Time::getHighResolutionTicks();
+    getCrossfaderGains(crossfaderCurve.load(), crossfader.load(), segmentGainA, segmentGainB);
+
+    activeStrips.clearQuick();
+    for (auto* strip : strips)
+        if (strip->source != nullptr && strip->active.load())
+            activeStrips.add(strip);
+
+    auto* pool = workerPool.load();
+    const bool parallel = parallelRendering.load()
+                           && pool != nullptr
+                           && pool->getNumWorkers() > 0
+                           && activeStrips.size() >= minimumParallelDecks.load();
+
+    for (int offset = 0; offset < bufferToFill.numSamples; offset += maxSegmentSize)
+    {
+        segmentSize = jmin(maxSegmentSize, bufferToFill.numSamples - offset);
+
+        if (parallel)
+        {
+            // Render everything at once, then sum in strip order so the mix is
+            // identical to a serial one
+            pool->run(*this, activeStrips.size());
+
+            for (auto* strip : activeStrips)
+                addStrip(*strip, *bufferToFill.buffer, bufferToFill.startSample + offset);
+        }
+        else {
+            mixSegment(bufferToFill, offset);
+        }
+    }
+
+    // Smoothed over roughly the last hundred callbacks
+    auto& average = parallel ? parallelCallbackMicros : serialCallbackMicros;
+    const double micros = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - startTicks) * 1.0e6;
+    average = average.load() + 0.01 * (micros - average.load());
+}
+
+// Every active source is rendered even when muted or faded out, so its
+// playhead keeps moving
+void MixerEngine::mixSegment(const AudioSourceChannelInfo& bufferToFill, int offset)
+{
+    for (auto* strip : activeStrips)
+    {
+        renderStrip(*strip);
+        addStrip(*strip, *bufferToFill.buffer, bufferToFill.startSample + offset);
+    }
+}
+
+void MixerEngine::runJob(int index)
+{
+    renderStrip(*activeStrips.getUnchecked(index));
+}
+
+// A strip that is gliding to a new level is ramped in its own buffer here; a
+// strip at a steady level is scaled while it is added
+void MixerEngine::renderStrip(ChannelStrip& strip)
+{
+    const AudioSourceChannelInfo input(&strip.buffer, 0, segmentSize);
+    auto* monitor = timingMonitor.load();
+    const int64 startTicks = monitor != nullptr ? Time::getHighResolutionTicks() : 0;
+
+    strip.source->getNextAudioBlock(input);
+
+    if (monitor != nullptr)
+        monitor->recordDeck(strip.index, Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - startTicks) * 1.0e6);
+
+    const auto side = strip.side.load();
+    const float crossfadeGain = side == CrossfaderSide::a ? segmentGainA : (side == CrossfaderSide::b ? segmentGainB : 1.0f);
+    const float target = strip.muted.load() ? 0.0f : strip.gain.load() * strip.trim.load() * crossfadeGain;
+
+    if (target != strip.level.getTargetValue())
+        strip.level.setTargetValue(target);
+
+    strip.rampApplied = strip.level.isSmoothing();
+
+    if (strip.rampApplied)
+        strip.level.applyGain(strip.buffer, 0, segmentSize);
+}
+
+void MixerEngine::addStrip(ChannelStrip& strip, AudioBuffer<float>& output, int outputStart)
+{
+    if (strip.rampApplied)
+    {
+        for (int channel = 0; channel < output.getNumChannels(); ++channel)
+            FloatVectorOperations::add(output.getWritePointer(channel, outputStart),
+                                       strip.buffer.getReadPointer(jmin(channel, 1)), segmentSize);
+    }
+    else if (strip.level.getCurrentValue() != 0.0f)
+    {
+        for (int channel = 0; channel < output.getNumChannels(); ++channel)
+            FloatVectorOperations::addWithMultiply(output.getWritePointer(channel, outputStart),
+                                                   strip.buffer.getReadPointer(jmin(channel, 1)),
+                                                   strip.level.getCurrentValue(), segmentSize);
+    }
+}
@@ -0,0 +1,224 @@
+/*
+==============================================================================
+MixerEngine.h
+Created: 20 Oct 2026 2:47:06pm
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "SmoothedParameter.h"
+#include "RenderWorkerPool.h"
+#include "AudioTimingMonitor.h"
+#include <atomic>
+
+//==============================================================================
+/*
+    MixerEngine sums the decks into the master bus. It replaces MixerAudioSource,
+    which locks on every callback.
+
+    The topology is fixed when the mixer is built: one channel strip per
+    input, with gain, trim, mute and a crossfader assignment. Controls are
+    atomics written from the message thread, and every strip glides to its
+    new level with a SmoothedParameter. The audio thread takes no locks and
+    allocates nothing. Each input is rendered into its own preallocated buffer
+    and added into the output with one vector multiply-add per channel.
+
+    In parallel mode the inputs are rendered at the same time on a
+    RenderWorkerPool, and then summed on the callback thread in strip order.
+    When only a few decks are active, the hand-off costs more than it saves,
+    so those callbacks are rendered serially.
+*/
+class MixerEngine : public AudioSource,
+                    private RenderWorkerPool::Job
+{
+public:
+    /** How the crossfader position maps to the gains of its two sides */
+    enum class CrossfaderCurve
+    {
+        linear,       // Gains sum to 1: a dip in loudness at the centre
+        equalPower,   // Squared gains sum to 1: constant loudness across the fade
+        cut           // Both sides at full level except right at the ends, for scratching
+    };
+
+    /** Which side of the crossfader a channel is on */
+    enum class CrossfaderSide
+    {
+        thru,
+        a,
+        b
+    };
+
+    /**
+     * Constructor for MixerEngine.
+     * @param numChannels The number of channel strips, fixed for the mixer's lifetime.
+     */
+    MixerEngine(int numChannels);
+
+    /**
+     * Connects a source to a channel strip. Not to be called while audio is running.
+     * @param channel The strip index.
+     * @param source The source to play through the strip, which is not owned; nullptr disconnects it.
+     */
+    void setInput(int channel, AudioSource* source);
+
+    /** Returns the number of channel strips. */
+    int getNumChannels() const;
+
+    //==============================================================================
+    /**
+     * Sets a channel's fader level.
+     * @param channel The strip index.
+     * @param gain The gain, between 0.0 and 1.0.
+     */
+    void setChannelGain(int channel, float gain);
+
+    /**
+     * Sets a channel's trim, for matching the levels of different tracks.
+     * @param channel The strip index.
+     * @param decibels The trim, between -24 and +12 dB.
+     */
+    void setChannelTrim(int channel, float decibels);
+
+    /**
+     * Mutes or unmutes a channel. A muted deck keeps playing silently.
+     * @param channel The strip index.
+     * @param shouldMute True to mute.
+     */
+    void setChannelMute(int channel, bool shouldMute);
+
+    /**
+     * Switches a channel strip on or off. An inactive strip's source is not
+     * rendered at all, so unused decks cost nothing.
+     * @param channel The strip index.
+     * @param shouldBeActive True to render and mix the channel.
+     */
+    void setChannelActive(int channel, bool shouldBeActive);
+
+    /**
+     * Assigns a channel to a side of the crossfader.
+     * @param channel The strip index.
+     * @param side Side A, side B, or thru (unaffected by the crossfader).
+     */
+    void setChannelCrossfaderSide(int channel, CrossfaderSide side);
+
+    /**
+     * Moves the crossfader.
+     * @param position 0.0 for side A only, 1.0 for side B only.
+     */
+    void setCrossfader(float position);
+
+    /** Selects the crossfader curve. */
+    void setCrossfaderCurve(CrossfaderCurve curve);
+
+    /**
+     * Puts every strip back to how the mixer was built: full gain, no trim,
+     * unmuted, active and thru, at its level straight away rather than gliding
+     * there. Audio thread only, between blocks.
+     */
+    void resetChannels();
+
+    /**
+     * Works out the gains of the two crossfader sides.
+     * @param curve The curve to use.
+     * @param position The crossfader position, from 0.0 to 1.0.
+     * @param gainA Set to the gain of side A.
+     * @param gainB Set to the gain of side B.
+     */
+    static void getCrossfaderGains(CrossfaderCurve curve, float position, float& gainA, float& gainB);
+
+    //==============================================================================
+    /**
+     * Switches parallel rendering on or off. The worker pool's threads are
+     * started the first time it is switched on. Message thread only.
+     * @param shouldRenderInParallel True to render decks on the worker pool.
+     * @param minimumDecks The fewest active decks for which a callback is rendered in parallel.
+     */
+    void setParallelRendering(bool shouldRenderInParallel, int minimumDecks = 3);
+
+    /** Returns true if parallel rendering is switched on. */
+    bool isRenderingInParallel() const;
+
+    /**
+     * Gets the average time spent rendering and mixing one callback.
+     * @param parallel True for callbacks rendered on the worker pool, false for serial ones.
+     * @return The time in microseconds, averaged over recent callbacks.
+     */
+    double getAverageCallbackMicros(bool parallel) const;
+
+    /** Returns the worker pool, e.g. to read its wake-up jitter, or nullptr if parallel rendering has never been switched on. */
+    RenderWorkerPool* getWorkerPool();
+
+    /**
+     * Times every input's render from now on, on whichever thread renders it.
+     * @param monitor Receives each channel's render times as its deck's, or nullptr to stop (not owned).
+     */
+    void setTimingMonitor(AudioTimingMonitor* monitor);
+
+    //==============================================================================
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
+
+private:
+    /** One input and its controls */
+    struct ChannelStrip
+    {
+        AudioSource* source = nullptr;
+        int index = 0;
+
+        std::atomic<float> gain{1.0f};
+        std::atomic<float> trim{1.0f};
+        std::atomic<bool> muted{false};
+        std::atomic<bool> active{true};
+        std::atomic<CrossfaderSide> side{CrossfaderSide::thru};
+
+        /** The combined level actually applied, owned by the audio thread */
+        SmoothedParameter level{1.0f};
+
+        /** Where the input is rendered, and whether a level ramp has already been applied to it */
+        AudioBuffer<float> buffer;
+        bool rampApplied = false;
+    };
+
+    /** Renders every active strip, one at a time, for part of a block and adds it into the output */
+    void mixSegment(const AudioSourceChannelInfo& bufferToFill, int offset);
+
+    /** Renders one strip into its buffer and applies any level ramp */
+    void renderStrip(ChannelStrip& strip);
+
+    /** Adds a rendered strip into the output */
+    void addStrip(ChannelStrip& strip, AudioBuffer<float>& output, int outputStart);
+
+    /** Renders one of the active strips; called on the worker pool */
+    void runJob(int index) override;
+
+    OwnedArray<ChannelStrip> strips;
+
+    std::atomic<float> crossfader{0.5f};
+    std::atomic<CrossfaderCurve> crossfaderCurve{CrossfaderCurve::equalPower};
+
+    /** Block size the strip buffers were allocated for */
+    int maxSegmentSize = 0;
+
+    /** The segment being rendered: its active strips, length and crossfader gains */
+    Array<ChannelStrip*> activeStrips;
+    int segmentSize = 0;
+    float segmentGainA = 1.0f;
+    float segmentGainB = 1.0f;
+
+    /** Parallel rendering settings and callback timings */
+    std::atomic<bool> parallelRendering{false};
+    std::atomic<int> minimumParallelDecks{3};
+    std::atomic<double> serialCallbackMicros{0.0};
+    std::atomic<double> parallelCallbackMicros{0.0};
+
+    /** Created on the message thread when first needed; the audio thread reads it through workerPool */
+    std::unique_ptr<RenderWorkerPool> ownedWorkerPool;
+    std::atomic<RenderWorkerPool*> workerPool{nullptr};
+    std::atomic<AudioTimingMonitor*> timingMonitor{nullptr};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MixerEngine)
+};
@@ -0,0 +1,318 @@
+/*
+==============================================================================
+Mp3SeekIndex.cpp
+Created: 19 Oct 2026 4:50:31pm
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "Mp3SeekIndex.h"
+
+namespace
+{
+    constexpr int indexMagic = 0x4f545349;  // "OTSI"
+    constexpr int indexVersion = 1;
+
+    /** The fields of an MPEG audio frame header that the index needs */
+    struct FrameHeader
+    {
+        int length = 0;
+        int sampleRate = 0;
+        int samplesPerFrame = 0;
+        int sideInfoSize = 0;
+        bool hasCrc = false;
+    };
+
+    /** Parses a layer III frame header, rejecting anything else */
+    bool parseHeader(const uint8* h, FrameHeader& header)
+    {
+        if (h[0] != 0xff || (h[1] & 0xe0) != 0xe0)
+            return false;
+
+        const int version = (h[1] >> 3) & 3;   // 0 = MPEG 2.5, 1 = reserved, 2 = MPEG 2, 3 = MPEG 1
+        const int layer = (h[1] >> 1) & 3;     // 1 = layer III
+        const int bitrateIndex = (h[2] >> 4) & 15;
+        const int rateIndex = (h[2] >> 2) & 3;
+
+        if (version == 1 || layer != 1 || bitrateIndex == 0 || bitrateIndex == 15 || rateIndex == 3)
+            return false;
+
+        static const int mpeg1Bitrates[] = { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320 };
+        static const int mpeg2Bitrates[] = { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160 };
+        static const int baseSampleRates[] = { 44100, 48000, 32000 };
+
+        const bool mpeg1 = version == 3;
+        const bool mono = ((h[3] >> 6) & 3) == 3;
+        const int bitrate = (mpeg1 ? mpeg1Bitrates : mpeg2Bitrates)[bitrateIndex] * 1000;
+        const int padding = (h[2] >> 1) & 1;
+
+        header.sampleRate = baseSampleRates[rateIndex] >> (mpeg1 ? 0 : (version == 2 ? 1 : 2));
+        header.samplesPerFrame = mpeg1 ? 1152 : 576;
+        header.length = (mpeg1 ? 144 : 72) * bitrate / header.sampleRate + padding;
+        header.sideInfoSize = mpeg1 ? (mono ? 17 : 32) : (mono ? 9 : 17);
+        header.hasCrc = (h[1] & 1) == 0;
+        return true;
+    }
+
+    /** Reads bytes at an absolute position, returning false if they are not all there */
+    bool readAt(InputStream& in, int64 position, void* dest, int numBytes)
+    {
+        return in.setPosition(position) && in.read(dest, numBytes) == numBytes;
+    }
+
+    /** Returns the end of an ID3v2 tag at the start of the file, or 0 if there is none */
+    int64 skipId3v2(InputStream& in)
+    {
+        uint8 tag[10];
+
+        if (! readAt(in, 0, tag, 10) || tag[0] != 'I' || tag[1] != 'D' || tag[2] != '3')
+            return 0;
+
+        const int64 size = ((tag[6] & 0x7f) << 21) | ((tag[7] & 0x7f) << 14) | ((tag[8] & 0x7f) << 7) | (tag[9] & 0x7f);
+        const bool hasFooter = (tag[5] & 0x10) != 0;
+        return 10 + size + (hasFooter ? 10 : 0);
+    }
+
+    /** Finds the next position from which two consecutive valid frames follow, or -1 */
+    int64 findFrame(InputStream& in, int64 from, int64 fileLength)
+    {
+        constexpr int windowSize = 8192;
+        HeapBlock<uint8> window((size_t) windowSize + 3);
+
+        for (int64 start = from; start + 4 <= fileLength; start += windowSize)
+        {
+            const int numToRead = (int) jmin((int64) windowSize + 3, fileLength - start);
+            if (! readAt(in, start, window.get(), numToRead))
+                return -1;
+
+            for (int i = 0; i + 4 <= numToRead; ++i)
+            {
+                FrameHeader header, next;
+                uint8 nextBytes[4];
+
+                if (parseHeader(window + i, header)
+                     && readAt(in, start + i + header.length, nextBytes, 4)
+                     && parseHeader(nextBytes, next)
+                     && next.sampleRate == header.sampleRate)
+                    return start + i;
+            }
+        }
+
+        return -1;
+    }
+
+    /** Checks whether the frame at a position is a Xing, Info or VBRI header rather than audio */
+    bool isInfoFrame(InputStream& in, int64 position, const FrameHeader& header)
+    {
+        uint8 tag[4];
+        const int xingOffset = 4 + (header.hasCrc ? 2 : 0) + header.sideInfoSize;
+
+        if (readAt(in, position + xingOffset, tag, 4)
+             && (std::memcmp(tag, "Xing", 4) == 0 || std::memcmp(tag, "Info", 4) == 0))
+            return true;
+
+        return readAt(in, position + 36, tag, 4) && std::memcmp(tag, "VBRI", 4) == 0;
+    }
+}
+
+//==============================================================================
+// Hop from header to header through the file. Lost sync (e.g. junk between
+// frames) is recovered by searching for the next pair of valid headers.
+std::unique_ptr<Mp3SeekIndex> Mp3SeekIndex::build(const File& file, const std::function<bool()>& shouldAbort)
+{
+    FileInputStream fileStream(file);
+
+    if (fileStream.failedToOpen())
+        return nullptr;
+
+    BufferedInputStream in(fileStream, 65536);
+    const int64 fileLength = file.getSize();
+
+    int64 position = findFrame(in, skipId3v2(in), fileLength);
+    if (position < 0)
+        return nullptr;
+
+    std::unique_ptr<Mp3SeekIndex> index(new Mp3SeekIndex());
+    index->fileLength = fileLength;
+    index->fileModificationTime = file.getLastModificationTime().toMilliseconds();
+    index->frameOffsets.reserve((size_t) (fileLength / 400));
+
+    int sampleRate = 0;
+    bool firstFrame = true;
+
+    while (position + 4 <= fileLength)
+    {
+        if ((index->frameOffsets.size() & 4095) == 0 && shouldAbort())
+            return nullptr;
+
+        uint8 bytes[4];
+        FrameHeader header;
+
+        if (! readAt(in, position, bytes, 4))
+            break;
+
+        if (! parseHeader(bytes, header) || (sampleRate != 0 && header.sampleRate != sampleRate))
+        {
+            // Tags at the end of the file mean the audio is over
+            if (std::memcmp(bytes, "TAG", 3) == 0 || std::memcmp(bytes, "APET", 4) == 0 || std::memcmp(bytes, "LYRI", 4) == 0)
+                break;
+
+            position = findFrame(in, position + 1, fileLength);
+            if (position < 0)
+                break;
+
+            continue;
+        }
+
+        if (position + header.length > fileLength)
+            break;  // A truncated last frame cannot be decoded
+
+        if (firstFrame && isInfoFrame(in, position, header))
+            index->infoFrame = true;
+        else
+            index->frameOffsets.push_back(position);
+
+        firstFrame = false;
+        sampleRate = header.sampleRate;
+        index->samplesPerFrame = header.samplesPerFrame;
+        position += header.length;
+    }
+
+    if (index->frameOffsets.empty())
+        return nullptr;
+
+    return index;
+}
+
+//==============================================================================
+// Persistence: a small header identifying the file, then the frame offsets as deltas
+File Mp3SeekIndex::getIndexFile(const File& file, Storage storage)
+{
+    switch (storage)
+    {
+        case Storage::besideFile:
+            return file.getSiblingFile(file.getFileName() + ".seekindex");
+        case Storage::cacheDirectory:
+            return File::getSpecialLocation(File::userApplicationDataDirectory)
+                       .getChildFile("OtoDecks")
+                       .getChildFile("SeekIndex")
+                       .getChildFile(String::toHexString(file.getFullPathName().hashCode64()) + ".seekindex");
+        case Storage::none:
+            break;
+    }
+
+    return {};
+}
+
+std::unique_ptr<Mp3SeekIndex> Mp3SeekIndex::load(const File& file, Storage storage)
+{
+    const File indexFile = getIndexFile(file, storage);
+
+    if (indexFile == File() || ! indexFile.existsAsFile())
+        return nullptr;
+
+    FileInputStream fileStream(indexFile);
+    if (fileStream.failedToOpen())
+        return nullptr;
+
+    BufferedInputStream in(fileStream, 65536);
+
+    if (in.readInt() != indexMagic || in.readInt() != indexVersion)
+        return nullptr;
+
+    std::unique_ptr<Mp3SeekIndex> index(new Mp3SeekIndex());
+    index->fileLength = in.readInt64();
+    index->fileModificationTime = in.readInt64();
+
+    if (index->fileLength != file.getSize()
+         || index->fileModificationTime != file.getLastModificationTime().toMilliseconds())
+        return nullptr;  // The audio has changed since the index was saved
+
+    index->samplesPerFrame = in.readInt();
+    index->leadingFrames = in.readInt();
+    index->infoFrame = in.readBool();
+
+    const int numFrames = in.readInt();
+    if (numFrames <= 0 || (int64) numFrames * 4 > in.getNumBytesRemaining())
+        return nullptr;
+
+    index->frameOffsets.resize((size_t) numFrames);
+    int64 offset = 0;
+
+    for (auto& frameOffset : index->frameOffsets)
+    {
+        offset += in.readInt();
+        frameOffset = offset;
+    }
+
+    return index;
+}
+
+bool Mp3SeekIndex::save(const File& file, Storage storage) const
+{
+    const File indexFile = getIndexFile(file, storage);
+
+    if (indexFile == File() || ! indexFile.getParentDirectory().createDirectory())
+        return false;
+
+    TemporaryFile temp(indexFile);
+
+    {
+        FileOutputStream out(temp.getFile());
+        if (out.failedToOpen())
+            return false;
+
+        out.writeInt(indexMagic);
+        out.writeInt(indexVersion);
+        out.writeInt64(fileLength);
+        out.writeInt64(fileModificationTime);
+        out.writeInt(samplesPerFrame);
+        out.writeInt(leadingFrames);
+        out.writeBool(infoFrame);
+        out.writeInt((int) frameOffsets.size());
+
+        int64 previous = 0;
+        for (auto frameOffset : frameOffsets)
+        {
+            out.writeInt((int) (frameOffset - previous));
+            previous = frameOffset;
+        }
+
+        out.flush();
+        if (out.getStatus().failed())
+            return false;
+    }
+
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+//==============================================================================
+int Mp3SeekIndex::getNumFrames() const
+{
+    return (int) frameOffsets.size();
+}
+
+int64 Mp3SeekIndex::getFrameOffset(int frameIndex) const
+{
+    return isPositiveAndBelow(frameIndex, getNumFrames()) ? frameOffsets[(size_t) frameIndex] : fileLength;
+}
+
+int Mp3SeekIndex::getSamplesPerFrame() const
+{
+    return samplesPerFrame;
+}
+
+bool Mp3SeekIndex::hasInfoFrame() const
+{
+    return infoFrame;
+}
+
+void Mp3SeekIndex::setLeadingFrames(int numFrames)
+{
+    leadingFrames = numFrames;
+}
+
+int Mp3SeekIndex::getLeadingFrames() const
+{
+    return leadingFrames;
+}
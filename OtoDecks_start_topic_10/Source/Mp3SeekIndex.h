@@ -0,0 +1,99 @@
+/*
+==============================================================================
+Mp3SeekIndex.h
+Created: 19 Oct 2026 4:50:31pm
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <functional>
+#include <vector>
+
+//==============================================================================
+/*
+    Mp3SeekIndex records the byte offset of every audio frame in an MP3 file.
+    With it, any sample position maps straight to the frame that holds it,
+    so a seek costs the same anywhere in a two-hour VBR mix.
+
+    The index is built by walking the frame headers, without decoding. A
+    Xing/Info/VBRI header frame at the start is noted but not indexed, since
+    it carries no audio. Indexes can be saved next to the file or in the
+    application's cache directory and are reused while the file's size and
+    modification time are unchanged.
+*/
+class Mp3SeekIndex
+{
+public:
+    /** Where built indexes are kept between sessions */
+    enum class Storage
+    {
+        none,
+        besideFile,
+        cacheDirectory
+    };
+
+    /**
+     * Walks the frame headers of an MP3 file.
+     * @param file The file to index.
+     * @param shouldAbort Polled regularly; returning true abandons the scan.
+     * @return The index, or nullptr if the file is not layer III audio or the scan was abandoned.
+     */
+    static std::unique_ptr<Mp3SeekIndex> build(const File& file, const std::function<bool()>& shouldAbort);
+
+    /**
+     * Loads a previously saved index, if there is one that still matches the file.
+     * @param file The audio file the index belongs to.
+     * @param storage Where to look.
+     * @return The index, or nullptr if none was found or it is out of date.
+     */
+    static std::unique_ptr<Mp3SeekIndex> load(const File& file, Storage storage);
+
+    /**
+     * Saves the index for later sessions.
+     * @param file The audio file the index belongs to.
+     * @param storage Where to save it.
+     * @return True if it was written.
+     */
+    bool save(const File& file, Storage storage) const;
+
+    //==============================================================================
+    /** Returns the number of audio frames indexed. */
+    int getNumFrames() const;
+
+    /** Returns the byte offset of an audio frame, or the file length for the frame after the last. */
+    int64 getFrameOffset(int frameIndex) const;
+
+    /** Returns the number of samples each frame decodes to (1152 or 576). */
+    int getSamplesPerFrame() const;
+
+    /** Returns true if the file starts with a Xing/Info/VBRI header frame. */
+    bool hasInfoFrame() const;
+
+    /**
+     * Sets how many frames of output a decoder reading from the start of the
+     * file produces before the first indexed frame (0, or 1 if it plays the
+     * info frame as silence).
+     */
+    void setLeadingFrames(int numFrames);
+
+    /** Returns the number of frames of output before the first indexed frame. */
+    int getLeadingFrames() const;
+
+private:
+    Mp3SeekIndex() = default;
+
+    /** Returns the file the index is saved to for a given storage choice */
+    static File getIndexFile(const File& file, Storage storage);
+
+    std::vector<int64> frameOffsets;
+    int64 fileLength = 0;
+    int64 fileModificationTime = 0;
+    int samplesPerFrame = 1152;
+    int leadingFrames = 0;
+    bool infoFrame = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Mp3SeekIndex)
+};
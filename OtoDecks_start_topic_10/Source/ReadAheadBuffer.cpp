@@ -0,0 +1,414 @@
+/*
+==============================================================================
+ReadAheadBuffer.cpp
+Created: 18 Oct 2026 3:41:09pm
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "ReadAheadBuffer.h"
+#include <limits>
+
+namespace
+{
+    /** Samples read from the source per fill step, before priorities are re-checked */
+    constexpr int chunkSize = 8192;
+}
+
+//==============================================================================
+// Constructor: Starts one worker per pair of cores, at least one and at most four
+ReadAheadPool::ReadAheadPool()
+{
+    const int numThreads = jlimit(1, 4, SystemStats::getNumCpus() / 2);
+
+    for (int i = 0; i < numThreads; ++i)
+        workers.add(new Worker(*this, i))->startThread(Thread::Priority::high);
+}
+
+ReadAheadPool::~ReadAheadPool()
+{
+    for (auto* worker : workers)
+        worker->signalThreadShouldExit();
+
+    notify();
+    workers.clear();  // Each worker's destructor waits for its thread to stop
+}
+
+void ReadAheadPool::addBuffer(ReadAheadBuffer* buffer)
+{
+    {
+        const ScopedLock sl(lock);
+        buffers.addIfNotAlreadyThere(buffer);
+    }
+
+    notify();
+}
+
+// Once the buffer is off the list no worker can pick it again; taking its fill
+// lock then waits out a worker that picked it just before
+void ReadAheadPool::removeBuffer(ReadAheadBuffer* buffer)
+{
+    {
+        const ScopedLock sl(lock);
+        buffers.removeFirstMatchingValue(buffer);
+    }
+
+    const ScopedLock fill(buffer->fillLock);
+}
+
+void ReadAheadPool::notify()
+{
+    for (auto* worker : workers)
+        worker->notify();
+}
+
+int ReadAheadPool::getNumThreads() const
+{
+    return workers.size();
+}
+
+//==============================================================================
+// Pick the buffer with the least audio ahead of its playhead that no other
+// worker is already filling, and read one chunk into it
+bool ReadAheadPool::fillMostUrgent()
+{
+    ReadAheadBuffer* chosen = nullptr;
+
+    {
+        const ScopedLock sl(lock);
+        double lowestUrgency = std::numeric_limits<double>::max();
+
+        for (auto* buffer : buffers)
+        {
+            const double urgency = buffer->getUrgency();
+
+            if (urgency < lowestUrgency && buffer->fillLock.tryEnter())
+            {
+                if (chosen != nullptr)
+                    chosen->fillLock.exit();
+
+                chosen = buffer;
+                lowestUrgency = urgency;
+            }
+        }
+    }
+
+    if (chosen == nullptr)
+        return false;
+
+    const bool worked = chosen->fillNextChunk();
+    chosen->fillLock.exit();
+    return worked;
+}
+
+ReadAheadPool::Worker::Worker(ReadAheadPool& owner, int index)
+    : Thread("Read Ahead " + String(index + 1)),
+      pool(owner)
+{
+}
+
+ReadAheadPool::Worker::~Worker()
+{
+    stopThread(4000);
+}
+
+// Keep filling while any buffer needs it, otherwise poll. The audio thread
+// never wakes the workers itself, so seeks are picked up within a few ms.
+void ReadAheadPool::Worker::run()
+{
+    while (! threadShouldExit())
+    {
+        if (! pool.fillMostUrgent())
+            wait(5);
+    }
+}
+
+//==============================================================================
+// Constructor: Sizes the ring and pinned buffer, then joins the shared pool.
+// A quarter of the ring is kept behind the playhead for short jumps back.
+ReadAheadBuffer::ReadAheadBuffer(PositionableAudioSource* sourceToBuffer, double sourceSampleRate, double secondsToBuffer)
+    : source(sourceToBuffer),
+      sampleRate(sourceSampleRate),
+      totalLength(sourceToBuffer->getTotalLength()),
+      capacity(jmax(chunkSize * 4, roundToInt(sourceSampleRate * secondsToBuffer))),
+      historyLength(capacity / 4)
+{
+    ring.setSize(2, capacity);
+    ring.clear();
+
+    pinned.setSize(2, jmin(capacity / 4, roundToInt(sourceSampleRate)));
+    pinned.clear();
+
+    pool->addBuffer(this);
+}
+
+ReadAheadBuffer::~ReadAheadBuffer()
+{
+    pool->removeBuffer(this);
+}
+
+//==============================================================================
+// Writer side: serve a pending seek first, then the pinned audio, then top up
+// the ring ahead of the playhead
+bool ReadAheadBuffer::fillNextChunk()
+{
+    const ScopedLock sl(fillLock);
+    bool worked = false;
+
+    const int64 seekTo = seekRequest.exchange(-1);
+    if (seekTo >= 0)
+    {
+        // An odd generation tells a reader mid-copy the range is moving, and
+        // makes it discard what it read. The release fences keep the odd
+        // value ahead of the new range, and the new range ahead of the even one.
+        const uint32 oldGeneration = generation.load(std::memory_order_relaxed);
+        generation.store(oldGeneration + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        validStart.store(seekTo, std::memory_order_relaxed);
+        validEnd.store(seekTo, std::memory_order_relaxed);
+
+        generation.store(oldGeneration + 2, std::memory_order_release);
+        worked = true;
+    }
+
+    const int64 pinTo = pinnedRequest.load();
+    if (pinTo >= 0 && pinTo != pinnedValid.load())
+    {
+        pinnedValid.store(-1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        source->setNextReadPosition(pinTo);
+        source->getNextAudioBlock(AudioSourceChannelInfo(&pinned, 0, pinned.getNumSamples()));
+
+        pinnedValid.store(pinTo, std::memory_order_release);
+        return true;
+    }
+
+    const int64 end = validEnd.load();
+    const int64 target = jmin(totalLength, playPosition.load() + (int64) (capacity - historyLength));
+
+    if (end >= target)
+        return worked;
+
+    const int numToRead = (int) jmin((int64) chunkSize, target - end);
+
+    // The new start has to be visible before any of the oldest samples is
+    // overwritten, and the samples before the end that covers them. A plain
+    // store allows neither on a weakly ordered CPU, hence the fences.
+    validStart.store(jmax(validStart.load(std::memory_order_relaxed), end + numToRead - (int64) capacity),
+                     std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    readIntoRing(end, numToRead);
+
+    validEnd.store(end + numToRead, std::memory_order_release);
+
+    return true;
+}
+
+void ReadAheadBuffer::readIntoRing(int64 position, int numSamples)
+{
+    source->setNextReadPosition(position);
+
+    const int ringIndex = (int) (position % capacity);
+    const int numBeforeWrap = jmin(numSamples, capacity - ringIndex);
+
+    source->getNextAudioBlock(AudioSourceChannelInfo(&ring, ringIndex, numBeforeWrap));
+
+    if (numSamples > numBeforeWrap)
+        source->getNextAudioBlock(AudioSourceChannelInfo(&ring, 0, numSamples - numBeforeWrap));
+}
+
+//==============================================================================
+// Priorities and counters, safe to read from any thread
+double ReadAheadBuffer::getUrgency() const
+{
+    if (seekRequest.load() >= 0)
+        return -1.0;
+
+    const int64 pinTo = pinnedRequest.load();
+    if (pinTo >= 0 && pinTo != pinnedValid.load())
+        return -1.0;
+
+    const int64 target = jmin(totalLength, playPosition.load() + (int64) (capacity - historyLength));
+    if (validEnd.load() >= target)
+        return std::numeric_limits<double>::max();
+
+    return getBufferedSeconds();
+}
+
+double ReadAheadBuffer::getBufferedSeconds() const
+{
+    return (double) jmax((int64) 0, validEnd.load() - playPosition.load()) / sampleRate;
+}
+
+float ReadAheadBuffer::getFillLevel() const
+{
+    const int64 ahead = jmax((int64) 0, validEnd.load() - playPosition.load());
+    const int64 wanted = jmin((int64) (capacity - historyLength), totalLength - playPosition.load());
+
+    return wanted > 0 ? jmin(1.0f, (float) ahead / (float) wanted) : 1.0f;
+}
+
+int ReadAheadBuffer::getNumUnderruns() const
+{
+    return numUnderruns.load();
+}
+
+void ReadAheadBuffer::setPinnedPosition(int64 position)
+{
+    pinnedRequest = position;
+}
+
+//==============================================================================
+// The ring is allocated up front and the source is only touched by the writer,
+// so there is nothing to prepare here
+void ReadAheadBuffer::prepareToPlay(int, double)
+{
+}
+
+void ReadAheadBuffer::releaseResources()
+{
+}
+
+//==============================================================================
+// Reader side: serve the block from the ring and the pinned buffer, and play
+// silence for anything not buffered yet. Never waits for the writer.
+void ReadAheadBuffer::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill)
+{
+    const int64 position = nextReadPosition;
+    const int numPlayable = (int) jlimit((int64) 0, (int64) bufferToFill.numSamples, totalLength - position);
+    int numDone = 0;
+
+    while (numDone < numPlayable)
+    {
+        int numCopied = copyFromRing(bufferToFill, numDone, position + numDone, numPlayable - numDone);
+
+        if (numCopied == 0)
+            numCopied = copyFromPinned(bufferToFill, numDone, position + numDone, numPlayable - numDone);
+
+        if (numCopied == 0)
+            break;
+
+        numDone += numCopied;
+    }
+
+    if (numDone < bufferToFill.numSamples)
+    {
+        for (int channel = 0; channel < bufferToFill.buffer->getNumChannels(); ++channel)
+            bufferToFill.buffer->clear(channel, bufferToFill.startSample + numDone, bufferToFill.numSamples - numDone);
+    }
+
+    if (numDone < numPlayable)
+    {
+        ++numUnderruns;
+
+        // Only restart the ring if the gap is not simply the writer still catching up
+        const int64 missing = position + numDone;
+        if (missing < validStart.load() || missing > validEnd.load())
+            requestRefillFrom(missing);
+    }
+
+    nextReadPosition = position + bufferToFill.numSamples;
+    playPosition = nextReadPosition;
+}
+
+// Copy the longest run starting at position that the ring holds, then check the
+// writer did not overwrite or reset it while it was being copied. Having seen
+// any sample the writer wrote after its fence, the acquire fence guarantees
+// the checks see the start or generation it published before writing it.
+int ReadAheadBuffer::copyFromRing(const AudioSourceChannelInfo& info, int offset, int64 position, int numSamples)
+{
+    const uint32 startGeneration = generation.load(std::memory_order_acquire);
+    const int64 start = validStart.load(std::memory_order_acquire);
+    const int64 end = validEnd.load(std::memory_order_acquire);
+
+    if ((startGeneration & 1) != 0 || position < start || position >= end)
+        return 0;
+
+    const int numToCopy = (int) jmin((int64) numSamples, end - position);
+    const int ringIndex = (int) (position % capacity);
+    const int numBeforeWrap = jmin(numToCopy, capacity - ringIndex);
+    const int numChannels = jmin(2, info.buffer->getNumChannels());
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        info.buffer->copyFrom(channel, info.startSample + offset, ring, channel, ringIndex, numBeforeWrap);
+
+        if (numToCopy > numBeforeWrap)
+            info.buffer->copyFrom(channel, info.startSample + offset + numBeforeWrap, ring, channel, 0, numToCopy - numBeforeWrap);
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (generation.load(std::memory_order_relaxed) != startGeneration
+        || validStart.load(std::memory_order_relaxed) > position)
+        return 0;
+
+    return numToCopy;
+}
+
+int ReadAheadBuffer::copyFromPinned(const AudioSourceChannelInfo& info, int offset, int64 position, int numSamples)
+{
+    const int64 pinStart = pinnedValid.load(std::memory_order_acquire);
+
+    if (pinStart < 0 || position < pinStart || position >= pinStart + pinned.getNumSamples())
+        return 0;
+
+    const int pinIndex = (int) (position - pinStart);
+    const int numToCopy = jmin(numSamples, pinned.getNumSamples() - pinIndex);
+    const int numChannels = jmin(2, info.buffer->getNumChannels());
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        info.buffer->copyFrom(channel, info.startSample + offset, pinned, channel, pinIndex, numToCopy);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    return pinnedValid.load(std::memory_order_relaxed) == pinStart ? numToCopy : 0;
+}
+
+//==============================================================================
+// Jumping outside the ring asks the writer to refill. If the pinned buffer
+// covers the new position, the refill starts where the pinned audio ends so
+// the ring is ready by the time it runs out.
+void ReadAheadBuffer::setNextReadPosition(int64 newPosition)
+{
+    nextReadPosition = newPosition;
+    playPosition = newPosition;
+
+    if (newPosition >= validStart.load() && newPosition <= validEnd.load())
+        return;
+
+    const int64 pinStart = pinnedValid.load();
+    if (pinStart >= 0 && newPosition >= pinStart && newPosition < pinStart + pinned.getNumSamples())
+    {
+        const int64 pinEnd = pinStart + pinned.getNumSamples();
+        if (pinEnd < validStart.load() || pinEnd > validEnd.load())
+            requestRefillFrom(pinEnd);
+    }
+    else
+    {
+        requestRefillFrom(newPosition);
+    }
+}
+
+void ReadAheadBuffer::requestRefillFrom(int64 position)
+{
+    seekRequest = jmin(position, totalLength);
+}
+
+int64 ReadAheadBuffer::getNextReadPosition() const
+{
+    return nextReadPosition;
+}
+
+int64 ReadAheadBuffer::getTotalLength() const
+{
+    return totalLength;
+}
+
+bool ReadAheadBuffer::isLooping() const
+{
+    return false;
+}
@@ -0,0 +1,197 @@
+/*
+==============================================================================
+ReadAheadBuffer.h
+Created: 18 Oct 2026 3:41:09pm
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <atomic>
+
+class ReadAheadBuffer;
+
+//==============================================================================
+/*
+    ReadAheadPool is the set of background threads shared by every
+    ReadAheadBuffer in the process. Each pass refills the most urgent buffer,
+    the one with the least audio left ahead of its playhead, one chunk at a
+    time. A deck that has just seeked or is about to run dry is served before
+    decks that are comfortably ahead.
+
+    Use it through SharedResourcePointer<ReadAheadPool>.
+*/
+class ReadAheadPool
+{
+public:
+    /** Constructor: starts the worker threads */
+    ReadAheadPool();
+
+    /** Destructor: stops the worker threads */
+    ~ReadAheadPool();
+
+    /** Adds a buffer to be kept filled. */
+    void addBuffer(ReadAheadBuffer* buffer);
+
+    /** Removes a buffer, waiting for a fill in progress on it to finish. */
+    void removeBuffer(ReadAheadBuffer* buffer);
+
+    /** Wakes the workers, e.g. after a buffer has been added. */
+    void notify();
+
+    /** Returns the number of worker threads. */
+    int getNumThreads() const;
+
+private:
+    /** Fills one chunk of the most urgent buffer, returning false if none needed it */
+    bool fillMostUrgent();
+
+    class Worker : public Thread
+    {
+    public:
+        Worker(ReadAheadPool& owner, int index);
+        ~Worker() override;
+        void run() override;
+
+    private:
+        ReadAheadPool& pool;
+    };
+
+    CriticalSection lock;
+    Array<ReadAheadBuffer*> buffers;
+    OwnedArray<Worker> workers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ReadAheadPool)
+};
+
+//==============================================================================
+/*
+    ReadAheadBuffer keeps a few seconds of decoded audio ahead of the playhead
+    so the audio thread never touches the disk or the decoder. It wraps a
+    PositionableAudioSource and stores its output in a ring buffer addressed
+    by absolute sample position. The ring is filled by the shared
+    ReadAheadPool threads.
+
+    The audio thread only reads. It never waits for the writer: any part of a
+    block that is not buffered yet is played as silence and counted as an
+    underrun. Part of the ring holds audio behind the playhead, so short
+    jumps backwards are still served from memory. A seek outside the buffered
+    range asks the pool to refill from the new position.
+
+    A "pinned" position, usually the loop start, is kept in its own small
+    buffer. A loop wrapping back further than the ring reaches therefore
+    plays straight on while the ring refills behind it.
+*/
+class ReadAheadBuffer : public PositionableAudioSource
+{
+public:
+    /**
+     * Constructor for ReadAheadBuffer. Allocates the ring and registers with the shared pool.
+     * @param sourceToBuffer The source to read ahead from (not owned). Must not be used elsewhere.
+     * @param sourceSampleRate The sample rate of the source, used to size the ring.
+     * @param secondsToBuffer How much audio the ring holds, in seconds.
+     */
+    ReadAheadBuffer(PositionableAudioSource* sourceToBuffer, double sourceSampleRate, double secondsToBuffer);
+
+    /** Destructor: unregisters from the pool, waiting for a fill in progress to finish */
+    ~ReadAheadBuffer() override;
+
+    //==============================================================================
+    /**
+     * Reads the next chunk from the source into the ring, if it needs one.
+     * Called by the pool threads, and by the track loader to prime a new track.
+     * @return True if any work was done.
+     */
+    bool fillNextChunk();
+
+    /**
+     * Returns how urgently this buffer needs filling, as the number of seconds
+     * buffered ahead of the playhead. A pending seek gives a negative value. A
+     * full buffer gives std::numeric_limits<double>::max().
+     */
+    double getUrgency() const;
+
+    /** Returns how many seconds are buffered ahead of the playhead. */
+    double getBufferedSeconds() const;
+
+    /** Returns how full the ring is ahead of the playhead, from 0.0 to 1.0. */
+    float getFillLevel() const;
+
+    /** Returns the number of blocks that could not be served entirely from memory. */
+    int getNumUnderruns() const;
+
+    /**
+     * Asks for the audio from the given position to be kept in the pinned buffer.
+     * Safe to call on the audio thread every block.
+     * @param position The position in source samples, or -1 for none.
+     */
+    void setPinnedPosition(int64 position);
+
+    //==============================================================================
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
+
+    void setNextReadPosition(int64 newPosition) override;
+    int64 getNextReadPosition() const override;
+    int64 getTotalLength() const override;
+    bool isLooping() const override;
+
+private:
+    friend class ReadAheadPool;
+
+    /** Copies buffered samples for a run of positions, returning how many were available */
+    int copyFromRing(const AudioSourceChannelInfo& info, int offset, int64 position, int numSamples);
+    int copyFromPinned(const AudioSourceChannelInfo& info, int offset, int64 position, int numSamples);
+
+    /** Reads from the source into the ring at the given position, handling the wrap */
+    void readIntoRing(int64 position, int numSamples);
+
+    /** Asks the writer to restart the ring from the given position */
+    void requestRefillFrom(int64 position);
+
+    /** The source being buffered (not owned) */
+    PositionableAudioSource* source;
+
+    const double sampleRate;
+    const int64 totalLength;
+
+    /** Ring capacity, and how much of it is kept behind the playhead */
+    const int capacity;
+    const int historyLength;
+
+    /** Decoded audio, indexed by absolute position modulo capacity */
+    AudioBuffer<float> ring;
+
+    /** The range of absolute positions held in the ring, and a counter that is
+        odd while the range is being reset and bumped again when it is done */
+    std::atomic<int64> validStart{0};
+    std::atomic<int64> validEnd{0};
+    std::atomic<uint32> generation{0};
+
+    /** Where the reader is, published for the writer */
+    std::atomic<int64> playPosition{0};
+
+    /** Position the reader wants the ring restarted from, or -1 if none */
+    std::atomic<int64> seekRequest{-1};
+
+    /** Pinned audio: the requested start, and the start of what the buffer holds (-1 while empty) */
+    AudioBuffer<float> pinned;
+    std::atomic<int64> pinnedRequest{-1};
+    std::atomic<int64> pinnedValid{-1};
+
+    /** Read position, owned by the reader */
+    int64 nextReadPosition = 0;
+
+    std::atomic<int> numUnderruns{0};
+
+    /** Held while filling, so only one thread writes at a time */
+    CriticalSection fillLock;
+
+    /** Keeps the pool alive for as long as this buffer is registered */
+    SharedResourcePointer<ReadAheadPool> pool;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ReadAheadBuffer)
+};
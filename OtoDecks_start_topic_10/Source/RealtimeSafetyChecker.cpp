@@ -0,0 +1,371 @@
+/*
+==============================================================================
+RealtimeSafetyChecker.cpp
+Created: 25 Oct 2026 2:36:08pm
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "RealtimeSafetyChecker.h"
+
+#if OTODECKS_RT_CHECK
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if JUCE_LINUX || JUCE_MAC
+ #include <cxxabi.h>
+ #include <execinfo.h>
+#endif
+
+#if JUCE_LINUX
+ #include <dlfcn.h>
+ #include <pthread.h>
+
+// glibc's own allocator, which the replacements below forward to
+extern "C"
+{
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* pointer, size_t size);
+    void* __libc_memalign(size_t alignment, size_t size);
+    void __libc_free(void* pointer);
+}
+#endif
+
+namespace
+{
+    /** Violations kept with their stacks; later ones are only counted */
+    constexpr int maxViolations = 256;
+    constexpr int maxFrames = 32;
+
+    /** The checker's own frame and the replaced function's, which every stack starts with */
+    constexpr int framesToSkip = 2;
+
+    struct Violation
+    {
+        const char* call;
+        int numFrames;
+        void* frames[maxFrames];
+    };
+
+    // Everything here is zero-initialised, so it is ready before any
+    // constructor runs and nothing in it allocates
+    Violation violations[maxViolations];
+    std::atomic<int> numViolations{0};
+    bool abortOnViolation = false;
+
+    thread_local int realtimeDepth = 0;
+    thread_local int allowedDepth = 0;
+    thread_local bool recording = false;
+
+    int captureStack(void** frames)
+    {
+       #if JUCE_LINUX || JUCE_MAC
+        return backtrace(frames, maxFrames);
+       #else
+        ignoreUnused(frames);
+        return 0;
+       #endif
+    }
+
+    /** Called by every replaced function before it does its work */
+    void check(const char* call)
+    {
+        if (realtimeDepth <= 0 || allowedDepth > 0 || recording)
+            return;
+
+        recording = true;  // backtrace() may allocate the first time it runs
+
+        const int index = numViolations.fetch_add(1, std::memory_order_relaxed);
+        if (index < maxViolations)
+        {
+            auto& violation = violations[index];
+            violation.call = call;
+            violation.numFrames = captureStack(violation.frames);
+        }
+
+        if (abortOnViolation)
+            std::abort();
+
+        recording = false;
+    }
+
+    /** Loads the unwinder and reads the environment before any thread is marked */
+    struct Startup
+    {
+        Startup()
+        {
+            void* frames[maxFrames];
+            captureStack(frames);
+
+            const char* abortSetting = std::getenv("OTODECKS_RT_CHECK_ABORT");
+            abortOnViolation = abortSetting != nullptr && abortSetting[0] == '1';
+        }
+    };
+
+    const Startup startup;
+
+    /** Turns one line of backtrace_symbols() into a readable function name, if it has one */
+    String describeFrame(const char* symbol)
+    {
+        const String line(symbol);
+
+        // Linux: "binary(mangled+0x1f) [0x...]"; macOS: "3   binary   0x...   mangled + 31"
+       #if JUCE_LINUX
+        const String mangled = line.fromFirstOccurrenceOf("(", false, false).upToFirstOccurrenceOf("+", false, false);
+       #else
+        StringArray tokens = StringArray::fromTokens(line, " ", "");
+        tokens.removeEmptyStrings();
+        const String mangled = tokens.size() > 3 ? tokens[3] : String();
+       #endif
+
+       #if JUCE_LINUX || JUCE_MAC
+        int status = 0;
+        if (char* demangled = abi::__cxa_demangle(mangled.toRawUTF8(), nullptr, nullptr, &status))
+        {
+            const String name(demangled);
+            std::free(demangled);
+            return name;
+        }
+       #endif
+
+        return line;
+    }
+
+    bool isSameViolation(const Violation& a, const Violation& b)
+    {
+        if (a.call != b.call || a.numFrames != b.numFrames)
+            return false;
+
+        for (int i = 0; i < a.numFrames; ++i)
+            if (a.frames[i] != b.frames[i])
+                return false;
+
+        return true;
+    }
+
+    /** Plain allocation for the operator new replacements, not seen again by malloc's */
+    void* allocate(size_t size)
+    {
+       #if JUCE_LINUX
+        return __libc_malloc(size);
+       #else
+        return std::malloc(size);
+       #endif
+    }
+
+    void release(void* pointer)
+    {
+       #if JUCE_LINUX
+        __libc_free(pointer);
+       #else
+        std::free(pointer);
+       #endif
+    }
+
+   #if JUCE_LINUX
+    using MutexFunction = int (*)(pthread_mutex_t*);
+
+    /** Finds the next definition of a pthread function, the first time it is needed */
+    MutexFunction getNext(std::atomic<MutexFunction>& function, const char* name)
+    {
+        auto next = function.load(std::memory_order_acquire);
+
+        if (next == nullptr)
+        {
+            next = reinterpret_cast<MutexFunction>(dlsym(RTLD_NEXT, name));
+            function.store(next, std::memory_order_release);
+        }
+
+        return next;
+    }
+
+    std::atomic<MutexFunction> nextMutexLock{nullptr};
+    std::atomic<MutexFunction> nextMutexTryLock{nullptr};
+   #endif
+}
+
+//==============================================================================
+RealtimeSafetyChecker::ScopedRealtimeThread::ScopedRealtimeThread()
+{
+    ++realtimeDepth;
+}
+
+RealtimeSafetyChecker::ScopedRealtimeThread::~ScopedRealtimeThread()
+{
+    --realtimeDepth;
+}
+
+RealtimeSafetyChecker::ScopedAllowed::ScopedAllowed()
+{
+    ++allowedDepth;
+}
+
+RealtimeSafetyChecker::ScopedAllowed::~ScopedAllowed()
+{
+    --allowedDepth;
+}
+
+bool RealtimeSafetyChecker::isEnabled()
+{
+    return true;
+}
+
+int RealtimeSafetyChecker::getNumViolations()
+{
+    return numViolations.load();
+}
+
+//==============================================================================
+// Identical stacks are reported once with a count. Functions that are not
+// exported show as an address, which addr2line or atos can name.
+int RealtimeSafetyChecker::reportViolations()
+{
+    const int total = numViolations.load();
+    const int numKept = jmin(total, maxViolations);
+
+    if (total == 0)
+    {
+        std::cout << "RealtimeSafetyChecker no allocations or locks on real-time threads" << std::endl;
+        return 0;
+    }
+
+    std::cout << "RealtimeSafetyChecker " << total << " allocations or locks on real-time threads" << std::endl;
+
+    Array<bool> reported;
+    reported.insertMultiple(0, false, numKept);
+
+    for (int i = 0; i < numKept; ++i)
+    {
+        if (reported[i])
+            continue;
+
+        int count = 0;
+        for (int j = i; j < numKept; ++j)
+        {
+            if (! reported[j] && isSameViolation(violations[i], violations[j]))
+            {
+                reported.set(j, true);
+                ++count;
+            }
+        }
+
+        const auto& violation = violations[i];
+        std::cout << "  " << count << " x " << violation.call << std::endl;
+
+       #if JUCE_LINUX || JUCE_MAC
+        if (char** symbols = backtrace_symbols(violation.frames, violation.numFrames))
+        {
+            for (int frame = framesToSkip; frame < violation.numFrames; ++frame)
+                std::cout << "      #" << frame - framesToSkip << " " << describeFrame(symbols[frame]) << std::endl;
+
+            std::free(symbols);
+        }
+       #else
+        std::cout << "      (no stacks on this platform)" << std::endl;
+       #endif
+    }
+
+    if (total > maxViolations)
+        std::cout << "  only the first " << maxViolations << " had their stacks recorded" << std::endl;
+
+    return total;
+}
+
+//==============================================================================
+// The replacements. operator new and delete can be replaced on every platform;
+// the C allocator and pthread are interposed only where the dynamic linker
+// lets an executable override them.
+void* operator new(size_t size)
+{
+    check("operator new");
+
+    if (void* pointer = allocate(size))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    if (pointer != nullptr)
+        check("operator delete");
+
+    release(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    if (pointer != nullptr)
+        check("operator delete");
+
+    release(pointer);
+}
+
+#if JUCE_LINUX
+extern "C"
+{
+    void* malloc(size_t size)
+    {
+        check("malloc");
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size)
+    {
+        check("calloc");
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* pointer, size_t size)
+    {
+        check("realloc");
+        return __libc_realloc(pointer, size);
+    }
+
+    void free(void* pointer)
+    {
+        if (pointer != nullptr)
+            check("free");
+
+        __libc_free(pointer);
+    }
+
+    int posix_memalign(void** result, size_t alignment, size_t size)
+    {
+        check("posix_memalign");
+
+        if (alignment % sizeof(void*) != 0 || ! isPowerOfTwo(alignment))
+            return EINVAL;
+
+        void* pointer = __libc_memalign(alignment, size);
+        if (pointer == nullptr)
+            return ENOMEM;
+
+        *result = pointer;
+        return 0;
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size)
+    {
+        check("aligned_alloc");
+        return __libc_memalign(alignment, size);
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t* mutex)
+    {
+        check("pthread_mutex_lock");
+        return getNext(nextMutexLock, "pthread_mutex_lock")(mutex);
+    }
+
+    int pthread_mutex_trylock(pthread_mutex_t* mutex)
+    {
+        check("pthread_mutex_trylock");
+        return getNext(nextMutexTryLock, "pthread_mutex_trylock")(mutex);
+    }
+}
+#endif
+
+#endif
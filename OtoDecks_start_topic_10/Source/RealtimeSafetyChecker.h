@@ -0,0 +1,85 @@
+/*
+==============================================================================
+RealtimeSafetyChecker.h
+Created: 25 Oct 2026 2:36:08pm
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+#ifndef OTODECKS_RT_CHECK
+ #define OTODECKS_RT_CHECK 0
+#endif
+
+//==============================================================================
+/*
+    RealtimeSafetyChecker catches the audio thread allocating memory or taking
+    a lock, either of which can stall it for longer than a block lasts.
+
+    The audio callback, and anything else that must be real-time safe, marks
+    its thread with a ScopedRealtimeThread. In a build with OTODECKS_RT_CHECK
+    set (the CMake option of the same name) the program replaces operator new
+    and delete. On Linux it also replaces malloc, calloc, realloc, free,
+    posix_memalign, aligned_alloc, pthread_mutex_lock and
+    pthread_mutex_trylock. Each replacement checks whether its thread is
+    marked. If it is, the call is recorded with the stack that made it.
+    reportViolations() symbolizes the stacks, prints each distinct one once
+    and returns the count, so a test run can fail on it.
+    OTODECKS_RT_CHECK_ABORT=1 in the environment aborts at the first
+    violation instead, to stop in a debugger.
+
+    Without OTODECKS_RT_CHECK, none of this is built and the scopes cost
+    nothing.
+*/
+class RealtimeSafetyChecker
+{
+public:
+    /** Marks the calling thread as real-time until it is destroyed. Scopes may nest. */
+    class ScopedRealtimeThread
+    {
+    public:
+        ScopedRealtimeThread();
+        ~ScopedRealtimeThread();
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedRealtimeThread)
+    };
+
+    /**
+     * Lets a real-time thread allocate or lock until it is destroyed, for a
+     * call that is known to be harmless or is being measured on purpose.
+     */
+    class ScopedAllowed
+    {
+    public:
+        ScopedAllowed();
+        ~ScopedAllowed();
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedAllowed)
+    };
+
+    /** Returns true if the checker was built in. */
+    static bool isEnabled();
+
+    /** Returns the number of violations so far. */
+    static int getNumViolations();
+
+    /**
+     * Prints every distinct violation recorded, with its count and stack.
+     * Call once the real-time threads have stopped.
+     * @return The number of violations.
+     */
+    static int reportViolations();
+};
+
+#if ! OTODECKS_RT_CHECK
+inline RealtimeSafetyChecker::ScopedRealtimeThread::ScopedRealtimeThread() {}
+inline RealtimeSafetyChecker::ScopedRealtimeThread::~ScopedRealtimeThread() {}
+inline RealtimeSafetyChecker::ScopedAllowed::ScopedAllowed() {}
+inline RealtimeSafetyChecker::ScopedAllowed::~ScopedAllowed() {}
+inline bool RealtimeSafetyChecker::isEnabled() { return false; }
+inline int RealtimeSafetyChecker::getNumViolations() { return 0; }
+inline int RealtimeSafetyChecker::reportViolations() { return 0; }
+#endif
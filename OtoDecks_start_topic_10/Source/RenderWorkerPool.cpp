@@ -0,0 +1,207 @@
+/*
+==============================================================================
+RenderWorkerPool.cpp
+Created: 21 Oct 2026 9:38:14am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "RenderWorkerPool.h"
+#include "RealtimeSafetyChecker.h"
+
+#if JUCE_INTEL
+ #include <emmintrin.h>
+#endif
+
+namespace
+{
+    /** Tells the CPU this is a spin loop, so it saves power and frees resources for its sibling thread */
+    inline void spinPause()
+    {
+       #if JUCE_INTEL
+        _mm_pause();
+       #elif JUCE_ARM && (JUCE_GCC || JUCE_CLANG)
+        __asm__ __volatile__ ("yield");
+       #endif
+    }
+
+    /** How long a worker busy-spins after its last job, then how long it keeps yielding before sleeping */
+    constexpr double spinSeconds = 0.002;
+    constexpr double sleepAfterSeconds = 0.1;
+}
+
+//==============================================================================
+// Constructor: Starts the workers at real-time priority
+RenderWorkerPool::RenderWorkerPool(int numWorkers)
+{
+    for (int i = 0; i < numWorkers; ++i)
+        workers.add(new Worker(*this, i))->startRealtimeThread(Thread::RealtimeOptions{}.withPriority(9));
+}
+
+RenderWorkerPool::~RenderWorkerPool()
+{
+    for (auto* worker : workers)
+    {
+        worker->signalThreadShouldExit();
+        worker->notify();
+    }
+
+    workers.clear();  // Each worker's destructor waits for its thread to stop
+}
+
+int RenderWorkerPool::getNumWorkers() const
+{
+    return workers.size();
+}
+
+//==============================================================================
+// Publish the jobs, wake any sleeping workers, then help out until every job
+// has finished. Everything the jobs need is stored before the ticket, so a
+// worker that claims one sees it.
+void RenderWorkerPool::run(Job& job, int numJobs)
+{
+    if (numJobs <= 0)
+        return;
+
+    currentJob.store(&job, std::memory_order_relaxed);
+    numJobsInGeneration.store(numJobs, std::memory_order_relaxed);
+    numJobsDone.store(0, std::memory_order_relaxed);
+    dispatchTicks.store(Time::getHighResolutionTicks(), std::memory_order_relaxed);
+
+    ++generation;
+    ticket.store((uint64) generation << 32, std::memory_order_release);
+
+    // Waking a sleeping worker takes its event's lock. It is only asleep after
+    // a tenth of a second without work, so this is the first callback of a burst.
+    for (auto* worker : workers)
+    {
+        if (worker->sleeping.load())
+        {
+            const RealtimeSafetyChecker::ScopedAllowed wakeUp;
+            worker->notify();
+        }
+    }
+
+    runJobs(generation);
+
+    while (numJobsDone.load(std::memory_order_acquire) < numJobs)
+        spinPause();
+}
+
+bool RenderWorkerPool::claim(uint32 expectedGeneration, int& index)
+{
+    auto current = ticket.load(std::memory_order_acquire);
+
+    for (;;)
+    {
+        if ((uint32) (current >> 32) != expectedGeneration
+             || (int) (current & 0xffffffff) >= numJobsInGeneration.load(std::memory_order_relaxed))
+            return false;
+
+        if (ticket.compare_exchange_weak(current, current + 1, std::memory_order_acq_rel))
+        {
+            index = (int) (current & 0xffffffff);
+            return true;
+        }
+    }
+}
+
+void RenderWorkerPool::runJobs(uint32 expectedGeneration)
+{
+    const ScopedNoDenormals noDenormals;
+    const RealtimeSafetyChecker::ScopedRealtimeThread realtime;
+    int index = 0;
+
+    while (claim(expectedGeneration, index))
+    {
+        currentJob.load(std::memory_order_relaxed)->runJob(index);
+        numJobsDone.fetch_add(1, std::memory_order_acq_rel);
+    }
+}
+
+//==============================================================================
+void RenderWorkerPool::getWakeUpJitter(double& averageMicros, double& maxMicros) const
+{
+    const int count = numWakeUps.load();
+
+    averageMicros = count > 0 ? Time::highResolutionTicksToSeconds(totalWakeUpTicks.load() / count) * 1.0e6 : 0.0;
+    maxMicros = Time::highResolutionTicksToSeconds(maxWakeUpTicks.load()) * 1.0e6;
+}
+
+void RenderWorkerPool::resetWakeUpJitter()
+{
+    totalWakeUpTicks = 0;
+    maxWakeUpTicks = 0;
+    numWakeUps = 0;
+}
+
+//==============================================================================
+RenderWorkerPool::Worker::Worker(RenderWorkerPool& owner, int index)
+    : Thread("Render Worker " + String(index + 1)),
+      pool(owner),
+      workerIndex(index)
+{
+}
+
+RenderWorkerPool::Worker::~Worker()
+{
+    stopThread(4000);
+}
+
+// Pinned to its own core (core 0 is left to the device thread). While work
+// keeps arriving the worker spins; after spinSeconds it yields between checks,
+// and after sleepAfterSeconds without work it sleeps until the next dispatch.
+void RenderWorkerPool::Worker::run()
+{
+    const int numCpus = jmin(32, SystemStats::getNumCpus());
+    if (numCpus > 1)
+        Thread::setCurrentThreadAffinityMask((uint32) 1 << (1 + workerIndex % (numCpus - 1)));
+
+    const int64 spinTicks = Time::secondsToHighResolutionTicks(spinSeconds);
+    const int64 sleepAfterTicks = Time::secondsToHighResolutionTicks(sleepAfterSeconds);
+
+    uint32 seen = (uint32) (pool.ticket.load() >> 32);
+    int64 idleSince = Time::getHighResolutionTicks();
+
+    while (! threadShouldExit())
+    {
+        const uint32 current = (uint32) (pool.ticket.load(std::memory_order_acquire) >> 32);
+
+        if (current != seen)
+        {
+            seen = current;
+
+            const int64 wakeUpTicks = Time::getHighResolutionTicks() - pool.dispatchTicks.load(std::memory_order_relaxed);
+            pool.totalWakeUpTicks += wakeUpTicks;
+            ++pool.numWakeUps;
+
+            auto worst = pool.maxWakeUpTicks.load();
+            while (wakeUpTicks > worst && ! pool.maxWakeUpTicks.compare_exchange_weak(worst, wakeUpTicks)) {}
+
+            pool.runJobs(seen);
+            idleSince = Time::getHighResolutionTicks();
+            continue;
+        }
+
+        const int64 idleTicks = Time::getHighResolutionTicks() - idleSince;
+
+        if (idleTicks < spinTicks)
+        {
+            spinPause();
+        }
+        else if (idleTicks < sleepAfterTicks)
+        {
+            Thread::yield();
+        }
+        else {
+            // Announce the sleep before the last check, so a dispatch either
+            // sees the flag and notifies, or is seen here
+            sleeping = true;
+
+            if ((uint32) (pool.ticket.load() >> 32) == seen)
+                wait(50);
+
+            sleeping = false;
+        }
+    }
+}
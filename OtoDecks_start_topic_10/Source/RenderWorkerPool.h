@@ -0,0 +1,106 @@
+/*
+==============================================================================
+RenderWorkerPool.h
+Created: 21 Oct 2026 9:38:14am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <atomic>
+
+//==============================================================================
+/*
+    RenderWorkerPool spreads independent pieces of audio work (one per deck)
+    across worker threads for the duration of one audio callback.
+
+    The workers are real-time threads, each pinned to its own core. While
+    callbacks keep coming they spin-wait for work, so picking up a job costs
+    microseconds rather than a scheduler wake-up. After a stretch with no work
+    they go to sleep and are woken by the next dispatch. The calling thread
+    works through the jobs too and returns only when all of them are done.
+
+    Jobs are claimed with a ticket that carries the dispatch generation, so a
+    worker that arrives late can never take a job from the next callback.
+*/
+class RenderWorkerPool
+{
+public:
+    /** A set of numbered jobs to run in parallel */
+    class Job
+    {
+    public:
+        virtual ~Job() = default;
+
+        /** Runs one job. Called once for every index, on any thread in the pool. */
+        virtual void runJob(int index) = 0;
+    };
+
+    /**
+     * Constructor for RenderWorkerPool.
+     * @param numWorkers The number of worker threads, besides the calling thread.
+     */
+    RenderWorkerPool(int numWorkers);
+
+    /** Destructor: stops the workers */
+    ~RenderWorkerPool();
+
+    /**
+     * Runs job.runJob(i) for every i from 0 to numJobs - 1, returning once all have finished.
+     * Does not allocate or lock. Only one thread may dispatch at a time.
+     */
+    void run(Job& job, int numJobs);
+
+    /** Returns the number of worker threads. */
+    int getNumWorkers() const;
+
+    /**
+     * Gets the delay between a dispatch and a worker starting on it.
+     * @param averageMicros Set to the mean over the dispatches since the last reset.
+     * @param maxMicros Set to the worst case since the last reset.
+     */
+    void getWakeUpJitter(double& averageMicros, double& maxMicros) const;
+
+    /** Clears the wake-up statistics. */
+    void resetWakeUpJitter();
+
+private:
+    /** Claims the next job of a generation, returning false when there are none left */
+    bool claim(uint32 generation, int& index);
+
+    /** Runs jobs from the current generation until none are left */
+    void runJobs(uint32 generation);
+
+    class Worker : public Thread
+    {
+    public:
+        Worker(RenderWorkerPool& owner, int index);
+        ~Worker() override;
+        void run() override;
+
+        std::atomic<bool> sleeping{false};
+
+    private:
+        RenderWorkerPool& pool;
+        const int workerIndex;
+    };
+
+    /** Generation in the top 32 bits, next job index in the bottom 32 */
+    std::atomic<uint64> ticket{0};
+    std::atomic<int> numJobsInGeneration{0};
+    std::atomic<int> numJobsDone{0};
+    std::atomic<Job*> currentJob{nullptr};
+    uint32 generation = 0;
+
+    /** When the current generation was dispatched, and wake-up statistics */
+    std::atomic<int64> dispatchTicks{0};
+    std::atomic<int64> totalWakeUpTicks{0};
+    std::atomic<int64> maxWakeUpTicks{0};
+    std::atomic<int> numWakeUps{0};
+
+    OwnedArray<Worker> workers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RenderWorkerPool)
+};
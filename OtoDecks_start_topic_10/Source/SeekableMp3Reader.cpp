@@ -0,0 +1,184 @@
+/*
+==============================================================================
+SeekableMp3Reader.cpp
+Created: 19 Oct 2026 5:34:18pm
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "SeekableMp3Reader.h"
+
+//==============================================================================
+// Constructor: Takes its properties from the full reader and starts the index thread
+SeekableMp3Reader::SeekableMp3Reader(AudioFormatReader* _fullReader, const File& _file, Mp3SeekIndex::Storage _storage)
+    : AudioFormatReader(nullptr, _fullReader->getFormatName()),
+      Thread("MP3 Seek Index"),
+      fullReader(_fullReader),
+      file(_file),
+      storage(_storage)
+{
+    sampleRate = fullReader->sampleRate;
+    bitsPerSample = fullReader->bitsPerSample;
+    lengthInSamples = fullReader->lengthInSamples;
+    numChannels = fullReader->numChannels;
+    usesFloatingPointData = fullReader->usesFloatingPointData;
+    metadataValues = fullReader->metadataValues;
+
+    primingData.calloc((size_t) jmax(1, (int) numChannels) * 1152);
+    primingChannels.calloc((size_t) jmax(1, (int) numChannels));
+
+    for (int channel = 0; channel < (int) numChannels; ++channel)
+        primingChannels[channel] = primingData + channel * 1152;
+
+    startThread();
+}
+
+SeekableMp3Reader::~SeekableMp3Reader()
+{
+    stopThread(4000);
+}
+
+bool SeekableMp3Reader::isIndexReady() const
+{
+    return index.load() != nullptr;
+}
+
+//==============================================================================
+// Index thread. A saved index already carries its alignment; a new one is
+// checked against the decoder before it is used or saved.
+void SeekableMp3Reader::run()
+{
+    auto seekIndex = Mp3SeekIndex::load(file, storage);
+
+    if (seekIndex == nullptr)
+    {
+        seekIndex = Mp3SeekIndex::build(file, [this] { return threadShouldExit(); });
+
+        if (seekIndex == nullptr || threadShouldExit())
+            return;  // Not indexable: keep reading through the full decoder
+
+        seekIndex->setLeadingFrames(detectLeadingFrames(*seekIndex));
+        seekIndex->save(file, storage);
+    }
+
+    builtIndex = std::move(seekIndex);
+    index = builtIndex.get();
+}
+
+//==============================================================================
+// Decode the start of the file both ways and see whether the output from the
+// top of the file is shifted by a frame relative to decoding from frame 0
+int SeekableMp3Reader::detectLeadingFrames(const Mp3SeekIndex& seekIndex)
+{
+    if (! seekIndex.hasInfoFrame())
+        return 0;
+
+    const int samplesPerFrame = seekIndex.getSamplesPerFrame();
+    const int numFramesCompared = jmin(64, seekIndex.getNumFrames());
+    const int numCompared = numFramesCompared * samplesPerFrame;
+    const int64 end = seekIndex.getFrameOffset(jmin(numFramesCompared + 2, seekIndex.getNumFrames()));
+
+    std::unique_ptr<AudioFormatReader> fromStart(createReaderForBytes(0, end));
+    std::unique_ptr<AudioFormatReader> fromFirstFrame(createReaderForBytes(seekIndex.getFrameOffset(0), end));
+
+    if (fromStart == nullptr || fromFirstFrame == nullptr)
+        return 0;
+
+    AudioBuffer<float> startAudio(1, numCompared + samplesPerFrame);
+    AudioBuffer<float> firstFrameAudio(1, numCompared);
+    fromStart->read(&startAudio, 0, startAudio.getNumSamples(), 0, true, false);
+    fromFirstFrame->read(&firstFrameAudio, 0, numCompared, 0, true, false);
+
+    auto difference = [&](int shift)
+    {
+        double total = 0.0;
+        for (int i = 0; i < numCompared; ++i)
+            total += std::abs(startAudio.getSample(0, i + shift) - firstFrameAudio.getSample(0, i));
+        return total;
+    };
+
+    return difference(samplesPerFrame) < difference(0) ? 1 : 0;
+}
+
+AudioFormatReader* SeekableMp3Reader::createReaderForBytes(int64 start, int64 end)
+{
+    auto stream = file.createInputStream();
+
+    if (stream == nullptr || end <= start)
+        return nullptr;
+
+    return mp3Format.createReaderFor(new SubregionStream(stream.release(), start, end - start, true), true);
+}
+
+//==============================================================================
+// Find the frame holding startSample in the index and open a window a few
+// frames before it. Near the top of the file there is nothing to prime from,
+// so the window starts at byte 0, exactly as the full reader does.
+bool SeekableMp3Reader::openWindow(const Mp3SeekIndex& seekIndex, int64 startSample)
+{
+    const int samplesPerFrame = seekIndex.getSamplesPerFrame();
+    const int leadingFrames = seekIndex.getLeadingFrames();
+    const int targetFrame = jlimit(0, seekIndex.getNumFrames() - 1, (int) (startSample / samplesPerFrame) - leadingFrames);
+    const int firstFrame = targetFrame - primingFrames;
+    const int endFrame = jmin(seekIndex.getNumFrames(), targetFrame + windowFrames);
+    const bool fromFileStart = firstFrame < 0;
+
+    window.reset(createReaderForBytes(fromFileStart ? 0 : seekIndex.getFrameOffset(firstFrame),
+                                      seekIndex.getFrameOffset(endFrame)));
+
+    if (window == nullptr)
+        return false;
+
+    windowStartSample = fromFileStart ? 0 : (int64) (firstFrame + leadingFrames) * samplesPerFrame;
+    windowEndSample = (int64) (endFrame + leadingFrames) * samplesPerFrame;
+    windowPosition = windowStartSample;
+
+    while (windowPosition < startSample)
+    {
+        const int numThisTime = (int) jmin((int64) samplesPerFrame, startSample - windowPosition);
+        window->readSamples(primingChannels, (int) numChannels, 0, windowPosition - windowStartSample, numThisTime);
+        windowPosition += numThisTime;
+    }
+
+    return true;
+}
+
+//==============================================================================
+// Sequential reads carry on through the current window; anything else, or
+// running off its end, opens a new one. Past the last indexed frame there is
+// no audio, so the rest is silence.
+bool SeekableMp3Reader::readSamples(int* const* destChannels, int numDestChannels, int startOffsetInDestBuffer,
+                                    int64 startSampleInFile, int numSamples)
+{
+    const auto* seekIndex = index.load();
+
+    if (seekIndex == nullptr)
+        return fullReader->readSamples(destChannels, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+
+    const int64 indexedEnd = (int64) (seekIndex->getNumFrames() + seekIndex->getLeadingFrames()) * seekIndex->getSamplesPerFrame();
+
+    while (numSamples > 0 && startSampleInFile < indexedEnd)
+    {
+        if (window == nullptr || startSampleInFile != windowPosition || startSampleInFile >= windowEndSample)
+            if (! openWindow(*seekIndex, startSampleInFile))
+                return false;
+
+        const int numThisTime = (int) jmin((int64) numSamples, windowEndSample - startSampleInFile);
+
+        if (! window->readSamples(destChannels, numDestChannels, startOffsetInDestBuffer,
+                                  startSampleInFile - windowStartSample, numThisTime))
+            return false;
+
+        windowPosition += numThisTime;
+        startSampleInFile += numThisTime;
+        startOffsetInDestBuffer += numThisTime;
+        numSamples -= numThisTime;
+    }
+
+    if (numSamples > 0)
+        for (int channel = 0; channel < numDestChannels; ++channel)
+            if (destChannels[channel] != nullptr)
+                zeromem(destChannels[channel] + startOffsetInDestBuffer, sizeof(int) * (size_t) numSamples);
+
+    return true;
+}
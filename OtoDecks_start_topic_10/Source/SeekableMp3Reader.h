@@ -0,0 +1,88 @@
+/*
+==============================================================================
+SeekableMp3Reader.h
+Created: 19 Oct 2026 5:34:18pm
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "Mp3SeekIndex.h"
+#include <atomic>
+
+//==============================================================================
+/*
+    SeekableMp3Reader gives an MP3 file constant-time, sample-exact seeks.
+
+    When it is created, a background thread loads or builds the file's
+    Mp3SeekIndex. Until the index is ready, reads go through the ordinary JUCE
+    reader. After that, each read is served from a short window of frames cut
+    out of the file with a SubregionStream and decoded on its own. A seek opens
+    a new window a few frames before the target and decodes those frames
+    without using them, which fills the decoder's bit reservoir and overlap
+    state. The cost of a seek therefore no longer depends on where in the file
+    it lands.
+*/
+class SeekableMp3Reader : public AudioFormatReader,
+                          private Thread
+{
+public:
+    /**
+     * Constructor for SeekableMp3Reader.
+     * @param _fullReader A JUCE reader for the whole file, used until the index is ready. Takes ownership.
+     * @param _file The MP3 file being read.
+     * @param _storage Where the seek index is looked for and saved.
+     */
+    SeekableMp3Reader(AudioFormatReader* _fullReader, const File& _file, Mp3SeekIndex::Storage _storage);
+
+    /** Destructor: abandons an index build in progress */
+    ~SeekableMp3Reader() override;
+
+    bool readSamples(int* const* destChannels, int numDestChannels, int startOffsetInDestBuffer,
+                     int64 startSampleInFile, int numSamples) override;
+
+    /** Returns true once seeks are served from the index. */
+    bool isIndexReady() const;
+
+private:
+    /** Index thread: loads a saved index, or builds, aligns and saves a new one */
+    void run() override;
+
+    /** Works out whether the decoder plays the info frame as a frame of silence */
+    int detectLeadingFrames(const Mp3SeekIndex& seekIndex);
+
+    /** Opens a decoder on a byte range of the file */
+    AudioFormatReader* createReaderForBytes(int64 start, int64 end);
+
+    /** Opens the window holding startSample and primes it up to that sample */
+    bool openWindow(const Mp3SeekIndex& seekIndex, int64 startSample);
+
+    /** Frames decoded and thrown away before the target frame after a seek */
+    static constexpr int primingFrames = 10;
+
+    /** Frames covered by each window after the target frame */
+    static constexpr int windowFrames = 256;
+
+    std::unique_ptr<AudioFormatReader> fullReader;
+    File file;
+    Mp3SeekIndex::Storage storage;
+    MP3AudioFormat mp3Format;
+
+    /** The index, published by the index thread once it is complete */
+    std::unique_ptr<Mp3SeekIndex> builtIndex;
+    std::atomic<Mp3SeekIndex*> index{nullptr};
+
+    /** The window being read, and the file positions of its first sample, next sample and end */
+    std::unique_ptr<AudioFormatReader> window;
+    int64 windowStartSample = 0;
+    int64 windowPosition = 0;
+    int64 windowEndSample = 0;
+
+    /** Somewhere for the decoder to write priming samples */
+    HeapBlock<int> primingData;
+    HeapBlock<int*> primingChannels;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SeekableMp3Reader)
+};
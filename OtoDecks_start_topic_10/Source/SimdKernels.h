@@ -0,0 +1,209 @@
+/*
+==============================================================================
+SimdKernels.h
+Created: 17 Oct 2026 11:02:37am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+#if defined (__AVX__)
+ #define OTODECKS_SIMD_AVX 1
+ #include <immintrin.h>
+#elif defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+ #define OTODECKS_SIMD_SSE 1
+ #include <emmintrin.h>
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__)
+ #define OTODECKS_SIMD_NEON 1
+ #include <arm_neon.h>
+#endif
+
+#if OTODECKS_SIMD_AVX || OTODECKS_SIMD_SSE || OTODECKS_SIMD_NEON
+ #define OTODECKS_SIMD 1
+#else
+ #define OTODECKS_SIMD 0
+#endif
+
+//==============================================================================
+/*
+    Small vectorised kernels used by the audio engine where FloatVectorOperations
+    has no equivalent (dot products for FIR filters and the like). Each kernel
+    uses AVX, SSE or NEON depending on what the compiler targets and falls back
+    to plain scalar code otherwise. Pointers do not need to be aligned.
+
+    Vec4 is a fixed four-lane vector for recursive filters, which run one
+    sample at a time with independent channels side by side in the lanes.
+*/
+namespace SimdKernels
+{
+   #if OTODECKS_SIMD_AVX
+    using Vec = __m256;
+    constexpr int vecSize = 8;
+    inline Vec load(const float* p)                 { return _mm256_loadu_ps(p); }
+    inline Vec broadcast(float v)                   { return _mm256_set1_ps(v); }
+    inline Vec zero()                               { return _mm256_setzero_ps(); }
+    inline Vec mulAdd(Vec acc, Vec a, Vec b)        { return _mm256_add_ps(acc, _mm256_mul_ps(a, b)); }
+
+    inline float sum(Vec v)
+    {
+        auto lo = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+        return _mm_cvtss_f32(_mm_add_ss(lo, _mm_shuffle_ps(lo, lo, 0x1)));
+    }
+   #elif OTODECKS_SIMD_SSE
+    using Vec = __m128;
+    constexpr int vecSize = 4;
+    inline Vec load(const float* p)                 { return _mm_loadu_ps(p); }
+    inline Vec broadcast(float v)                   { return _mm_set1_ps(v); }
+    inline Vec zero()                               { return _mm_setzero_ps(); }
+    inline Vec mulAdd(Vec acc, Vec a, Vec b)        { return _mm_add_ps(acc, _mm_mul_ps(a, b)); }
+
+    inline float sum(Vec v)
+    {
+        v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+        return _mm_cvtss_f32(_mm_add_ss(v, _mm_shuffle_ps(v, v, 0x1)));
+    }
+   #elif OTODECKS_SIMD_NEON
+    using Vec = float32x4_t;
+    constexpr int vecSize = 4;
+    inline Vec load(const float* p)                 { return vld1q_f32(p); }
+    inline Vec broadcast(float v)                   { return vdupq_n_f32(v); }
+    inline Vec zero()                               { return vdupq_n_f32(0.0f); }
+    inline Vec mulAdd(Vec acc, Vec a, Vec b)        { return vmlaq_f32(acc, a, b); }
+
+    inline float sum(Vec v)
+    {
+        auto pair = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+        return vget_lane_f32(vpadd_f32(pair, pair), 0);
+    }
+   #endif
+
+    //==============================================================================
+   #if OTODECKS_SIMD_AVX || OTODECKS_SIMD_SSE
+    using Vec4 = __m128;
+    inline Vec4 set4(float a, float b, float c, float d)   { return _mm_setr_ps(a, b, c, d); }
+    inline Vec4 broadcast4(float v)                         { return _mm_set1_ps(v); }
+    inline Vec4 add4(Vec4 a, Vec4 b)                        { return _mm_add_ps(a, b); }
+    inline Vec4 sub4(Vec4 a, Vec4 b)                        { return _mm_sub_ps(a, b); }
+    inline Vec4 mul4(Vec4 a, Vec4 b)                        { return _mm_mul_ps(a, b); }
+    inline void store4(float* p, Vec4 v)                    { _mm_storeu_ps(p, v); }
+   #elif OTODECKS_SIMD_NEON
+    using Vec4 = float32x4_t;
+    inline Vec4 set4(float a, float b, float c, float d)   { const float lanes[4] = { a, b, c, d }; return vld1q_f32(lanes); }
+    inline Vec4 broadcast4(float v)                         { return vdupq_n_f32(v); }
+    inline Vec4 add4(Vec4 a, Vec4 b)                        { return vaddq_f32(a, b); }
+    inline Vec4 sub4(Vec4 a, Vec4 b)                        { return vsubq_f32(a, b); }
+    inline Vec4 mul4(Vec4 a, Vec4 b)                        { return vmulq_f32(a, b); }
+    inline void store4(float* p, Vec4 v)                    { vst1q_f32(p, v); }
+   #else
+    struct Vec4 { float lane[4]; };
+    inline Vec4 set4(float a, float b, float c, float d)   { return { { a, b, c, d } }; }
+    inline Vec4 broadcast4(float v)                         { return { { v, v, v, v } }; }
+    inline Vec4 add4(Vec4 a, Vec4 b)                        { return { { a.lane[0] + b.lane[0], a.lane[1] + b.lane[1], a.lane[2] + b.lane[2], a.lane[3] + b.lane[3] } }; }
+    inline Vec4 sub4(Vec4 a, Vec4 b)                        { return { { a.lane[0] - b.lane[0], a.lane[1] - b.lane[1], a.lane[2] - b.lane[2], a.lane[3] - b.lane[3] } }; }
+    inline Vec4 mul4(Vec4 a, Vec4 b)                        { return { { a.lane[0] * b.lane[0], a.lane[1] * b.lane[1], a.lane[2] * b.lane[2], a.lane[3] * b.lane[3] } }; }
+    inline void store4(float* p, Vec4 v)                    { for (int i = 0; i < 4; ++i) p[i] = v.lane[i]; }
+   #endif
+
+    //==============================================================================
+    /** Returns the sum of a[i] * x[i] over n samples. */
+    inline float dotProduct(const float* a, const float* x, int n)
+    {
+        int i = 0;
+        float result = 0.0f;
+
+       #if OTODECKS_SIMD
+        auto acc = zero();
+        for (; i + vecSize <= n; i += vecSize)
+            acc = mulAdd(acc, load(a + i), load(x + i));
+        result = sum(acc);
+       #endif
+
+        for (; i < n; ++i)
+            result += a[i] * x[i];
+
+        return result;
+    }
+
+    /** Dot product of one coefficient set against two channels, loading the coefficients once. */
+    inline void dotProductStereo(const float* a, const float* left, const float* right, int n,
+                                 float& outLeft, float& outRight)
+    {
+        int i = 0;
+        outLeft = 0.0f;
+        outRight = 0.0f;
+
+       #if OTODECKS_SIMD
+        auto accLeft = zero();
+        auto accRight = zero();
+        for (; i + vecSize <= n; i += vecSize)
+        {
+            auto coeffs = load(a + i);
+            accLeft = mulAdd(accLeft, coeffs, load(left + i));
+            accRight = mulAdd(accRight, coeffs, load(right + i));
+        }
+        outLeft = sum(accLeft);
+        outRight = sum(accRight);
+       #endif
+
+        for (; i < n; ++i)
+        {
+            outLeft += a[i] * left[i];
+            outRight += a[i] * right[i];
+        }
+    }
+
+    /** Returns the sum of (a[i] + w * b[i]) * x[i]: a dot product with linearly interpolated coefficients. */
+    inline float interpolatedDotProduct(const float* a, const float* b, float w, const float* x, int n)
+    {
+        int i = 0;
+        float result = 0.0f;
+
+       #if OTODECKS_SIMD
+        auto weight = broadcast(w);
+        auto acc = zero();
+        for (; i + vecSize <= n; i += vecSize)
+            acc = mulAdd(acc, mulAdd(load(a + i), load(b + i), weight), load(x + i));
+        result = sum(acc);
+       #endif
+
+        for (; i < n; ++i)
+            result += (a[i] + w * b[i]) * x[i];
+
+        return result;
+    }
+
+    /** Stereo version of interpolatedDotProduct, interpolating the coefficients once for both channels. */
+    inline void interpolatedDotProductStereo(const float* a, const float* b, float w,
+                                             const float* left, const float* right, int n,
+                                             float& outLeft, float& outRight)
+    {
+        int i = 0;
+        outLeft = 0.0f;
+        outRight = 0.0f;
+
+       #if OTODECKS_SIMD
+        auto weight = broadcast(w);
+        auto accLeft = zero();
+        auto accRight = zero();
+        for (; i + vecSize <= n; i += vecSize)
+        {
+            auto coeffs = mulAdd(load(a + i), load(b + i), weight);
+            accLeft = mulAdd(accLeft, coeffs, load(left + i));
+            accRight = mulAdd(accRight, coeffs, load(right + i));
+        }
+        outLeft = sum(accLeft);
+        outRight = sum(accRight);
+       #endif
+
+        for (; i < n; ++i)
+        {
+            auto coeff = a[i] + w * b[i];
+            outLeft += coeff * left[i];
+            outRight += coeff * right[i];
+        }
+    }
+}
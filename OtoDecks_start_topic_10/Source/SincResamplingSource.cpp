@@ -0,0 +1,342 @@
+/*
+==============================================================================
+SincResamplingSource.cpp
+Created: 17 Oct 2026 11:02:37am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "SincResamplingSource.h"
+#include "SimdKernels.h"
+
+namespace
+{
+    //==============================================================================
+    // The history always keeps this many samples either side of the read
+    // position, enough for the widest kernel, so quality can change mid-stream.
+    constexpr int maxHalfTaps = 16;
+
+    // Each quality tier has one table per band. A band's cutoff is lowered by
+    // its ratio, and the band used is the first one at or above the playback
+    // ratio, so reading faster never aliases. The last band is maxRatio.
+    constexpr double bandRatios[] = { 1.0, 1.1, 1.25, 1.4, 1.6, 2.0, 2.5, 3.0, 4.0, 5.0, 6.0, 8.0 };
+    constexpr int numBands = (int) (sizeof(bandRatios) / sizeof(bandRatios[0]));
+    static_assert(bandRatios[numBands - 1] >= SincResamplingSource::maxRatio, "Every supported ratio needs a band");
+
+    struct QualitySpec
+    {
+        int taps;
+        int phases;
+        bool interpolate;
+        double kaiserBeta;
+        double rolloff;
+    };
+
+    const QualitySpec qualitySpecs[] =
+    {
+        {  8, 128, false, 5.0, 0.85 },  // low
+        { 16, 256, true,  7.0, 0.90 },  // medium
+        { 32, 512, true,  9.0, 0.94 }   // high
+    };
+
+    /** One polyphase kernel. For every phase 0..phases it stores the taps followed
+        by the difference to the next phase, so coefficients can be interpolated. */
+    struct KernelTable
+    {
+        int taps = 0;
+        int phases = 0;
+        bool interpolate = false;
+        std::vector<float> coefficients;
+    };
+
+    // Zeroth-order modified Bessel function, for the Kaiser window
+    double besselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+
+        for (int k = 1; k < 64; ++k)
+        {
+            auto factor = x / (2.0 * k);
+            term *= factor * factor;
+            sum += term;
+
+            if (term < 1.0e-12 * sum)
+                break;
+        }
+
+        return sum;
+    }
+
+    KernelTable buildTable(const QualitySpec& spec, double bandRatio)
+    {
+        KernelTable table;
+        table.taps = spec.taps;
+        table.phases = spec.phases;
+        table.interpolate = spec.interpolate;
+
+        const int half = spec.taps / 2;
+        const int stride = spec.taps * 2;
+        const double cutoff = spec.rolloff / bandRatio;
+        const double windowNorm = besselI0(spec.kaiserBeta);
+
+        table.coefficients.assign((size_t) (spec.phases + 1) * (size_t) stride, 0.0f);
+        std::vector<double> row((size_t) spec.taps);
+
+        for (int phase = 0; phase <= spec.phases; ++phase)
+        {
+            double total = 0.0;
+
+            for (int tap = 0; tap < spec.taps; ++tap)
+            {
+                auto x = (double) (tap - (half - 1)) - (double) phase / (double) spec.phases;
+                auto t = x / (double) half;
+                auto window = std::abs(t) < 1.0 ? besselI0(spec.kaiserBeta * std::sqrt(1.0 - t * t)) / windowNorm : 0.0;
+                auto arg = MathConstants<double>::pi * cutoff * x;
+                auto sinc = std::abs(arg) < 1.0e-9 ? 1.0 : std::sin(arg) / arg;
+
+                row[(size_t) tap] = cutoff * sinc * window;
+                total += row[(size_t) tap];
+            }
+
+            // Normalise every phase to unity gain at DC
+            auto* dest = table.coefficients.data() + (size_t) phase * (size_t) stride;
+            for (int tap = 0; tap < spec.taps; ++tap)
+                dest[tap] = (float) (row[(size_t) tap] / total);
+        }
+
+        for (int phase = 0; phase < spec.phases; ++phase)
+        {
+            auto* current = table.coefficients.data() + (size_t) phase * (size_t) stride;
+            auto* next = current + stride;
+
+            for (int tap = 0; tap < spec.taps; ++tap)
+                current[spec.taps + tap] = next[tap] - current[tap];
+        }
+
+        return table;
+    }
+
+    struct KernelTables
+    {
+        KernelTables()
+        {
+            for (int quality = 0; quality < 3; ++quality)
+                for (int band = 0; band < numBands; ++band)
+                    tables[quality][band] = buildTable(qualitySpecs[quality], bandRatios[band]);
+        }
+
+        KernelTable tables[3][numBands];
+    };
+
+    // Built on first use. The constructor of every SincResamplingSource touches
+    // this so that construction never happens on the audio thread.
+    const KernelTable& getKernelTable(int quality, double ratio)
+    {
+        static const KernelTables kernelTables;
+
+        int band = 0;
+        while (band < numBands - 1 && bandRatios[band] < ratio)
+            ++band;
+
+        return kernelTables.tables[jlimit(0, 2, quality)][band];
+    }
+}
+
+//==============================================================================
+// Constructor: Remembers the input and makes sure the shared tables exist
+SincResamplingSource::SincResamplingSource(AudioSource* inputSource, int channels)
+    : input(inputSource),
+      numChannels(jmax(1, channels))
+{
+    getKernelTable((int) Quality::medium, 1.0);
+}
+
+SincResamplingSource::~SincResamplingSource()
+{
+}
+
+//==============================================================================
+// Ratio and quality are published atomically and picked up once per block
+void SincResamplingSource::setResamplingRatio(double samplesInPerOutputSample)
+{
+    ratio = jlimit(minRatio, maxRatio, samplesInPerOutputSample);
+}
+
+double SincResamplingSource::getResamplingRatio() const
+{
+    return ratio.load();
+}
+
+void SincResamplingSource::setQuality(Quality newQuality)
+{
+    quality = (int) newQuality;
+}
+
+SincResamplingSource::Quality SincResamplingSource::getQuality() const
+{
+    return (Quality) quality.load();
+}
+
+//==============================================================================
+// Reset the history to silence, keeping the read position far enough in that
+// the widest kernel has a full window of (silent) past samples
+void SincResamplingSource::flushBuffers()
+{
+    history.clear();
+    numAvailable = maxHalfTaps - 1;
+    readPosition = (double) (maxHalfTaps - 1);
+}
+
+double SincResamplingSource::getInputLookahead() const
+{
+    return (double) numAvailable - readPosition;
+}
+
+//==============================================================================
+// Size the history for the largest chunk at the fastest ratio, so nothing is
+// ever allocated while rendering
+void SincResamplingSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    maxChunkSize = jmax(64, samplesPerBlockExpected);
+
+    const int capacity = 2 * maxHalfTaps + (int) std::ceil(maxChunkSize * maxRatio) + 2;
+    history.setSize(numChannels, capacity);
+    flushBuffers();
+
+    input->prepareToPlay(samplesPerBlockExpected, sampleRate);
+}
+
+void SincResamplingSource::releaseResources()
+{
+    input->releaseResources();
+    history.setSize(numChannels, 0);
+    maxChunkSize = 0;
+}
+
+//==============================================================================
+// Render the block in chunks no longer than the history was sized for
+void SincResamplingSource::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill)
+{
+    if (maxChunkSize == 0)
+    {
+        bufferToFill.clearActiveBufferRegion();
+        return;
+    }
+
+    const double currentRatio = ratio.load();
+    int offset = bufferToFill.startSample;
+    int remaining = bufferToFill.numSamples;
+
+    while (remaining > 0)
+    {
+        const int numThisTime = jmin(remaining, maxChunkSize);
+        renderChunk(AudioSourceChannelInfo(bufferToFill.buffer, offset, numThisTime), currentRatio);
+        offset += numThisTime;
+        remaining -= numThisTime;
+    }
+}
+
+//==============================================================================
+// Pull just enough input to cover the filter window of the last output sample,
+// run the polyphase filter for every output sample, then drop consumed input
+void SincResamplingSource::renderChunk(const AudioSourceChannelInfo& info, double currentRatio)
+{
+    const auto& kernel = getKernelTable(quality.load(), currentRatio);
+    const int taps = kernel.taps;
+    const int half = taps / 2;
+    const int stride = taps * 2;
+    const int numSamples = info.numSamples;
+
+    const int lastNeeded = (int) (readPosition + (numSamples - 1) * currentRatio) + half;
+
+    if (lastNeeded >= numAvailable)
+    {
+        const int numToRead = lastNeeded + 1 - numAvailable;
+        input->getNextAudioBlock(AudioSourceChannelInfo(&history, numAvailable, numToRead));
+        numAvailable += numToRead;
+    }
+
+    const int numOutChannels = jmin(info.buffer->getNumChannels(), numChannels);
+    const float* coefficients = kernel.coefficients.data();
+
+    if (numOutChannels == 2)
+    {
+        auto* left = info.buffer->getWritePointer(0, info.startSample);
+        auto* right = info.buffer->getWritePointer(1, info.startSample);
+        auto* inLeft = history.getReadPointer(0);
+        auto* inRight = history.getReadPointer(1);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const double position = readPosition + i * currentRatio;
+            const int index = (int) position;
+            const double phase = (position - index) * kernel.phases;
+            const int first = index - half + 1;
+
+            if (kernel.interpolate)
+            {
+                const int phaseIndex = (int) phase;
+                auto* taps0 = coefficients + (size_t) phaseIndex * (size_t) stride;
+                SimdKernels::interpolatedDotProductStereo(taps0, taps0 + taps, (float) (phase - phaseIndex),
+                                                          inLeft + first, inRight + first, taps,
+                                                          left[i], right[i]);
+            }
+            else
+            {
+                auto* taps0 = coefficients + (size_t) roundToInt(phase) * (size_t) stride;
+                SimdKernels::dotProductStereo(taps0, inLeft + first, inRight + first, taps, left[i], right[i]);
+            }
+        }
+    }
+    else
+    {
+        for (int channel = 0; channel < numOutChannels; ++channel)
+        {
+            auto* out = info.buffer->getWritePointer(channel, info.startSample);
+            auto* in = history.getReadPointer(channel);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const double position = readPosition + i * currentRatio;
+                const int index = (int) position;
+                const double phase = (position - index) * kernel.phases;
+                const int first = index - half + 1;
+
+                if (kernel.interpolate)
+                {
+                    const int phaseIndex = (int) phase;
+                    auto* taps0 = coefficients + (size_t) phaseIndex * (size_t) stride;
+                    out[i] = SimdKernels::interpolatedDotProduct(taps0, taps0 + taps, (float) (phase - phaseIndex),
+                                                                 in + first, taps);
+                }
+                else
+                {
+                    auto* taps0 = coefficients + (size_t) roundToInt(phase) * (size_t) stride;
+                    out[i] = SimdKernels::dotProduct(taps0, in + first, taps);
+                }
+            }
+        }
+    }
+
+    for (int channel = numOutChannels; channel < info.buffer->getNumChannels(); ++channel)
+        info.buffer->clear(channel, info.startSample, numSamples);
+
+    readPosition += numSamples * currentRatio;
+
+    // Keep maxHalfTaps - 1 samples of history behind the read position
+    const int consumed = (int) readPosition - (maxHalfTaps - 1);
+
+    if (consumed > 0)
+    {
+        const int numToKeep = numAvailable - consumed;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* data = history.getWritePointer(channel);
+            std::memmove(data, data + consumed, (size_t) numToKeep * sizeof(float));
+        }
+
+        numAvailable = numToKeep;
+        readPosition -= consumed;
+    }
+}
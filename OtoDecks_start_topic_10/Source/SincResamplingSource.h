@@ -0,0 +1,111 @@
+/*
+==============================================================================
+SincResamplingSource.h
+Created: 17 Oct 2026 11:02:37am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <atomic>
+
+//==============================================================================
+/*
+    SincResamplingSource is a drop-in replacement for JUCE's ResamplingAudioSource
+    built on a polyphase Kaiser-windowed sinc filter. It plays its input at an
+    arbitrary ratio (input samples consumed per output sample), which covers
+    both varispeed playback and sample-rate conversion in a single pass.
+
+    The filter tables for every quality tier are built once per process and
+    shared by all instances. When reading faster than real time the cutoff is
+    lowered to avoid aliasing. All buffers are allocated in prepareToPlay, so
+    the audio thread never allocates. The inner loop is vectorised (see SimdKernels.h).
+*/
+class SincResamplingSource : public AudioSource
+{
+public:
+    /** Filter quality tiers, trading CPU for passband flatness and stopband rejection */
+    enum class Quality
+    {
+        low,     // 8 taps, nearest phase
+        medium,  // 16 taps, interpolated phases
+        high     // 32 taps, interpolated phases
+    };
+
+    /**
+     * Constructor for SincResamplingSource.
+     * @param inputSource The source to resample (not owned).
+     * @param numChannels The number of channels to process.
+     */
+    SincResamplingSource(AudioSource* inputSource, int numChannels = 2);
+
+    /** Destructor */
+    ~SincResamplingSource() override;
+
+    //==============================================================================
+    /**
+     * Sets the resampling ratio, the number of input samples consumed per output sample.
+     * Values above 1 play faster. Safe to call from any thread.
+     * @param samplesInPerOutputSample The new ratio, clamped to [minRatio, maxRatio].
+     */
+    void setResamplingRatio(double samplesInPerOutputSample);
+
+    /** Returns the current resampling ratio. */
+    double getResamplingRatio() const;
+
+    /**
+     * Selects the filter quality. Safe to call from any thread; takes effect on the next block.
+     * @param newQuality The new quality tier.
+     */
+    void setQuality(Quality newQuality);
+
+    /** Returns the current quality tier. */
+    Quality getQuality() const;
+
+    /** Clears the filter history, e.g. after the input has been repositioned. Audio thread only. */
+    void flushBuffers();
+
+    /**
+     * Returns how many input samples have been read from the input but not yet
+     * played, which is how far the input's read position runs ahead of what is heard.
+     */
+    double getInputLookahead() const;
+
+    /** Slowest and fastest supported ratios; the fastest has a band-limited kernel of its own */
+    static constexpr double minRatio = 1.0 / 64.0;
+    static constexpr double maxRatio = 8.0;
+
+    //==============================================================================
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
+
+private:
+    /** Renders up to maxChunkSize output samples */
+    void renderChunk(const AudioSourceChannelInfo& info, double ratio);
+
+    /** The source being resampled (not owned) */
+    AudioSource* input;
+
+    /** Number of channels kept in the history buffer */
+    const int numChannels;
+
+    std::atomic<double> ratio{1.0};
+    std::atomic<int> quality{(int) Quality::medium};
+
+    /** Input history: the filter reads from a window centred on readPosition */
+    AudioBuffer<float> history;
+
+    /** Fractional index into the history of the next output sample */
+    double readPosition = 0.0;
+
+    /** Number of valid samples in the history */
+    int numAvailable = 0;
+
+    /** Largest number of output samples rendered in one pass, sized in prepareToPlay */
+    int maxChunkSize = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SincResamplingSource)
+};
@@ -0,0 +1,189 @@
+/*
+==============================================================================
+SmoothedParameter.cpp
+Created: 19 Oct 2026 1:27:03pm
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "SmoothedParameter.h"
+
+namespace
+{
+    /** Distance to the target below which an exponential ramp snaps onto it */
+    constexpr float snapThreshold = 1.0e-5f;
+}
+
+//==============================================================================
+// Constructor: Starts at rest on the initial value
+SmoothedParameter::SmoothedParameter(float initialValue)
+    : currentValue(initialValue),
+      targetValue(initialValue)
+{
+    setRampLength(rampSeconds);
+}
+
+void SmoothedParameter::prepare(double newSampleRate, int maxBlockSize)
+{
+    sampleRate = newSampleRate;
+    scratchSize = jmax(1, maxBlockSize);
+    scratch.malloc(scratchSize);
+    setRampLength(rampSeconds);
+}
+
+//==============================================================================
+// The one-pole time constant is a fifth of the ramp, so after the ramp length
+// the glide has covered 1 - e^-5 (over 99%) of the distance
+void SmoothedParameter::setRampLength(double seconds)
+{
+    rampSeconds = jmax(0.0, seconds);
+    rampSamples = roundToInt(rampSeconds * sampleRate);
+    coefficient = rampSamples > 0 ? (float) (1.0 - std::exp(-5.0 / rampSamples)) : 1.0f;
+}
+
+void SmoothedParameter::setCurve(Curve newCurve)
+{
+    curve = newCurve;
+}
+
+void SmoothedParameter::setTargetValue(float newTarget)
+{
+    targetValue = newTarget;
+
+    if (rampSamples <= 0)
+    {
+        setCurrentAndTargetValue(newTarget);
+        return;
+    }
+
+    stepsRemaining = rampSamples;
+    step = (targetValue - currentValue) / (float) rampSamples;
+}
+
+void SmoothedParameter::setCurrentAndTargetValue(float newValue)
+{
+    currentValue = targetValue = newValue;
+    stepsRemaining = 0;
+}
+
+float SmoothedParameter::getCurrentValue() const
+{
+    return currentValue;
+}
+
+float SmoothedParameter::getTargetValue() const
+{
+    return targetValue;
+}
+
+bool SmoothedParameter::isSmoothing() const
+{
+    return currentValue != targetValue;
+}
+
+//==============================================================================
+// Advance one sample along the current curve
+float SmoothedParameter::getNextValue()
+{
+    if (! isSmoothing())
+        return currentValue;
+
+    if (curve == Curve::linear)
+    {
+        if (--stepsRemaining <= 0)
+            currentValue = targetValue;
+        else
+            currentValue += step;
+    }
+    else
+    {
+        currentValue += (targetValue - currentValue) * coefficient;
+
+        if (std::abs(targetValue - currentValue) < snapThreshold)
+            currentValue = targetValue;
+    }
+
+    return currentValue;
+}
+
+void SmoothedParameter::skip(int numSamples)
+{
+    if (! isSmoothing())
+        return;
+
+    if (curve == Curve::linear)
+    {
+        if (numSamples >= stepsRemaining)
+        {
+            currentValue = targetValue;
+            stepsRemaining = 0;
+        }
+        else
+        {
+            currentValue += step * (float) numSamples;
+            stepsRemaining -= numSamples;
+        }
+        return;
+    }
+
+    // The one-pole glide in closed form: the distance left shrinks geometrically
+    currentValue = targetValue + (currentValue - targetValue) * std::pow(1.0f - coefficient, (float) numSamples);
+
+    if (std::abs(targetValue - currentValue) < snapThreshold)
+        currentValue = targetValue;
+}
+
+void SmoothedParameter::fillRamp(float* dest, int numSamples)
+{
+    if (curve == Curve::linear)
+    {
+        // Straight-line part in closed form, which the compiler vectorises
+        const int numRamped = jmin(numSamples, stepsRemaining - 1);
+        const float start = currentValue;
+
+        for (int i = 0; i < numRamped; ++i)
+            dest[i] = start + step * (float) (i + 1);
+
+        if (numRamped > 0)
+        {
+            currentValue = dest[numRamped - 1];
+            stepsRemaining -= numRamped;
+        }
+
+        for (int i = jmax(0, numRamped); i < numSamples; ++i)
+            dest[i] = getNextValue();
+
+        return;
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+        dest[i] = getNextValue();
+}
+
+//==============================================================================
+// At rest the whole region is scaled by one constant; while ramping the
+// per-sample values are written to scratch and multiplied in
+void SmoothedParameter::applyGain(AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    while (numSamples > 0)
+    {
+        if (! isSmoothing() || scratchSize == 0)
+        {
+            if (currentValue != 1.0f)
+                for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                    FloatVectorOperations::multiply(buffer.getWritePointer(channel, startSample), currentValue, numSamples);
+
+            skip(numSamples);
+            return;
+        }
+
+        const int numThisTime = jmin(numSamples, scratchSize);
+        fillRamp(scratch.get(), numThisTime);
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            FloatVectorOperations::multiply(buffer.getWritePointer(channel, startSample), scratch.get(), numThisTime);
+
+        startSample += numThisTime;
+        numSamples -= numThisTime;
+    }
+}
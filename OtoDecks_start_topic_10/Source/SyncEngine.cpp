@@ -0,0 +1,139 @@
+/*
+==============================================================================
+SyncEngine.cpp
+Created: 22 Oct 2026 5:24:09pm
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "SyncEngine.h"
+
+namespace
+{
+    /** How long a phase error takes to close, in seconds; the correction is
+        proportional, so this is the time constant of the lock */
+    constexpr double correctionSeconds = 2.0;
+
+    /** The largest speed change the phase correction may add, as a fraction */
+    constexpr double maxCorrection = 0.02;
+}
+
+//==============================================================================
+// Constructor: Every deck starts free, following deck 1 once synced
+SyncEngine::SyncEngine(const OwnedArray<DJAudioPlayer>& _decks)
+{
+    for (auto* deck : _decks)
+    {
+        decks.add(deck);
+        states.add(new DeckState());
+    }
+}
+
+//==============================================================================
+void SyncEngine::setMaster(int deck)
+{
+    if (deck < 0 || deck >= decks.size())
+    {
+        std::cout << "SyncEngine::setMaster deck should be between 0 and " << decks.size() - 1 << std::endl;
+    }
+    else {
+        master = deck;
+    }
+}
+
+int SyncEngine::getMaster() const
+{
+    return master.load();
+}
+
+void SyncEngine::setSynced(int deck, bool shouldSync)
+{
+    if (deck < 0 || deck >= decks.size())
+    {
+        std::cout << "SyncEngine::setSynced deck should be between 0 and " << decks.size() - 1 << std::endl;
+    }
+    else {
+        states[deck]->synced = shouldSync;
+    }
+}
+
+bool SyncEngine::isSynced(int deck) const
+{
+    return deck >= 0 && deck < decks.size() && states[deck]->synced.load();
+}
+
+void SyncEngine::reset()
+{
+    for (auto* state : states)
+    {
+        state->synced = false;
+        state->phaseError = 0.0;
+        state->engaged = false;
+    }
+
+    master = 0;
+}
+
+double SyncEngine::getPhaseError(int deck) const
+{
+    return deck >= 0 && deck < decks.size() ? states[deck]->phaseError.load() : 0.0;
+}
+
+//==============================================================================
+// Runs between blocks, when no deck is rendering, so every playhead is read at
+// the same sample. Each synced deck is set to the master's tempo, scaled by a
+// whole power of two when its track is at half or double time, and nudged
+// towards the master's beat by a capped amount proportional to the phase error.
+void SyncEngine::process()
+{
+    const int masterIndex = master.load();
+    DJAudioPlayer::BeatInfo masterInfo;
+    const bool masterKnown = decks[masterIndex]->getBeatInfo(masterInfo);
+    const double masterTempo = masterInfo.bpm * masterInfo.speed;
+
+    for (int i = 0; i < decks.size(); ++i)
+    {
+        auto& state = *states.getUnchecked(i);
+        DJAudioPlayer::BeatInfo info;
+
+        const bool follow = state.synced.load() && i != masterIndex && masterKnown && masterTempo > 0.0
+                         && decks.getUnchecked(i)->getBeatInfo(info);
+
+        if (! follow)
+        {
+            if (state.engaged)
+                decks.getUnchecked(i)->releaseSyncSpeed();
+
+            state.engaged = false;
+            state.phaseError = 0.0;
+            continue;
+        }
+
+        // Count the master's beats in one of the deck's: a track at half the master's
+        // tempo spans two master beats with each of its own, and one at double spans half
+        double masterBeatsPerDeckBeat = 1.0;
+
+        while (masterTempo / (info.bpm * masterBeatsPerDeckBeat) > 1.5)
+            masterBeatsPerDeckBeat *= 2.0;
+
+        while (masterTempo / (info.bpm * masterBeatsPerDeckBeat) < 0.75)
+            masterBeatsPerDeckBeat *= 0.5;
+
+        double speed = masterTempo / (info.bpm * masterBeatsPerDeckBeat);
+        double error = 0.0;
+
+        // The gap to the nearest master beat, closed by playing slightly faster or slower
+        if (masterInfo.playing && info.playing)
+        {
+            error = masterInfo.beat - info.beat * masterBeatsPerDeckBeat;
+            error -= std::round(error);
+
+            const double correction = error * 60.0 / (masterTempo * correctionSeconds);
+            speed *= 1.0 + jlimit(-maxCorrection, maxCorrection, correction);
+        }
+
+        decks.getUnchecked(i)->setSyncSpeed(speed);
+        state.engaged = true;
+        state.phaseError = error;
+    }
+}
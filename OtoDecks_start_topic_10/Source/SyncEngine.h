@@ -0,0 +1,99 @@
+/*
+==============================================================================
+SyncEngine.h
+Created: 22 Oct 2026 5:24:09pm
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "DJAudioPlayer.h"
+#include <atomic>
+
+//==============================================================================
+/*
+    SyncEngine locks decks to the tempo and beat phase of a master deck.
+
+    It runs in the audio callback just before the decks are rendered, when
+    every deck's playhead sits exactly at the start of the block. Each
+    synced deck's position on its beatgrid is compared with the master's,
+    and its speed is set to the master's tempo plus a small correction that
+    closes the phase gap over a couple of seconds. The correction is capped,
+    and the speed glides through the deck's own smoother, so drift is taken
+    out continuously without audible jumps. A track at half the master's
+    tempo is matched one of its beats to two of the master's, and a track
+    at double the tempo two of its beats to one.
+
+    The beatgrids come from the background TrackAnalyser. A deck whose tempo
+    is not known yet is left alone until it is. While the master is stopped,
+    synced decks follow its tempo but not its phase.
+
+    Controls are atomics written from the message thread.
+*/
+class SyncEngine
+{
+public:
+    /**
+     * Constructor for SyncEngine.
+     * @param decks The decks that can be synced, which are not owned.
+     */
+    SyncEngine(const OwnedArray<DJAudioPlayer>& decks);
+
+    /**
+     * Chooses the deck the others follow.
+     * @param deck The master's index.
+     */
+    void setMaster(int deck);
+
+    /** Returns the master's index. */
+    int getMaster() const;
+
+    /**
+     * Locks a deck to the master or lets it go. A deck released from sync
+     * glides back to its own speed.
+     * @param deck The deck's index.
+     * @param shouldSync True to follow the master.
+     */
+    void setSynced(int deck, bool shouldSync);
+
+    /** Returns true if a deck is set to follow the master. */
+    bool isSynced(int deck) const;
+
+    /**
+     * Frees every deck and makes the first deck the master, as on a new sync
+     * engine. The decks' speeds are left where they are. Audio thread only, between blocks.
+     */
+    void reset();
+
+    /**
+     * Gets how far a synced deck was from the master's beat phase at the last block.
+     * @param deck The deck's index.
+     * @return The error in beats, from -0.5 to 0.5; positive when the deck is behind.
+     */
+    double getPhaseError(int deck) const;
+
+    /**
+     * Sets the synced decks' speeds for the next block. Call on the audio
+     * thread before the decks are rendered.
+     */
+    void process();
+
+private:
+    /** Sync settings and state for one deck */
+    struct DeckState
+    {
+        std::atomic<bool> synced{false};
+        std::atomic<double> phaseError{0.0};
+
+        /** True while the engine is controlling the deck's speed; audio thread only */
+        bool engaged = false;
+    };
+
+    Array<DJAudioPlayer*> decks;
+    OwnedArray<DeckState> states;
+    std::atomic<int> master{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SyncEngine)
+};
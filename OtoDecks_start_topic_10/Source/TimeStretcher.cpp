@@ -0,0 +1,258 @@
+/*
+==============================================================================
+TimeStretcher.cpp
+Created: 17 Oct 2026 2:18:55pm
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "TimeStretcher.h"
+#include "SimdKernels.h"
+
+//==============================================================================
+// Constructor: Remembers the input, stretching starts out disabled
+TimeStretcher::TimeStretcher(AudioSource* inputSource, int channels)
+    : input(inputSource),
+      numChannels(jmax(1, channels))
+{
+}
+
+TimeStretcher::~TimeStretcher()
+{
+}
+
+//==============================================================================
+// Settings published to the audio thread
+void TimeStretcher::setEnabled(bool shouldStretch)
+{
+    enabled = shouldStretch;
+}
+
+bool TimeStretcher::isEnabled() const
+{
+    return enabled.load();
+}
+
+void TimeStretcher::setTempo(double ratio)
+{
+    tempo = jlimit(minTempo, maxTempo, ratio);
+}
+
+double TimeStretcher::getTempo() const
+{
+    return tempo.load();
+}
+
+//==============================================================================
+// Start again from silence. searchRadius zeros are kept in front of the first
+// real sample so the first search window never reaches before the buffer.
+void TimeStretcher::flushBuffers()
+{
+    inputBuffer.clear();
+    overlapBuffer.clear();
+    outputBuffer.clear();
+
+    if (frameSize > 0)
+        FloatVectorOperations::clear(monoBuffer.get(), inputBuffer.getNumSamples());
+
+    inputStart = 0;
+    numInput = searchRadius;
+    analysisPosition = (double) searchRadius;
+    previousFrameStart = searchRadius - hopSize;
+    outputReadIndex = 0;
+    outputAvailable = 0;
+}
+
+double TimeStretcher::getInputLookahead() const
+{
+    if (! enabled.load() || frameSize == 0)
+        return 0.0;
+
+    // Input read ahead of the next frame, plus the overlap and queued output still to be heard
+    const double heard = analysisPosition - tempo.load() * (double) (frameSize - hopSize + outputAvailable);
+    return jmax(0.0, (double) (inputStart + numInput) - heard);
+}
+
+//==============================================================================
+// Size every buffer for the worst case (fastest tempo) so nothing is allocated
+// while rendering. A 40 ms frame keeps transients tight while still spanning
+// a few periods of bass notes.
+void TimeStretcher::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    frameSize = nextPowerOfTwo(roundToInt(sampleRate * 0.04));
+    hopSize = frameSize / 2;
+    searchRadius = frameSize / 4;
+
+    const int capacity = frameSize * 2 + searchRadius * 2 + (int) std::ceil(hopSize * maxTempo) + 16;
+    inputBuffer.setSize(numChannels, capacity);
+    monoBuffer.malloc(capacity);
+    overlapBuffer.setSize(numChannels, frameSize);
+    outputBuffer.setSize(numChannels, hopSize);
+
+    // Periodic Hann window: copies spaced half a frame apart sum to exactly one
+    window.malloc(frameSize);
+    for (int i = 0; i < frameSize; ++i)
+        window[i] = (float) (0.5 - 0.5 * std::cos(MathConstants<double>::twoPi * i / frameSize));
+
+    flushBuffers();
+    input->prepareToPlay(samplesPerBlockExpected, sampleRate);
+}
+
+void TimeStretcher::releaseResources()
+{
+    input->releaseResources();
+    frameSize = 0;
+}
+
+//==============================================================================
+// Copy finished output hops into the block, synthesising a new frame whenever
+// the previous one has been used up
+void TimeStretcher::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill)
+{
+    if (! enabled.load() || frameSize == 0)
+    {
+        input->getNextAudioBlock(bufferToFill);
+        return;
+    }
+
+    const double currentTempo = tempo.load();
+    const int numOutChannels = jmin(bufferToFill.buffer->getNumChannels(), numChannels);
+    int offset = bufferToFill.startSample;
+    int remaining = bufferToFill.numSamples;
+
+    while (remaining > 0)
+    {
+        if (outputAvailable == 0)
+            synthesiseFrame(currentTempo);
+
+        const int numThisTime = jmin(remaining, outputAvailable);
+
+        for (int channel = 0; channel < numOutChannels; ++channel)
+            bufferToFill.buffer->copyFrom(channel, offset, outputBuffer, channel, outputReadIndex, numThisTime);
+
+        outputReadIndex += numThisTime;
+        outputAvailable -= numThisTime;
+        offset += numThisTime;
+        remaining -= numThisTime;
+    }
+
+    for (int channel = numOutChannels; channel < bufferToFill.buffer->getNumChannels(); ++channel)
+        bufferToFill.buffer->clear(channel, bufferToFill.startSample, bufferToFill.numSamples);
+}
+
+//==============================================================================
+// One WSOLA step: find the best-aligned segment near the nominal position,
+// window it into the overlap-add accumulator, and emit the finished first hop
+void TimeStretcher::synthesiseFrame(double currentTempo)
+{
+    const int64 target = (int64) analysisPosition;
+    const int64 natural = previousFrameStart + hopSize;
+
+    fetchInput(target + searchRadius + frameSize);
+
+    const int64 chosen = target + findBestOffset(natural, target);
+    const int sourceIndex = (int) (chosen - inputStart);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* accumulator = overlapBuffer.getWritePointer(channel);
+        FloatVectorOperations::addWithMultiply(accumulator, inputBuffer.getReadPointer(channel, sourceIndex),
+                                               window.get(), frameSize);
+
+        FloatVectorOperations::copy(outputBuffer.getWritePointer(channel), accumulator, hopSize);
+        std::memmove(accumulator, accumulator + hopSize, (size_t) (frameSize - hopSize) * sizeof(float));
+        FloatVectorOperations::clear(accumulator + frameSize - hopSize, hopSize);
+    }
+
+    outputReadIndex = 0;
+    outputAvailable = hopSize;
+
+    previousFrameStart = chosen;
+    analysisPosition += hopSize * currentTempo;
+
+    discardInputBefore(jmin(chosen + hopSize, (int64) analysisPosition - searchRadius));
+}
+
+//==============================================================================
+// Cross-correlate the natural continuation of the previous frame against the
+// candidates around the target: first every 4th offset, then every offset
+// around the best coarse match. The cost is bounded by the search radius.
+int TimeStretcher::findBestOffset(int64 natural, int64 target) const
+{
+    const int overlapLength = frameSize - hopSize;
+    const int lowest = (int) jmax((int64) -searchRadius, inputStart - target);
+    const int highest = searchRadius;
+
+    const float* reference = monoBuffer.get() + (natural - inputStart);
+    const float* candidates = monoBuffer.get() + (target - inputStart);
+
+    int bestOffset = 0;
+    float bestScore = -std::numeric_limits<float>::max();
+
+    for (int offset = lowest; offset <= highest; offset += 4)
+    {
+        const float score = SimdKernels::dotProduct(reference, candidates + offset, overlapLength);
+        if (score > bestScore)
+        {
+            bestScore = score;
+            bestOffset = offset;
+        }
+    }
+
+    const int coarseBest = bestOffset;
+    for (int offset = jmax(lowest, coarseBest - 3); offset <= jmin(highest, coarseBest + 3); ++offset)
+    {
+        const float score = SimdKernels::dotProduct(reference, candidates + offset, overlapLength);
+        if (score > bestScore)
+        {
+            bestScore = score;
+            bestOffset = offset;
+        }
+    }
+
+    return bestOffset;
+}
+
+//==============================================================================
+// Pull input up to the requested absolute index and extend the mono mix
+void TimeStretcher::fetchInput(int64 endIndex)
+{
+    const int numToRead = (int) jmin(endIndex - (inputStart + numInput),
+                                     (int64) (inputBuffer.getNumSamples() - numInput));
+
+    if (numToRead <= 0)
+        return;
+
+    input->getNextAudioBlock(AudioSourceChannelInfo(&inputBuffer, numInput, numToRead));
+
+    auto* mono = monoBuffer.get() + numInput;
+    FloatVectorOperations::copy(mono, inputBuffer.getReadPointer(0, numInput), numToRead);
+
+    for (int channel = 1; channel < numChannels; ++channel)
+        FloatVectorOperations::add(mono, inputBuffer.getReadPointer(channel, numInput), numToRead);
+
+    numInput += numToRead;
+}
+
+//==============================================================================
+// Shift the input (and its mono mix) down so the buffer starts at the given index
+void TimeStretcher::discardInputBefore(int64 index)
+{
+    const int numToDiscard = (int) jlimit((int64) 0, (int64) numInput, index - inputStart);
+
+    if (numToDiscard == 0)
+        return;
+
+    const int numToKeep = numInput - numToDiscard;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* data = inputBuffer.getWritePointer(channel);
+        std::memmove(data, data + numToDiscard, (size_t) numToKeep * sizeof(float));
+    }
+
+    std::memmove(monoBuffer.get(), monoBuffer.get() + numToDiscard, (size_t) numToKeep * sizeof(float));
+
+    inputStart += numToDiscard;
+    numInput = numToKeep;
+}
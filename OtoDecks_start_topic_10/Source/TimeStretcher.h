@@ -0,0 +1,128 @@
+/*
+==============================================================================
+TimeStretcher.h
+Created: 17 Oct 2026 2:18:55pm
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <atomic>
+
+//==============================================================================
+/*
+    TimeStretcher changes the tempo of its input without changing the pitch,
+    using WSOLA (waveform-similarity overlap-add). For every output hop it
+    looks around the nominal input position for the segment that best lines
+    up with the natural continuation of the previous frame, then overlap-adds
+    it with a Hann window.
+
+    The work per output hop is fixed (one coarse and one fine correlation
+    search of bounded size), so the cost of a block depends only on its
+    length and not on the tempo. All buffers are allocated in prepareToPlay.
+    When disabled the input is passed straight through.
+*/
+class TimeStretcher : public AudioSource
+{
+public:
+    /**
+     * Constructor for TimeStretcher.
+     * @param inputSource The source to stretch (not owned).
+     * @param numChannels The number of channels to process.
+     */
+    TimeStretcher(AudioSource* inputSource, int numChannels = 2);
+
+    /** Destructor */
+    ~TimeStretcher() override;
+
+    //==============================================================================
+    /**
+     * Enables or disables stretching. Call flushBuffers() from the audio thread
+     * when switching so stale audio is not played.
+     * @param shouldStretch True to stretch, false to pass the input through.
+     */
+    void setEnabled(bool shouldStretch);
+
+    /** Returns true if stretching is enabled. */
+    bool isEnabled() const;
+
+    /**
+     * Sets the tempo ratio, the number of input samples consumed per output sample.
+     * Safe to call from any thread.
+     * @param ratio The tempo ratio, clamped to [minTempo, maxTempo].
+     */
+    void setTempo(double ratio);
+
+    /** Returns the current tempo ratio. */
+    double getTempo() const;
+
+    /** Clears all internal buffers, e.g. after the input has been repositioned. Audio thread only. */
+    void flushBuffers();
+
+    /**
+     * Returns approximately how many input samples have been read but not yet
+     * heard, so the caller can report an accurate playhead.
+     */
+    double getInputLookahead() const;
+
+    /** Supported tempo range */
+    static constexpr double minTempo = 0.25;
+    static constexpr double maxTempo = 4.0;
+
+    //==============================================================================
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
+
+private:
+    /** Produces the next hop of output samples into outputBuffer */
+    void synthesiseFrame(double currentTempo);
+
+    /** Returns the offset from target whose segment best continues the previous frame */
+    int findBestOffset(int64 natural, int64 target) const;
+
+    /** Reads from the input until the buffer reaches the given absolute sample index */
+    void fetchInput(int64 endIndex);
+
+    /** Drops buffered input before the given absolute sample index */
+    void discardInputBefore(int64 index);
+
+    /** The source being stretched (not owned) */
+    AudioSource* input;
+
+    /** Number of channels processed */
+    const int numChannels;
+
+    std::atomic<bool> enabled{false};
+    std::atomic<double> tempo{1.0};
+
+    /** Analysis frame length, synthesis hop (half a frame) and search radius in samples */
+    int frameSize = 0;
+    int hopSize = 0;
+    int searchRadius = 0;
+
+    /** Buffered input, its mono mix for the similarity search, and the synthesis window */
+    AudioBuffer<float> inputBuffer;
+    HeapBlock<float> monoBuffer;
+    HeapBlock<float> window;
+
+    /** Overlap-add accumulator (one frame) and the finished hop waiting to be played */
+    AudioBuffer<float> overlapBuffer;
+    AudioBuffer<float> outputBuffer;
+
+    /** Absolute index of inputBuffer's first sample, and how many samples it holds */
+    int64 inputStart = 0;
+    int numInput = 0;
+
+    /** Nominal input position of the next frame, and where the previous frame actually started */
+    double analysisPosition = 0.0;
+    int64 previousFrameStart = 0;
+
+    /** Read position and remaining samples in outputBuffer */
+    int outputReadIndex = 0;
+    int outputAvailable = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TimeStretcher)
+};
@@ -0,0 +1,388 @@
+/*
+==============================================================================
+TrackAnalyser.cpp
+Created: 22 Oct 2026 2:11:45pm
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "TrackAnalyser.h"
+#include "BeatDetector.h"
+#include "KeyDetector.h"
+#include "LoudnessMeter.h"
+#include <vector>
+
+namespace
+{
+    /** Samples decoded and fed to the detectors at a time */
+    constexpr int chunkSize = 65536;
+}
+
+//==============================================================================
+// Constructor: One worker per core. They run at low priority, so decks loading
+// and reading ahead always come first.
+TrackAnalyser::TrackAnalyser()
+{
+    formatManager.registerBasicFormats();
+
+    const int numThreads = jmax(1, SystemStats::getNumCpus());
+
+    for (int i = 0; i < numThreads; ++i)
+        workers.add(new Worker(*this, i))->startThread(Thread::Priority::low);
+}
+
+TrackAnalyser::~TrackAnalyser()
+{
+    cancelPendingUpdate();
+
+    {
+        const ScopedLock sl(lock);
+        queue.clear();
+    }
+
+    for (auto* worker : workers)
+    {
+        worker->signalThreadShouldExit();
+        worker->notify();
+    }
+
+    workers.clear();  // Each worker's destructor waits for its thread to stop
+    cache->save();
+}
+
+//==============================================================================
+void TrackAnalyser::analyse(const File& file, bool urgent)
+{
+    const String path = file.getFullPathName();
+
+    {
+        const ScopedLock sl(lock);
+
+        if (results.count(path) > 0)
+            return;
+
+        if (pending.count(path) > 0)
+        {
+            // Already waiting: an urgent request moves it to the front
+            if (urgent)
+            {
+                for (auto it = queue.begin(); it != queue.end(); ++it)
+                {
+                    if (*it == file)
+                    {
+                        queue.erase(it);
+                        queue.push_front(file);
+                        break;
+                    }
+                }
+            }
+            return;
+        }
+
+        pending.insert(path);
+
+        if (urgent)
+            queue.push_front(file);
+        else
+            queue.push_back(file);
+    }
+
+    for (auto* worker : workers)
+        worker->notify();
+}
+
+bool TrackAnalyser::getAnalysis(const File& file, TrackAnalysis& result) const
+{
+    const ScopedLock sl(lock);
+    const auto entry = results.find(file.getFullPathName());
+
+    if (entry == results.end())
+        return false;
+
+    result = entry->second;
+    return true;
+}
+
+void TrackAnalyser::addListener(Listener* listener)
+{
+    listeners.add(listener);
+}
+
+void TrackAnalyser::removeListener(Listener* listener)
+{
+    listeners.remove(listener);
+}
+
+TrackAnalyser::Stats TrackAnalyser::getStats() const
+{
+    const ScopedLock sl(lock);
+    Stats snapshot = stats;
+    snapshot.numQueued = (int) pending.size();
+    return snapshot;
+}
+
+int TrackAnalyser::getNumThreads() const
+{
+    return workers.size();
+}
+
+//==============================================================================
+// The cache is checked before anything is decoded; an entry missing any kind
+// of analysis is analysed again in full. The last worker to finish a batch
+// logs its throughput and saves the cache.
+bool TrackAnalyser::analyseNext()
+{
+    File file;
+
+    {
+        const ScopedLock sl(lock);
+
+        if (queue.empty())
+            return false;
+
+        file = queue.front();
+        queue.pop_front();
+
+        if (numBusy++ == 0 && batchStartMs == 0.0)
+        {
+            batchStartMs = Time::getMillisecondCounterHiRes();
+            batchAnalysed = 0;
+            batchFromCache = 0;
+        }
+    }
+
+    TrackAnalysis analysis;
+    const String hash = AnalysisCache::getContentHash(file);
+    const bool fromCache = hash.isNotEmpty() && cache->lookup(hash, analysis) && analysis.isComplete();
+    const bool analysed = ! fromCache && hash.isNotEmpty() && analyseFile(file, analysis);
+
+    if (Thread::currentThreadShouldExit())
+        return false;  // Shutting down: the half-done analysis is dropped
+
+    if (analysed)
+        cache->store(hash, analysis);
+
+    bool batchFinished = false;
+    double batchSeconds = 0.0;
+    int numAnalysed = 0;
+    int numFromCache = 0;
+    int64 peakBytes = 0;
+
+    {
+        const ScopedLock sl(lock);
+
+        pending.erase(file.getFullPathName());
+        results[file.getFullPathName()] = analysis;
+        finished.add(file);
+        --numBusy;
+
+        if (fromCache)
+        {
+            ++stats.numFromCache;
+            ++batchFromCache;
+        }
+        else if (analysed)
+        {
+            ++stats.numAnalysed;
+            ++batchAnalysed;
+        }
+        else {
+            ++stats.numFailed;
+        }
+
+        if (queue.empty() && numBusy == 0)
+        {
+            batchFinished = true;
+            batchSeconds = (Time::getMillisecondCounterHiRes() - batchStartMs) / 1000.0;
+            numAnalysed = batchAnalysed;
+            numFromCache = batchFromCache;
+            peakBytes = stats.peakWorkingBytes;
+            batchStartMs = 0.0;
+
+            if (numAnalysed > 0 && batchSeconds > 0.0)
+                stats.tracksPerMinute = numAnalysed * 60.0 / batchSeconds;
+        }
+    }
+
+    triggerAsyncUpdate();
+
+    if (batchFinished)
+    {
+        if (numAnalysed > 0)
+            std::cout << "TrackAnalyser analysed " << numAnalysed << " tracks in " << batchSeconds << " s ("
+                      << numAnalysed * 60.0 / jmax(0.001, batchSeconds) << " tracks/minute on "
+                      << workers.size() << " threads), " << numFromCache << " more from the cache, working memory peak "
+                      << String(peakBytes / (1024.0 * 1024.0), 1) << " MB" << std::endl;
+
+        cache->save();
+    }
+
+    return true;
+}
+
+// Stream the track through the loudness meter, and through both detectors mixed
+// down to mono, a chunk at a time.
+// The memory held is counted as the beat envelope grows, and given back at the end.
+bool TrackAnalyser::analyseFile(const File& file, TrackAnalysis& result)
+{
+    struct WorkingMemory
+    {
+        TrackAnalyser& owner;
+        int64 held = 0;
+
+        void update(int64 bytes) { owner.addWorkingBytes(bytes - held); held = bytes; }
+        ~WorkingMemory() { owner.addWorkingBytes(-held); }
+    };
+
+    WorkingMemory memory{*this};
+    std::vector<float> mono((size_t) chunkSize);
+    std::unique_ptr<BeatDetector> beatDetector;
+    std::unique_ptr<KeyDetector> keyDetector;
+    std::unique_ptr<LoudnessMeter> loudnessMeter;
+    AudioBuffer<float> buffer;
+
+    const auto feed = [&](const float* const* channels, int numChannels, int numSamples)
+    {
+        loudnessMeter->process(channels, numChannels, numSamples);
+
+        FloatVectorOperations::copy(mono.data(), channels[0], numSamples);
+
+        for (int channel = 1; channel < numChannels; ++channel)
+            FloatVectorOperations::add(mono.data(), channels[channel], numSamples);
+
+        if (numChannels > 1)
+            FloatVectorOperations::multiply(mono.data(), 1.0f / (float) numChannels, numSamples);
+
+        beatDetector->process(mono.data(), numSamples);
+        keyDetector->process(mono.data(), numSamples);
+
+        memory.update((int64) (mono.capacity() * sizeof(float))
+                      + (int64) buffer.getNumChannels() * buffer.getNumSamples() * (int64) sizeof(float)
+                      + (int64) beatDetector->getMemoryUsage() + (int64) keyDetector->getMemoryUsage()
+                      + (int64) loudnessMeter->getMemoryUsage());
+    };
+
+    if (auto decoded = decodedCache->find(file))
+    {
+        // Already decoded for a deck: no need to touch the file
+        const auto& audio = decoded->getAudio();
+        beatDetector = std::make_unique<BeatDetector>(decoded->getSampleRate());
+        keyDetector = std::make_unique<KeyDetector>(decoded->getSampleRate());
+        loudnessMeter = std::make_unique<LoudnessMeter>(decoded->getSampleRate());
+
+        for (int start = 0; start < audio.getNumSamples(); start += chunkSize)
+        {
+            const int numSamples = jmin(chunkSize, audio.getNumSamples() - start);
+            const float* channels[2] = { audio.getReadPointer(0, start),
+                                         audio.getReadPointer(jmin(1, audio.getNumChannels() - 1), start) };
+            feed(channels, jmin(2, audio.getNumChannels()), numSamples);
+        }
+    }
+    else {
+        std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(file));
+
+        if (reader == nullptr || reader->sampleRate <= 0.0 || reader->lengthInSamples <= 0)
+            return false;
+
+        beatDetector = std::make_unique<BeatDetector>(reader->sampleRate);
+        keyDetector = std::make_unique<KeyDetector>(reader->sampleRate);
+        loudnessMeter = std::make_unique<LoudnessMeter>(reader->sampleRate);
+        buffer.setSize(jmin(2, (int) reader->numChannels), chunkSize);
+
+        for (int64 start = 0; start < reader->lengthInSamples; start += chunkSize)
+        {
+            if (Thread::currentThreadShouldExit())
+                return false;
+
+            const int numSamples = (int) jmin((int64) chunkSize, reader->lengthInSamples - start);
+            reader->read(&buffer, 0, numSamples, start, true, true);
+            feed(buffer.getArrayOfReadPointers(), buffer.getNumChannels(), numSamples);
+        }
+    }
+
+    BeatDetector::Result beat;
+    result.kinds |= TrackAnalysis::tempo;
+
+    if (beatDetector->analyse(beat))
+    {
+        result.bpm = beat.bpm;
+        result.firstBeatSeconds = beat.firstBeatSeconds;
+        result.beatConfidence = beat.confidence;
+    }
+
+    KeyDetector::Result key;
+    result.kinds |= TrackAnalysis::key;
+
+    if (keyDetector->analyse(key))
+    {
+        result.musicalKey = key.key;
+        result.keyConfidence = key.confidence;
+    }
+
+    // A track too quiet to pass the gate is still marked as analysed, so it is
+    // not decoded again next session, but its audible range stays empty and
+    // hasLoudness() is false: nothing trims it to a loudness never measured
+    LoudnessMeter::Result loudness;
+    result.kinds |= TrackAnalysis::loudness;
+
+    if (loudnessMeter->analyse(loudness))
+    {
+        result.integratedLufs = loudness.integratedLufs;
+        result.truePeakDb = loudness.truePeakDb;
+        result.firstAudibleSample = loudness.firstAudibleSample;
+        result.lastAudibleSample = loudness.lastAudibleSample;
+    }
+
+    return true;
+}
+
+void TrackAnalyser::addWorkingBytes(int64 delta)
+{
+    const ScopedLock sl(lock);
+    workingBytes += delta;
+    stats.peakWorkingBytes = jmax(stats.peakWorkingBytes, workingBytes);
+}
+
+//==============================================================================
+void TrackAnalyser::handleAsyncUpdate()
+{
+    Array<File> files;
+    std::vector<TrackAnalysis> analyses;
+
+    {
+        const ScopedLock sl(lock);
+        files.swapWith(finished);
+
+        for (const auto& file : files)
+            analyses.push_back(results[file.getFullPathName()]);
+    }
+
+    for (int i = 0; i < files.size(); ++i)
+    {
+        const File& file = files.getReference(i);
+        const TrackAnalysis& analysis = analyses[(size_t) i];
+        listeners.call([&](Listener& l) { l.trackAnalysed(file, analysis); });
+    }
+}
+
+//==============================================================================
+TrackAnalyser::Worker::Worker(TrackAnalyser& owner, int index)
+    : Thread("Track Analyser " + String(index + 1)),
+      analyser(owner)
+{
+}
+
+TrackAnalyser::Worker::~Worker()
+{
+    stopThread(10000);
+}
+
+// Work through the queue, then sleep until the next request
+void TrackAnalyser::Worker::run()
+{
+    while (! threadShouldExit())
+    {
+        if (! analyser.analyseNext())
+            wait(-1);
+    }
+}
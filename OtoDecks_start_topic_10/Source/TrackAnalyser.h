@@ -0,0 +1,156 @@
+/*
+==============================================================================
+TrackAnalyser.h
+Created: 22 Oct 2026 2:11:45pm
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "AnalysisCache.h"
+#include "DecodedTrackCache.h"
+#include <deque>
+#include <map>
+#include <set>
+
+//==============================================================================
+/*
+    TrackAnalyser works out the tempo, beatgrid, key and loudness of tracks
+    in the background, one worker thread per core, so a whole library is
+    analysed in parallel.
+
+    Each track is looked up in the AnalysisCache by its content hash first,
+    and only decoded on a miss. Decoding streams the file in chunks through a
+    BeatDetector, a KeyDetector and a LoudnessMeter in a single pass, so
+    memory stays small however long the track is. A track a deck has already
+    decoded into the DecodedTrackCache is analysed from memory instead. The
+    memory the workers' buffers and detectors hold is tracked, and its
+    high-water mark reported.
+
+    Requests are queued in order, but an urgent request (a track just loaded
+    onto a deck) goes to the front. When the queue runs dry the batch's
+    throughput is logged and the cache is saved.
+
+    Use it through SharedResourcePointer<TrackAnalyser>. Requests and
+    lookups are for the message thread, where listeners are called too.
+*/
+class TrackAnalyser : private AsyncUpdater
+{
+public:
+    /** Receives analysis results on the message thread */
+    class Listener
+    {
+    public:
+        virtual ~Listener() = default;
+
+        /** Called when a track's analysis is available, whether computed or found in the cache. */
+        virtual void trackAnalysed(const File& file, const TrackAnalysis& analysis) = 0;
+    };
+
+    /** Counters describing the analyser's work so far */
+    struct Stats
+    {
+        int numAnalysed = 0;    // Decoded and analysed
+        int numFromCache = 0;   // Found in the cache without decoding
+        int numFailed = 0;      // Could not be opened
+        int numQueued = 0;      // Waiting or in progress
+
+        /** Tracks decoded and analysed per minute of wall time, over the last batch */
+        double tracksPerMinute = 0.0;
+
+        /** Most memory the workers' decode buffers and detectors held at once, in bytes */
+        int64 peakWorkingBytes = 0;
+    };
+
+    /** Constructor: starts one worker per core, at low priority */
+    TrackAnalyser();
+
+    /** Destructor: abandons the queue and stops the workers */
+    ~TrackAnalyser() override;
+
+    /**
+     * Queues a track for analysis, unless it has been analysed already or is queued.
+     * @param file The audio file.
+     * @param urgent True to analyse it before everything else waiting.
+     */
+    void analyse(const File& file, bool urgent = false);
+
+    /**
+     * Gets a track's analysis if it is available.
+     * @param file The audio file.
+     * @param result Receives the analysis.
+     * @return True if the track has been analysed this session.
+     */
+    bool getAnalysis(const File& file, TrackAnalysis& result) const;
+
+    /** Registers a listener for results. */
+    void addListener(Listener* listener);
+
+    /** Unregisters a previously added listener. */
+    void removeListener(Listener* listener);
+
+    /** Returns a snapshot of the counters. */
+    Stats getStats() const;
+
+    /** Returns the number of worker threads. */
+    int getNumThreads() const;
+
+private:
+    /** Takes the next queued track and analyses it, returning false if the queue was empty */
+    bool analyseNext();
+
+    /** Decodes a track and runs the analysis on it, returning false if it could not be read */
+    bool analyseFile(const File& file, TrackAnalysis& result);
+
+    /** Counts memory taken (positive) or given back (negative) by a worker, updating the high-water mark */
+    void addWorkingBytes(int64 delta);
+
+    /** Tells the listeners about finished tracks */
+    void handleAsyncUpdate() override;
+
+    class Worker : public Thread
+    {
+    public:
+        Worker(TrackAnalyser& owner, int index);
+        ~Worker() override;
+        void run() override;
+
+    private:
+        TrackAnalyser& analyser;
+    };
+
+    AudioFormatManager formatManager;
+    SharedResourcePointer<AnalysisCache> cache;
+    SharedResourcePointer<DecodedTrackCache> decodedCache;
+
+    mutable CriticalSection lock;
+
+    /** Tracks waiting, the paths queued or in progress, and results by full path */
+    std::deque<File> queue;
+    std::set<String> pending;
+    std::map<String, TrackAnalysis> results;
+
+    /** Finished tracks waiting for the listeners to be told */
+    Array<File> finished;
+
+    /** The batch in progress: tracks being worked on, when it started, and how many were
+        decoded and how many found in the cache */
+    int numBusy = 0;
+    double batchStartMs = 0.0;
+    int batchAnalysed = 0;
+    int batchFromCache = 0;
+
+    /** Memory the workers hold right now */
+    int64 workingBytes = 0;
+
+    Stats stats;
+
+    ListenerList<Listener> listeners;
+
+    /** Workers, declared last so they stop before anything they use */
+    OwnedArray<Worker> workers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackAnalyser)
+};
@@ -0,0 +1,256 @@
+/*
+==============================================================================
+TrackLoader.cpp
+Created: 18 Oct 2026 10:05:12am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "TrackLoader.h"
+#include "SeekableMp3Reader.h"
+
+//==============================================================================
+// Constructor: Starts the loader thread, which sleeps until a load is requested
+TrackLoader::TrackLoader(AudioFormatManager& _formatManager, std::function<void()> _onStateChanged)
+    : Thread("Track Loader"),
+      formatManager(_formatManager),
+      onStateChanged(std::move(_onStateChanged))
+{
+    startThread();
+}
+
+TrackLoader::~TrackLoader()
+{
+    cancel();
+    stopThread(4000);
+}
+
+//==============================================================================
+// Queue a load and wake the thread. Bumping the request id makes any load in
+// progress give up at its next progress check.
+void TrackLoader::load(const URL& audioURL)
+{
+    {
+        const ScopedLock sl(requestLock);
+        requestedURL = audioURL;
+        requestTimeMs = Time::getMillisecondCounterHiRes();
+        hasRequest = true;
+        ++requestId;
+    }
+
+    notify();
+}
+
+void TrackLoader::cancel()
+{
+    const ScopedLock sl(requestLock);
+    hasRequest = false;
+    ++requestId;
+}
+
+void TrackLoader::setReadAheadSeconds(double seconds)
+{
+    readAheadSeconds = seconds;
+}
+
+void TrackLoader::setSeekIndexStorage(Mp3SeekIndex::Storage storage)
+{
+    seekIndexStorage = storage;
+}
+
+void TrackLoader::setAutoCue(bool shouldAutoCue)
+{
+    autoCue = shouldAutoCue;
+}
+
+TrackLoader::State TrackLoader::getState() const
+{
+    return state.load();
+}
+
+double TrackLoader::getProgress() const
+{
+    return progress.load();
+}
+
+int TrackLoader::getNumCancelled() const
+{
+    return numCancelled.load();
+}
+
+std::unique_ptr<LoadedTrack> TrackLoader::takeLoadedTrack()
+{
+    const ScopedLock sl(resultLock);
+    return std::move(loadedTrack);
+}
+
+std::unique_ptr<LoadedTrack> TrackLoader::loadWithSettings(const URL& audioURL)
+{
+    return loadNow(formatManager, audioURL, readAheadSeconds.load(), seekIndexStorage.load(), autoCue.load(),
+                   [](double) { return true; });
+}
+
+//==============================================================================
+// Loader thread: pick up the latest request, load it, and report the outcome
+void TrackLoader::run()
+{
+    while (! threadShouldExit())
+    {
+        URL audioURL;
+        double requestedAt = 0.0;
+        int id = 0;
+        bool haveRequest = false;
+
+        {
+            const ScopedLock sl(requestLock);
+            if (hasRequest)
+            {
+                audioURL = requestedURL;
+                requestedAt = requestTimeMs;
+                id = requestId.load();
+                hasRequest = false;
+                haveRequest = true;
+            }
+        }
+
+        if (! haveRequest)
+        {
+            wait(-1);
+            continue;
+        }
+
+        state = State::loading;
+        progress = 0.0;
+        onStateChanged();
+
+        auto track = loadNow(formatManager, audioURL, readAheadSeconds.load(), seekIndexStorage.load(), autoCue.load(),
+                             [this, id](double newProgress)
+        {
+            progress = newProgress;
+            onStateChanged();
+            return ! threadShouldExit() && requestId.load() == id;
+        });
+
+        if (threadShouldExit() || requestId.load() != id)
+        {
+            // Superseded or cancelled: a newer request, if any, is picked up next time round
+            ++numCancelled;
+            state = State::idle;
+            onStateChanged();
+            continue;
+        }
+
+        const bool succeeded = track != nullptr;
+
+        if (succeeded)
+        {
+            track->requestTimeMs = requestedAt;
+
+            const ScopedLock sl(resultLock);
+            loadedTrack = std::move(track);
+        }
+
+        state = succeeded ? State::finished : State::failed;
+        onStateChanged();
+    }
+}
+
+//==============================================================================
+// Open and probe the file, then fill the first couple of seconds of its
+// read-ahead buffer so the deck has audio the moment it is swapped in
+std::unique_ptr<LoadedTrack> TrackLoader::loadNow(AudioFormatManager& manager,
+                                                  const URL& audioURL,
+                                                  double readAheadSeconds,
+                                                  Mp3SeekIndex::Storage seekIndexStorage,
+                                                  bool autoCue,
+                                                  const std::function<bool(double)>& onProgress)
+{
+    const double startMs = Time::getMillisecondCounterHiRes();
+
+    if (! onProgress(0.0))
+        return nullptr;
+
+    std::unique_ptr<AudioFormatReader> reader(manager.createReaderFor(audioURL.createInputStream(false)));
+
+    if (reader == nullptr || reader->sampleRate <= 0.0 || reader->lengthInSamples <= 0)
+        return nullptr;
+
+    const double openedMs = Time::getMillisecondCounterHiRes();
+
+    // An earlier session's analysis costs a hash of the file, but no decoding
+    TrackAnalysis analysis;
+
+    if (audioURL.isLocalFile())
+    {
+        const String hash = AnalysisCache::getContentHash(audioURL.getLocalFile());
+        SharedResourcePointer<AnalysisCache> analysisCache;
+
+        if (hash.isNotEmpty())
+            analysisCache->lookup(hash, analysis);
+    }
+
+    const int64 startPosition = autoCue && analysis.hasLoudness()
+                              ? jlimit((int64) 0, reader->lengthInSamples, analysis.firstAudibleSample) : 0;
+
+    // Decoded once into the shared cache, the track is played from memory by
+    // every deck. A track not decoded yet is decoded in the background while
+    // it streams, so a miss costs no more to start playing than streaming does.
+    DecodedTrack::Ptr decoded;
+
+    if (audioURL.isLocalFile())
+    {
+        SharedResourcePointer<DecodedTrackCache> cache;
+        decoded = cache->getOrStartDecode(audioURL.getLocalFile(), *reader);
+
+        if (decoded != nullptr && decoded->isComplete())
+        {
+            auto track = std::make_unique<LoadedTrack>();
+            track->sampleRate = reader->sampleRate;
+            track->lengthInSamples = reader->lengthInSamples;
+            track->title = audioURL.getFileName();
+            track->file = audioURL.getLocalFile();
+            track->analysis = analysis;
+            track->startPosition = startPosition;
+            track->cachedSource = std::make_unique<CachedTrackSource>(decoded);
+            track->openDurationMs = openedMs - startMs;
+            track->primeDurationMs = Time::getMillisecondCounterHiRes() - openedMs;
+            return track;
+        }
+    }
+
+    // Long VBR files seek slowly and inexactly through the stock decoder, so
+    // local MP3s get a frame index built alongside playback
+    if (audioURL.isLocalFile() && audioURL.getLocalFile().hasFileExtension(".mp3"))
+        reader.reset(new SeekableMp3Reader(reader.release(), audioURL.getLocalFile(), seekIndexStorage));
+
+    if (! onProgress(0.2))
+        return nullptr;
+
+    auto track = std::make_unique<LoadedTrack>();
+    track->sampleRate = reader->sampleRate;
+    track->lengthInSamples = reader->lengthInSamples;
+    track->title = audioURL.getFileName();
+    track->file = audioURL.isLocalFile() ? audioURL.getLocalFile() : File();
+    track->readerSource = std::make_unique<AudioFormatReaderSource>(reader.release(), true);
+    track->analysis = analysis;
+    track->startPosition = startPosition;
+    track->readAhead = std::make_unique<ReadAheadBuffer>(track->readerSource.get(), track->sampleRate, readAheadSeconds);
+    track->readAhead->setNextReadPosition(startPosition);
+
+    const double primeSeconds = jmin(2.0, (double) (track->lengthInSamples - startPosition) / track->sampleRate);
+
+    while (track->readAhead->getBufferedSeconds() < primeSeconds && track->readAhead->fillNextChunk())
+    {
+        if (! onProgress(0.2 + 0.8 * jmin(1.0, track->readAhead->getBufferedSeconds() / primeSeconds)))
+            return nullptr;
+    }
+
+    // The deck moves over to the decoded audio as the decode overtakes it
+    if (decoded != nullptr)
+        track->cachedSource = std::make_unique<CachedTrackSource>(decoded, track->readAhead.get());
+
+    track->openDurationMs = openedMs - startMs;
+    track->primeDurationMs = Time::getMillisecondCounterHiRes() - openedMs;
+
+    return track;
+}
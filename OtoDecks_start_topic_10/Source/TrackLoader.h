@@ -0,0 +1,206 @@
+/*
+==============================================================================
+TrackLoader.h
+Created: 18 Oct 2026 10:05:12am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "ReadAheadBuffer.h"
+#include "Mp3SeekIndex.h"
+#include "DecodedTrackCache.h"
+#include "AnalysisCache.h"
+#include <atomic>
+#include <functional>
+
+//==============================================================================
+/*
+    A track that has been opened, probed and primed and is ready to be swapped
+    into a deck. Timings are kept so load latency can be reported.
+*/
+struct LoadedTrack
+{
+    /** The reader source, and the read-ahead buffer the deck plays from when streaming */
+    std::unique_ptr<AudioFormatReaderSource> readerSource;
+    std::unique_ptr<ReadAheadBuffer> readAhead;
+
+    /** The shared decoded audio the deck plays from instead, if the track fits the cache.
+        While it is still decoding it streams through the read-ahead buffer. */
+    std::unique_ptr<CachedTrackSource> cachedSource;
+
+    /** Returns the source the deck should play from */
+    PositionableAudioSource* getSource() const
+    {
+        return cachedSource != nullptr ? static_cast<PositionableAudioSource*>(cachedSource.get()) : readAhead.get();
+    }
+
+    /** Returns true once the whole track is decoded and plays from memory alone */
+    bool isInMemory() const
+    {
+        return cachedSource != nullptr && cachedSource->getTrack().isComplete();
+    }
+
+    /** Properties of the file, probed on the loader thread */
+    double sampleRate = 0.0;
+    int64 lengthInSamples = 0;
+    String title;
+
+    /** The local file the track was loaded from, or File() for a remote URL */
+    File file;
+
+    /** The track's analysis from an earlier session, if it was in the AnalysisCache */
+    TrackAnalysis analysis;
+
+    /** Where playback starts, in source samples: the first audible sample when auto-cue is on */
+    int64 startPosition = 0;
+
+    /** Loudness normalisation gain, set by the deck before the track is handed to the audio thread */
+    float trimGain = 1.0f;
+
+    /** Millisecond counter when the load was requested, and time spent opening and priming */
+    double requestTimeMs = 0.0;
+    double openDurationMs = 0.0;
+    double primeDurationMs = 0.0;
+};
+
+//==============================================================================
+/*
+    TrackLoader opens audio files on a background thread so neither the message
+    thread nor the audio thread ever waits on the disk or the decoder. Each load
+    opens a reader and probes its format. Local files that fit the shared
+    DecodedTrackCache are played from memory, decoded once for every deck.
+    Anything else streams, with the first couple of seconds of its read-ahead
+    buffer filled so the deck can play it straight away. So does a track on
+    its first load, while the cache decodes it in the background.
+
+    A track analysed in an earlier session has its analysis picked up from the
+    AnalysisCache by content hash, without decoding anything. With auto-cue on,
+    playback starts at its first audible sample, and that is where the
+    read-ahead buffer is primed from.
+
+    Requesting a new load cancels the one in progress. State changes are
+    signalled through a callback made on the loader thread; the owner picks up
+    the finished track with takeLoadedTrack().
+*/
+class TrackLoader : private Thread
+{
+public:
+    /** What the loader is doing, as last reported */
+    enum class State
+    {
+        idle,
+        loading,
+        finished,
+        failed
+    };
+
+    /**
+     * Constructor for TrackLoader.
+     * @param _formatManager Used to create readers for the files being loaded.
+     * @param _onStateChanged Called on the loader thread whenever progress or state changes.
+     */
+    TrackLoader(AudioFormatManager& _formatManager, std::function<void()> _onStateChanged);
+
+    /** Destructor: cancels any load in progress and stops the thread */
+    ~TrackLoader() override;
+
+    /**
+     * Starts loading a file in the background, cancelling any load in progress.
+     * @param audioURL The file to load.
+     */
+    void load(const URL& audioURL);
+
+    /** Cancels the load in progress, if any. */
+    void cancel();
+
+    /**
+     * Sets the read-ahead depth given to tracks loaded from now on.
+     * @param seconds How much decoded audio each track keeps buffered.
+     */
+    void setReadAheadSeconds(double seconds);
+
+    /**
+     * Sets where MP3 seek indexes are kept for tracks loaded from now on.
+     * @param storage Beside each file, in the application's cache directory, or not kept.
+     */
+    void setSeekIndexStorage(Mp3SeekIndex::Storage storage);
+
+    /**
+     * Sets whether tracks loaded from now on start at their first audible sample, when it is known.
+     * @param shouldAutoCue True to skip silence at the start.
+     */
+    void setAutoCue(bool shouldAutoCue);
+
+    /** Returns the current state. */
+    State getState() const;
+
+    /** Returns the progress of the current load, from 0.0 to 1.0. */
+    double getProgress() const;
+
+    /** Returns the number of loads that have been cancelled so far. */
+    int getNumCancelled() const;
+
+    /**
+     * Takes ownership of the most recently finished track, if any.
+     * @return The loaded track, or nullptr if none is waiting.
+     */
+    std::unique_ptr<LoadedTrack> takeLoadedTrack();
+
+    /**
+     * Loads a file on the calling thread with this loader's settings, leaving
+     * any background load alone.
+     * @param audioURL The file to load.
+     * @return The loaded track, or nullptr if it could not be opened.
+     */
+    std::unique_ptr<LoadedTrack> loadWithSettings(const URL& audioURL);
+
+    //==============================================================================
+    /**
+     * Opens, probes and primes a file on the calling thread. Local MP3 files are
+     * read through a SeekableMp3Reader, which indexes them in the background.
+     * @param manager Used to create the reader.
+     * @param audioURL The file to load.
+     * @param readAheadSeconds The depth of the track's read-ahead buffer.
+     * @param seekIndexStorage Where an MP3 file's seek index is looked for and saved.
+     * @param autoCue True to start at the first audible sample if the analysis cache knows it.
+     * @param onProgress Called with the progress so far; returning false aborts the load.
+     * @return The loaded track, or nullptr if it could not be opened or was aborted.
+     */
+    static std::unique_ptr<LoadedTrack> loadNow(AudioFormatManager& manager,
+                                                const URL& audioURL,
+                                                double readAheadSeconds,
+                                                Mp3SeekIndex::Storage seekIndexStorage,
+                                                bool autoCue,
+                                                const std::function<bool(double)>& onProgress);
+
+private:
+    void run() override;
+
+    AudioFormatManager& formatManager;
+    std::function<void()> onStateChanged;
+
+    /** The request waiting to be picked up by the loader thread */
+    CriticalSection requestLock;
+    URL requestedURL;
+    double requestTimeMs = 0.0;
+    bool hasRequest = false;
+
+    /** Bumped on every request and cancel, so a stale load knows to stop */
+    std::atomic<int> requestId{0};
+
+    std::atomic<State> state{State::idle};
+    std::atomic<double> progress{0.0};
+    std::atomic<int> numCancelled{0};
+    std::atomic<double> readAheadSeconds{4.0};
+    std::atomic<Mp3SeekIndex::Storage> seekIndexStorage{Mp3SeekIndex::Storage::cacheDirectory};
+    std::atomic<bool> autoCue{true};
+
+    /** The finished track, waiting for the owner */
+    CriticalSection resultLock;
+    std::unique_ptr<LoadedTrack> loadedTrack;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackLoader)
+};
@@ -0,0 +1,329 @@
+/*
+==============================================================================
+WaveformCache.cpp
+Created: 26 Oct 2026 11:05:52am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "WaveformCache.h"
+#include "AnalysisCache.h"
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    /** The extension saved pyramids are given, and the only files the trimming touches */
+    const char* const cacheFileExtension = ".wfp";
+}
+
+//==============================================================================
+// Constructor: The pool has a thread per core, at low priority like the
+// analyser's workers, so decks loading and reading ahead always come first.
+WaveformCache::WaveformCache()
+    : pool(ThreadPoolOptions{}.withThreadName("Waveform Builder")
+                              .withNumberOfThreads(jmax(1, SystemStats::getNumCpus()))
+                              .withDesiredThreadPriority(Thread::Priority::low))
+{
+    formatManager.registerBasicFormats();
+
+    loader = std::make_unique<Worker>(*this, "Waveform Loader", &WaveformCache::lookUpNext);
+    builder = std::make_unique<Worker>(*this, "Waveform Cache", &WaveformCache::buildNext);
+    loader->startThread(Thread::Priority::low);
+    builder->startThread(Thread::Priority::low);
+}
+
+WaveformCache::~WaveformCache()
+{
+    cancelPendingUpdate();
+
+    {
+        const ScopedLock sl(lock);
+        lookups.clear();
+        builds.clear();
+    }
+
+    for (auto* worker : { loader.get(), builder.get() })
+    {
+        worker->signalThreadShouldExit();
+        worker->notify();
+    }
+
+    loader.reset();
+    builder.reset();  // Waits for the build in progress to be abandoned
+}
+
+File WaveformCache::getCacheDirectory()
+{
+    return File::getSpecialLocation(File::userApplicationDataDirectory)
+               .getChildFile("OtoDecks")
+               .getChildFile("Waveforms");
+}
+
+//==============================================================================
+WaveformPyramid::Ptr WaveformCache::request(const File& file)
+{
+    const String key = getKey(file);
+
+    {
+        const ScopedLock sl(lock);
+        const auto entry = pyramids.find(key);
+
+        if (entry != pyramids.end())
+        {
+            recent.removeString(key);
+            recent.add(key);
+            return entry->second;
+        }
+
+        if (pending.count(key) > 0)
+            return nullptr;
+
+        pending.insert(key);
+        lookups.push_front(file);
+    }
+
+    loader->notify();
+    return nullptr;
+}
+
+void WaveformCache::addListener(Listener* listener)
+{
+    listeners.add(listener);
+}
+
+void WaveformCache::removeListener(Listener* listener)
+{
+    listeners.remove(listener);
+}
+
+void WaveformCache::setDiskBudget(int64 bytes)
+{
+    diskBudgetBytes = jmax((int64) 0, bytes);
+    trimDisk();
+}
+
+int64 WaveformCache::getDiskBudget() const
+{
+    return diskBudgetBytes.load();
+}
+
+int64 WaveformCache::getBytesInUse() const
+{
+    const ScopedLock sl(lock);
+    return bytesInUse;
+}
+
+//==============================================================================
+// The content hash reads about 200 KB of the track, far less than decoding
+// it. A track that cannot be hashed cannot be saved either, but is still built.
+bool WaveformCache::lookUpNext()
+{
+    File file;
+
+    {
+        const ScopedLock sl(lock);
+
+        if (lookups.empty())
+            return false;
+
+        file = lookups.front();
+        lookups.pop_front();
+    }
+
+    Request request{file, getKey(file), File()};
+    const String hash = AnalysisCache::getContentHash(file);
+
+    if (hash.isNotEmpty())
+    {
+        request.cacheFile = getCacheDirectory().getChildFile(hash + "_" + String::toHexString(file.getSize()) + "_"
+                                                             + String::toHexString(file.getLastModificationTime().toMilliseconds())
+                                                             + cacheFileExtension);
+
+        if (auto pyramid = WaveformPyramid::open(request.cacheFile))
+        {
+            request.cacheFile.setLastModificationTime(Time::getCurrentTime());
+            finish(request, pyramid);
+            return true;
+        }
+    }
+
+    {
+        const ScopedLock sl(lock);
+        builds.push_front(request);
+    }
+
+    builder->notify();
+    return true;
+}
+
+// The build runs outside the lock. A build abandoned for shutdown is dropped
+// without telling anyone.
+bool WaveformCache::buildNext()
+{
+    Request request;
+
+    {
+        const ScopedLock sl(lock);
+
+        if (builds.empty())
+            return false;
+
+        request = builds.front();
+        builds.pop_front();
+    }
+
+    auto* thread = Thread::getCurrentThread();
+    const auto shouldStop = [thread] { return thread->threadShouldExit(); };
+    const double startMs = Time::getMillisecondCounterHiRes();
+    WaveformPyramid::Ptr pyramid;
+
+    if (auto decoded = decodedCache->find(request.file))
+        pyramid = WaveformPyramid::build(decoded->getAudio(), decoded->getSampleRate(), pool);
+    else
+        pyramid = WaveformPyramid::build(request.file, formatManager, pool, shouldStop);
+
+    if (shouldStop())
+        return false;
+
+    if (pyramid != nullptr)
+    {
+        std::cout << "WaveformCache built " << request.file.getFileName() << " (" << String(pyramid->getLengthInSeconds(), 1)
+                  << " s) in " << String(Time::getMillisecondCounterHiRes() - startMs, 1) << " ms on "
+                  << pool.getNumThreads() << " threads, " << pyramid->getSizeInBytes() / 1024 << " KB" << std::endl;
+
+        if (request.cacheFile != File())
+        {
+            if (getCacheDirectory().createDirectory() && pyramid->save(request.cacheFile))
+                trimDisk();
+            else
+                std::cout << "WaveformCache could not save " << request.cacheFile.getFullPathName() << std::endl;
+        }
+    }
+
+    finish(request, pyramid);
+    return true;
+}
+
+void WaveformCache::finish(const Request& request, WaveformPyramid::Ptr pyramid)
+{
+    {
+        const ScopedLock sl(lock);
+
+        pending.erase(request.key);
+        finished.add(request.file);
+        finishedPyramids.add(pyramid);
+
+        if (pyramid != nullptr)
+            store(request.key, pyramid);
+    }
+
+    triggerAsyncUpdate();
+}
+
+// Called with the lock held. A pyramid a display still refers to is kept
+// however old it is.
+void WaveformCache::store(const String& key, WaveformPyramid::Ptr pyramid)
+{
+    pyramids[key] = pyramid;
+    recent.removeString(key);
+    recent.add(key);
+    bytesInUse += pyramid->getSizeInBytes();
+
+    for (int i = 0; i < recent.size() - 1 && bytesInUse > budgetBytes;)
+    {
+        const auto entry = pyramids.find(recent[i]);
+
+        if (entry->second->getReferenceCount() > 1)
+        {
+            ++i;
+            continue;
+        }
+
+        bytesInUse -= entry->second->getSizeInBytes();
+        pyramids.erase(entry);
+        recent.remove(i);
+    }
+}
+
+// The directory is listed afresh each time: it holds one small file per track,
+// and this runs once per build. A file another process has open may refuse to
+// go, and is left for next time.
+void WaveformCache::trimDisk()
+{
+    const ScopedLock sl(diskLock);
+
+    std::vector<std::pair<Time, File>> files;
+    int64 total = 0;
+
+    for (const auto& entry : RangedDirectoryIterator(getCacheDirectory(), false, String("*") + cacheFileExtension))
+    {
+        files.emplace_back(entry.getModificationTime(), entry.getFile());
+        total += entry.getFileSize();
+    }
+
+    if (total <= diskBudgetBytes.load())
+        return;
+
+    std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    for (const auto& [modified, file] : files)
+    {
+        if (total <= diskBudgetBytes.load())
+            break;
+
+        const int64 size = file.getSize();
+
+        if (file.deleteFile())
+            total -= size;
+    }
+}
+
+//==============================================================================
+void WaveformCache::handleAsyncUpdate()
+{
+    Array<File> files;
+    ReferenceCountedArray<WaveformPyramid> built;
+
+    {
+        const ScopedLock sl(lock);
+        files.swapWith(finished);
+        built.swapWith(finishedPyramids);
+    }
+
+    for (int i = 0; i < files.size(); ++i)
+    {
+        const File& file = files.getReference(i);
+        WaveformPyramid::Ptr pyramid = built[i];
+        listeners.call([&](Listener& l) { l.waveformReady(file, pyramid); });
+    }
+}
+
+String WaveformCache::getKey(const File& file)
+{
+    return file.getFullPathName() + "|" + String(file.getSize()) + "|"
+           + String(file.getLastModificationTime().toMilliseconds());
+}
+
+//==============================================================================
+WaveformCache::Worker::Worker(WaveformCache& owner, const String& name, bool (WaveformCache::*job)())
+    : Thread(name),
+      cache(owner),
+      nextJob(job)
+{
+}
+
+WaveformCache::Worker::~Worker()
+{
+    stopThread(10000);
+}
+
+// Work through the queue, then sleep until the next request
+void WaveformCache::Worker::run()
+{
+    while (! threadShouldExit())
+    {
+        if (! (cache.*nextJob)())
+            wait(-1);
+    }
+}
@@ -0,0 +1,170 @@
+/*
+==============================================================================
+WaveformCache.h
+Created: 26 Oct 2026 11:05:52am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "DecodedTrackCache.h"
+#include "WaveformPyramid.h"
+#include <deque>
+#include <map>
+#include <set>
+
+//==============================================================================
+/*
+    WaveformCache builds WaveformPyramids for the decks in the background and
+    keeps them, in memory for this session and on disk between sessions, so
+    a track seen before is drawn as soon as it is loaded.
+
+    On disk each pyramid is a file in the application's data directory,
+    named by the track's content hash (see AnalysisCache), size and
+    modification time, so it follows a track that is moved or renamed. A
+    saved pyramid is memory-mapped rather than read. The directory works to
+    a size cap: when a new pyramid takes it over, the least recently used
+    files are deleted. Using a file sets its modification time, which is
+    what the eviction goes by.
+
+    Requests go through two threads. The first looks the track up on disk,
+    which costs a couple of small reads. Only a miss goes on to the second,
+    which builds the pyramid on a pool with a thread per core, so a slow
+    build never holds up a track that is already cached. Both take the
+    newest request first, since the track just loaded is the one being
+    looked at. A track a deck has already decoded into the
+    DecodedTrackCache is built from memory instead of the file.
+
+    In memory the cache works to a budget too, and evicts the least
+    recently used pyramid no display is holding.
+
+    Use it through SharedResourcePointer<WaveformCache>. Requests are for
+    the message thread, where listeners are called too.
+*/
+class WaveformCache : private AsyncUpdater
+{
+public:
+    /** Receives finished pyramids on the message thread */
+    class Listener
+    {
+    public:
+        virtual ~Listener() = default;
+
+        /** Called when a requested track's pyramid is ready, or could not be built (nullptr). */
+        virtual void waveformReady(const File& file, WaveformPyramid::Ptr pyramid) = 0;
+    };
+
+    /** Constructor: starts the threads and the build pool, at low priority */
+    WaveformCache();
+
+    /** Destructor: abandons the queues and stops the threads */
+    ~WaveformCache() override;
+
+    /**
+     * Gets a track's pyramid if it is in memory, or queues it to be found on disk or built.
+     * @param file The audio file.
+     * @return The pyramid, or nullptr if the listeners will be told when it is ready.
+     */
+    WaveformPyramid::Ptr request(const File& file);
+
+    /** Registers a listener for finished pyramids. */
+    void addListener(Listener* listener);
+
+    /** Unregisters a previously added listener. */
+    void removeListener(Listener* listener);
+
+    /**
+     * Sets the most the saved pyramids may take up on disk, deleting old ones if it has shrunk.
+     * @param bytes The size cap.
+     */
+    void setDiskBudget(int64 bytes);
+
+    /** Returns the disk size cap in bytes. */
+    int64 getDiskBudget() const;
+
+    /** Returns the memory the cached pyramids take up, in bytes. */
+    int64 getBytesInUse() const;
+
+    /** Returns the directory the pyramids are saved in. */
+    static File getCacheDirectory();
+
+private:
+    /** A track on its way through the queues */
+    struct Request
+    {
+        File file;
+        String key;
+        File cacheFile;
+    };
+
+    /** Takes the next track waiting to be looked up on disk, returning false if there was none */
+    bool lookUpNext();
+
+    /** Takes the next track waiting to be built and builds it, returning false if there was none */
+    bool buildNext();
+
+    /** Adds a pyramid to memory under its key and queues it for the listeners */
+    void finish(const Request& request, WaveformPyramid::Ptr pyramid);
+
+    /** Adds a pyramid under its key, evicting old ones beyond the budget */
+    void store(const String& key, WaveformPyramid::Ptr pyramid);
+
+    /** Deletes saved pyramids, least recently used first, until the directory fits the cap */
+    void trimDisk();
+
+    /** Tells the listeners about finished tracks */
+    void handleAsyncUpdate() override;
+
+    /** Returns the identity a file is cached under in memory */
+    static String getKey(const File& file);
+
+    /** Runs one of the queues until asked to stop */
+    class Worker : public Thread
+    {
+    public:
+        Worker(WaveformCache& owner, const String& name, bool (WaveformCache::*job)());
+        ~Worker() override;
+        void run() override;
+
+    private:
+        WaveformCache& cache;
+        bool (WaveformCache::*nextJob)();
+    };
+
+    AudioFormatManager formatManager;
+    SharedResourcePointer<DecodedTrackCache> decodedCache;
+
+    mutable CriticalSection lock;
+
+    /** Tracks waiting to be looked up and to be built, and the keys in either or in progress */
+    std::deque<File> lookups;
+    std::deque<Request> builds;
+    std::set<String> pending;
+
+    /** Cached pyramids by key, and their keys least recently used first */
+    std::map<String, WaveformPyramid::Ptr> pyramids;
+    StringArray recent;
+
+    int64 budgetBytes = (int64) 64 << 20;
+    int64 bytesInUse = 0;
+
+    /** Serialises trimming the directory, which both the builder and setDiskBudget do */
+    CriticalSection diskLock;
+    std::atomic<int64> diskBudgetBytes{(int64) 512 << 20};
+
+    /** Finished tracks waiting for the listeners to be told, with their pyramids */
+    Array<File> finished;
+    ReferenceCountedArray<WaveformPyramid> finishedPyramids;
+
+    ListenerList<Listener> listeners;
+
+    /** The threads each pyramid is built on, and the threads that feed them,
+        declared last so they stop before anything they use */
+    ThreadPool pool;
+    std::unique_ptr<Worker> loader;
+    std::unique_ptr<Worker> builder;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformCache)
+};
@@ -1,101 +1,186 @@
-/*
-==============================================================================
-    WaveformDisplay.h
-    Created: 14 Mar 2020 3:50:16pm
-    Author:  matthew
-==============================================================================
-*/
-
-#pragma once
-
-#include "../JuceLibraryCode/JuceHeader.h"
-
-//==============================================================================
-/*
-    The WaveformDisplay class is responsible for rendering a visual representation
-    of the audio waveform. It includes functionality for horizontal and vertical zoom,
-    as well as the ability to display the playhead position as the track plays.
-    (PERSONAL CONTRIBUTION: Added zoom functionality and dynamic playhead positioning)
-*/
-class WaveformDisplay : public Component, 
-                        public ChangeListener
-{
-public:
-    /**
-     * Constructor for WaveformDisplay.
-     * @param formatManagerToUse Reference to the AudioFormatManager to handle audio formats.
-     * @param cacheToUse Reference to the AudioThumbnailCache for caching waveform thumbnails.
-     */
-    WaveformDisplay(AudioFormatManager& formatManagerToUse,
-                    AudioThumbnailCache& cacheToUse);
-
-    /** Destructor */
-    ~WaveformDisplay() override;
-
-    //==============================================================================
-    /**
-     * Paints the waveform display, including the current playhead position and zoom functionality.
-     * @param g The graphics context used for drawing.
-     */
-    void paint(Graphics& g) override;
-
-    /** Resizes the component and adjusts any child components if necessary. */
-    void resized() override;
-
-    //==============================================================================
-    /**
-     * Called when the waveform data changes (e.g., when the waveform finishes loading).
-     * @param source The broadcaster that triggered the change.
-     */
-    void changeListenerCallback(ChangeBroadcaster* source) override;
-
-    /**
-     * Loads an audio file from a URL and prepares it for waveform visualization.
-     * @param audioURL The URL of the audio file to load.
-     */
-    void loadURL(URL audioURL);
-
-    //==============================================================================
-    /**
-     * Sets the relative position of the playhead within the track.
-     * @param pos The relative position (from 0.0 to 1.0).
-     */
-    void setPositionRelative(double pos);
-
-    //==============================================================================
-    /**
-     * Sets the horizontal zoom level for the waveform.
-     * (PERSONAL CONTRIBUTION: Added zoom functionality for precise waveform navigation)
-     * @param zoom The zoom level, where 1.0 represents no zoom and values greater than 1.0 zoom in.
-     */
-    void setZoomLevel(double zoom);
-
-    /**
-     * Sets the vertical zoom level to scale the height of the waveform.
-     * (PERSONAL CONTRIBUTION: Added vertical zoom functionality)
-     * @param verticalZoom The vertical zoom level.
-     */
-    void setVerticalZoom(double verticalZoom);
-
-private:
-    /** AudioThumbnail object to store and render the waveform */
-    AudioThumbnail audioThumb;
-
-    /** Flag to indicate whether a file has been successfully loaded */
-    bool fileLoaded;
-
-    /** Current playhead position relative to the track length (from 0.0 to 1.0) */
-    double position;
-
-    /** Horizontal zoom level (1.0 means no zoom, greater values zoom in) */
-    double zoomLevel = 1.0;
-
-    /** Vertical zoom level (1.0 means normal height, greater values stretch the waveform vertically) */
-    double verticalZoom = 1.0;
-
-    /** Variables to control the visible portion of the waveform during zooming */
-    double visibleStart = 0.0;  // Start of the visible waveform (as a fraction of the total length)
-    double visibleEnd = 1.0;    // End of the visible waveform (as a fraction of the total length)
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformDisplay)
-};
+/*
+==============================================================================
+    WaveformDisplay.h
+    Created: 14 Mar 2020 3:50:16pm
+    Author:  matthew
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "WaveformCache.h"
+#include <map>
+#include <vector>
+
+//==============================================================================
+/*
+    The WaveformDisplay class is responsible for rendering a visual representation
+    of the audio waveform. It includes functionality for horizontal and vertical zoom,
+    as well as the ability to display the playhead position as the track plays.
+    (PERSONAL CONTRIBUTION: Added zoom functionality and dynamic playhead positioning)
+
+    The waveform is drawn from the track's WaveformPyramid, one column per
+    pixel, so drawing costs the same at any zoom and for any track length.
+    Each column is coloured by the balance of its low, mid and high bands,
+    red, green and blue, so kicks, vocals and hats can be told apart.
+
+    The zoom is drawn in fixed steps, an eighth of an octave apart. The
+    columns are drawn once into an image for each step, and a repaint only
+    copies the image. The most recently used steps keep their images, so
+    zooming back to one is only a copy. When a zoomed view scrolls with the
+    playhead, the image is shifted and only the newly exposed columns are
+    drawn. The playhead is a separate two-pixel component on top, moved
+    on every display refresh, so moving it repaints only where it was and
+    where it is.
+*/
+class WaveformDisplay : public Component, 
+                        public WaveformCache::Listener
+{
+public:
+    /** Constructor for WaveformDisplay. */
+    WaveformDisplay();
+
+    /** Destructor */
+    ~WaveformDisplay() override;
+
+    //==============================================================================
+    /**
+     * Paints the waveform display, including the current playhead position and zoom functionality.
+     * @param g The graphics context used for drawing.
+     */
+    void paint(Graphics& g) override;
+
+    /** Resizes the component and adjusts any child components if necessary. */
+    void resized() override;
+
+    //==============================================================================
+    /**
+     * Called when a track's waveform has been built in the background.
+     * @param file The track the waveform belongs to.
+     * @param pyramid The waveform, or nullptr if the track could not be read.
+     */
+    void waveformReady(const File& file, WaveformPyramid::Ptr pyramid) override;
+
+    /**
+     * Loads an audio file from a URL and prepares it for waveform visualization.
+     * @param audioURL The URL of the audio file to load.
+     */
+    void loadURL(URL audioURL);
+
+    //==============================================================================
+    /**
+     * Sets the relative position of the playhead within the track.
+     * @param pos The relative position (from 0.0 to 1.0).
+     */
+    void setPositionRelative(double pos);
+
+    /**
+     * Sets where the playhead position is read from on every display refresh.
+     * @param source Returns the relative position (from 0.0 to 1.0).
+     */
+    void setPositionSource(std::function<double()> source);
+
+    //==============================================================================
+    /**
+     * Sets the horizontal zoom level for the waveform.
+     * (PERSONAL CONTRIBUTION: Added zoom functionality for precise waveform navigation)
+     * @param zoom The zoom level, where 1.0 represents no zoom and values greater than 1.0 zoom in.
+     */
+    void setZoomLevel(double zoom);
+
+    /**
+     * Sets the vertical zoom level to scale the height of the waveform.
+     * (PERSONAL CONTRIBUTION: Added vertical zoom functionality)
+     * @param verticalZoom The vertical zoom level.
+     */
+    void setVerticalZoom(double verticalZoom);
+
+private:
+    /** The waveform drawn at one zoom step. Column x of the image is column
+        firstColumn + x of the whole track drawn at that zoom. */
+    struct Raster
+    {
+        Image image;
+        double secondsPerColumn = 0.0;
+        int64 firstColumn = 0;
+
+        /** When the raster was last drawn from, as a count of getRaster() calls */
+        uint32 lastUsed = 0;
+    };
+
+    /** The playhead line, moved over the waveform rather than painted into it */
+    class Playhead : public Component
+    {
+    public:
+        Playhead();
+        void paint(Graphics& g) override;
+    };
+
+    /** Returns the zoom step nearest the zoom level, 0 for no zoom */
+    int getZoomStep() const;
+
+    /** Returns the zoom the waveform is drawn at: the zoom level rounded to its step */
+    double getDrawnZoom() const;
+
+    /** Centres the visible range on the playhead, shifted to stay within the track */
+    void updateVisibleRange();
+
+    /** Returns the track column the view starts at, for the current zoom */
+    int64 getFirstVisibleColumn(double secondsPerColumn) const;
+
+    /** Returns the current zoom's raster, made or scrolled to the visible range */
+    Raster& getRaster();
+
+    /** Draws a run of a raster's columns from the pyramid */
+    void drawColumns(Raster& raster, int x, int width);
+
+    /** Throws away every raster, when the track, the size or the vertical zoom changes */
+    void clearRasters();
+
+    /** Moves the playhead component to the position, and shows it if a waveform is drawn */
+    void updatePlayhead();
+
+    /** Builds and keeps the waveforms of every deck */
+    SharedResourcePointer<WaveformCache> waveformCache;
+
+    /** The loaded track, and its waveform once it has been built */
+    File file;
+    WaveformPyramid::Ptr pyramid;
+
+    /** One bin per column drawn, refilled for each run of columns */
+    std::vector<WaveformBin> columns;
+
+    /** The rasters by zoom step, kept so zooming back out and in again is only a copy */
+    std::map<int, Raster> rasters;
+    uint32 rasterUseCount = 0;
+
+    Playhead playhead;
+
+    /** Reads the playhead position on each refresh, if set */
+    std::function<double()> positionSource;
+
+    /** Flag to indicate whether a file has been successfully loaded */
+    bool fileLoaded;
+
+    /** Set when the cache could not build the loaded track's waveform */
+    bool drawFailed = false;
+
+    /** Current playhead position relative to the track length (from 0.0 to 1.0) */
+    double position;
+
+    /** Horizontal zoom level (1.0 means no zoom, greater values zoom in) */
+    double zoomLevel = 1.0;
+
+    /** Vertical zoom level (1.0 means normal height, greater values stretch the waveform vertically) */
+    double verticalZoom = 1.0;
+
+    /** Variables to control the visible portion of the waveform during zooming */
+    double visibleStart = 0.0;  // Start of the visible waveform (as a fraction of the total length)
+    double visibleEnd = 1.0;    // End of the visible waveform (as a fraction of the total length)
+
+    /** Calls positionSource in step with the display, declared last so it stops first */
+    VBlankAttachment vBlankAttachment;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformDisplay)
+};
@@ -0,0 +1,446 @@
+/*
+==============================================================================
+WaveformPyramid.cpp
+Created: 26 Oct 2026 9:47:21am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#include "WaveformPyramid.h"
+#include "DeckEqualiser.h"
+#include "SimdKernels.h"
+
+namespace
+{
+    /** Bins decoded from a reader at a time */
+    constexpr int binsPerChunk = 1024;
+
+    /** The shortest segment worth a thread of its own, in seconds of audio */
+    constexpr double minSegmentSeconds = 15.0;
+
+    /** "OTWF", and the layout version */
+    constexpr int fileMagic = 0x4f545746;
+    constexpr int fileVersion = 2;
+
+    /** The header before the bins: magic, version, sample rate, length, bin size and level count */
+    constexpr int headerSize = 32;
+
+    int8 toSampleByte(float value)
+    {
+        return (int8) jlimit(-127, 127, roundToInt(value * 127.0f));
+    }
+
+    uint8 toLevelByte(float value)
+    {
+        return (uint8) jlimit(0, 255, roundToInt(value * 255.0f));
+    }
+
+    /** Folds bins together: the peaks by their extremes, and the levels by their power */
+    struct BinMerger
+    {
+        WaveformBin result;
+        float power[4] = {};
+        int count = 0;
+
+        void add(const WaveformBin& bin)
+        {
+            result.min = count == 0 ? bin.min : jmin(result.min, bin.min);
+            result.max = count == 0 ? bin.max : jmax(result.max, bin.max);
+
+            const float levels[4] = { (float) bin.rms, (float) bin.low, (float) bin.mid, (float) bin.high };
+            for (int i = 0; i < 4; ++i)
+                power[i] += levels[i] * levels[i];
+
+            ++count;
+        }
+
+        WaveformBin get()
+        {
+            uint8* levels[4] = { &result.rms, &result.low, &result.mid, &result.high };
+            for (int i = 0; i < 4; ++i)
+                *levels[i] = count > 0 ? (uint8) roundToInt(std::sqrt(power[i] / (float) count)) : 0;
+
+            return result;
+        }
+    };
+}
+
+//==============================================================================
+// The DeckEqualiser's crossover stages, with a band in each lane. Lane 0 is a
+// Linkwitz-Riley low-pass at the low crossover and lane 1 a Linkwitz-Riley
+// high-pass at the high crossover. Lane 2 is a high-pass at the low crossover
+// followed by a low-pass at the high one, the mid band. Lane 3 is unused.
+// The three run through both stages together, a sample at a time.
+struct WaveformPyramid::BandSplitter
+{
+    explicit BandSplitter(double sampleRate)
+    {
+        const auto lowPass = DeckEqualiser::makeLowPass(sampleRate, DeckEqualiser::lowCrossoverHz, DeckEqualiser::butterworthQ);
+        const auto highPass = DeckEqualiser::makeHighPass(sampleRate, DeckEqualiser::highCrossoverHz, DeckEqualiser::butterworthQ);
+        const auto midHighPass = DeckEqualiser::makeHighPass(sampleRate, DeckEqualiser::lowCrossoverHz, DeckEqualiser::butterworthQ);
+        const auto midLowPass = DeckEqualiser::makeLowPass(sampleRate, DeckEqualiser::highCrossoverHz, DeckEqualiser::butterworthQ);
+
+        stages[0].setCoefficients(lowPass, highPass, midHighPass, DeckEqualiser::Coefficients());
+        stages[1].setCoefficients(lowPass, highPass, midLowPass, DeckEqualiser::Coefficients());
+    }
+
+    /** Returns the low, high and mid bands of one sample, in lanes 0 to 2 */
+    inline SimdKernels::Vec4 process(float x)
+    {
+        return stages[1].process(stages[0].process(SimdKernels::broadcast4(x)));
+    }
+
+    DeckEqualiser::Biquad4 stages[2];
+};
+
+//==============================================================================
+// The levels halve, rounding up, until one bin is left
+WaveformPyramid::WaveformPyramid(double _sampleRate, int64 _lengthInSamples, bool allocate)
+    : sampleRate(_sampleRate),
+      lengthInSamples(_lengthInSamples)
+{
+    int64 numBins = jmax((int64) 1, (lengthInSamples + finestBinSize - 1) / finestBinSize);
+    levelOffsets.push_back(0);
+
+    while (true)
+    {
+        levelOffsets.push_back(levelOffsets.back() + numBins);
+
+        if (numBins == 1)
+            break;
+
+        numBins = (numBins + 1) / 2;
+    }
+
+    if (allocate)
+    {
+        bins.resize((size_t) levelOffsets.back());
+        block = bins.data();
+    }
+}
+
+//==============================================================================
+// Every segment gets its own reader: readers keep decoder state and cannot be
+// shared between threads. A segment starts on a bin boundary, so the segments
+// fill the finest level without overlapping.
+WaveformPyramid::Ptr WaveformPyramid::build(const File& file, AudioFormatManager& formatManager, ThreadPool& pool,
+                                            const std::function<bool()>& shouldStop)
+{
+    std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(file));
+
+    if (reader == nullptr || reader->lengthInSamples <= 0 || reader->sampleRate <= 0.0)
+    {
+        std::cout << "WaveformPyramid::build could not read " << file.getFullPathName() << std::endl;
+        return nullptr;
+    }
+
+    Ptr pyramid(new WaveformPyramid(reader->sampleRate, reader->lengthInSamples, true));
+    const auto minBinsPerSegment = (int64) (minSegmentSeconds * reader->sampleRate / finestBinSize);
+    std::atomic<bool> failed{false};
+
+    forEachSegment(pool, pyramid->getNumBins(0), minBinsPerSegment, [&](int64 firstBin, int64 endBin)
+    {
+        if (failed.load() || shouldStop())
+            return;
+
+        std::unique_ptr<AudioFormatReader> segmentReader(formatManager.createReaderFor(file));
+
+        if (segmentReader == nullptr || ! pyramid->reduceFromReader(*segmentReader, firstBin, endBin, shouldStop))
+            failed = true;
+    });
+
+    if (failed.load() || shouldStop())
+        return nullptr;
+
+    pyramid->buildCoarserLevels();
+    return pyramid;
+}
+
+WaveformPyramid::Ptr WaveformPyramid::build(const AudioBuffer<float>& audio, double sampleRate, ThreadPool& pool)
+{
+    if (audio.getNumSamples() <= 0 || sampleRate <= 0.0)
+        return nullptr;
+
+    Ptr pyramid(new WaveformPyramid(sampleRate, audio.getNumSamples(), true));
+    const auto minBinsPerSegment = (int64) (minSegmentSeconds * sampleRate / finestBinSize);
+    const int numChannels = jmin(2, audio.getNumChannels());
+
+    forEachSegment(pool, pyramid->getNumBins(0), minBinsPerSegment, [&](int64 firstBin, int64 endBin)
+    {
+        const int start = (int) (firstBin * finestBinSize);
+        const int end = (int) jmin(endBin * finestBinSize, (int64) audio.getNumSamples());
+        const float* channels[] = { audio.getReadPointer(0, start), audio.getReadPointer(numChannels - 1, start) };
+        const ScopedNoDenormals noDenormals;
+        BandSplitter bands(sampleRate);
+
+        pyramid->reduce(channels, numChannels, end - start, firstBin, bands);
+    });
+
+    pyramid->buildCoarserLevels();
+    return pyramid;
+}
+
+// Segments are handed to the pool and this thread waits for the last one, so
+// the caller must not itself be one of the pool's threads
+void WaveformPyramid::forEachSegment(ThreadPool& pool, int64 numBins, int64 minBinsPerSegment,
+                                     const std::function<void(int64, int64)>& job)
+{
+    const int numSegments = (int) jlimit((int64) 1, (int64) jmax(1, pool.getNumThreads()),
+                                         numBins / jmax((int64) 1, minBinsPerSegment));
+    const int64 binsPerSegment = (numBins + numSegments - 1) / numSegments;
+
+    std::atomic<int> remaining{numSegments};
+    WaitableEvent finished;
+
+    for (int i = 0; i < numSegments; ++i)
+    {
+        const int64 firstBin = i * binsPerSegment;
+        const int64 endBin = jmin(numBins, firstBin + binsPerSegment);
+
+        pool.addJob([&, firstBin, endBin]
+        {
+            if (firstBin < endBin)
+                job(firstBin, endBin);
+
+            if (--remaining == 0)
+                finished.signal();
+        });
+    }
+
+    finished.wait();
+}
+
+//==============================================================================
+bool WaveformPyramid::reduceFromReader(AudioFormatReader& reader, int64 firstBin, int64 endBin,
+                                       const std::function<bool()>& shouldStop)
+{
+    const int numChannels = jmin(2, (int) reader.numChannels);
+    AudioBuffer<float> chunk(numChannels, binsPerChunk * finestBinSize);
+    const ScopedNoDenormals noDenormals;
+    BandSplitter bands(sampleRate);
+
+    for (int64 bin = firstBin; bin < endBin; bin += binsPerChunk)
+    {
+        if (shouldStop())
+            return false;
+
+        const int64 start = bin * finestBinSize;
+        const int numSamples = (int) jmin((int64) chunk.getNumSamples(), jmin(endBin * finestBinSize, lengthInSamples) - start);
+
+        if (! reader.read(&chunk, 0, numSamples, start, true, numChannels > 1))
+            return false;
+
+        const float* channels[] = { chunk.getReadPointer(0), chunk.getReadPointer(numChannels - 1) };
+        reduce(channels, numChannels, numSamples, bin, bands);
+    }
+
+    return true;
+}
+
+// The min and max come from JUCE's vectorised search and the power from the
+// vectorised dot product the resampler uses. The bands are split from the
+// channels mixed to mono, and their power summed in the lanes as they go.
+void WaveformPyramid::reduce(const float* const* channels, int numChannels, int numSamples, int64 firstBin,
+                             BandSplitter& bands)
+{
+    using namespace SimdKernels;
+
+    WaveformBin* finest = bins.data();
+
+    for (int offset = 0; offset < numSamples; offset += finestBinSize)
+    {
+        const int n = jmin(finestBinSize, numSamples - offset);
+        Range<float> range;
+        float power = 0.0f;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const float* samples = channels[channel] + offset;
+            const auto channelRange = FloatVectorOperations::findMinAndMax(samples, n);
+
+            range = channel == 0 ? channelRange : range.getUnionWith(channelRange);
+            power += SimdKernels::dotProduct(samples, samples, n);
+        }
+
+        const float* left = channels[0] + offset;
+        const float* right = channels[numChannels - 1] + offset;
+        auto bandPower = broadcast4(0.0f);
+
+        for (int i = 0; i < n; ++i)
+        {
+            const auto y = bands.process(0.5f * (left[i] + right[i]));
+            bandPower = add4(bandPower, mul4(y, y));
+        }
+
+        float bandPowers[4];
+        store4(bandPowers, bandPower);
+
+        auto& bin = finest[firstBin + offset / finestBinSize];
+        bin.min = toSampleByte(range.getStart());
+        bin.max = toSampleByte(range.getEnd());
+        bin.rms = toLevelByte(std::sqrt(power / (float) (n * numChannels)));
+        bin.low = toLevelByte(std::sqrt(bandPowers[0] / (float) n));
+        bin.high = toLevelByte(std::sqrt(bandPowers[1] / (float) n));
+        bin.mid = toLevelByte(std::sqrt(bandPowers[2] / (float) n));
+    }
+}
+
+void WaveformPyramid::buildCoarserLevels()
+{
+    for (int level = 1; level < getNumLevels(); ++level)
+    {
+        const WaveformBin* below = bins.data() + levelOffsets[(size_t) level - 1];
+        const int numBelow = getNumBins(level - 1);
+        WaveformBin* above = bins.data() + levelOffsets[(size_t) level];
+
+        for (int i = 0; i < getNumBins(level); ++i)
+        {
+            BinMerger merger;
+
+            for (int j = i * 2; j < jmin(i * 2 + 2, numBelow); ++j)
+                merger.add(below[j]);
+
+            above[i] = merger.get();
+        }
+    }
+}
+
+//==============================================================================
+// The header is checked against the length it gives, so a file cut short or
+// from another layout is never mapped past its end
+WaveformPyramid::Ptr WaveformPyramid::open(const File& file)
+{
+    auto mapped = std::make_unique<MemoryMappedFile>(file, MemoryMappedFile::readOnly);
+
+    if (mapped->getData() == nullptr || mapped->getSize() < (size_t) headerSize)
+        return nullptr;
+
+    MemoryInputStream header(mapped->getData(), (size_t) headerSize, false);
+
+    if (header.readInt() != fileMagic || header.readInt() != fileVersion)
+        return nullptr;
+
+    const double rate = header.readDouble();
+    const int64 length = header.readInt64();
+    const int binSize = header.readInt();
+    const int numLevels = header.readInt();
+
+    if (rate <= 0.0 || length <= 0 || binSize != finestBinSize)
+        return nullptr;
+
+    Ptr pyramid(new WaveformPyramid(rate, length, false));
+
+    if (pyramid->getNumLevels() != numLevels
+        || mapped->getSize() != (size_t) headerSize + (size_t) pyramid->levelOffsets.back() * sizeof(WaveformBin))
+        return nullptr;
+
+    pyramid->block = reinterpret_cast<const WaveformBin*>(static_cast<const char*>(mapped->getData()) + headerSize);
+    pyramid->mappedFile = std::move(mapped);
+    return pyramid;
+}
+
+// Written to a temporary file and moved into place, so a reader never maps
+// half a pyramid
+bool WaveformPyramid::save(const File& file) const
+{
+    TemporaryFile temp(file);
+
+    {
+        FileOutputStream out(temp.getFile());
+
+        if (out.failedToOpen())
+            return false;
+
+        out.writeInt(fileMagic);
+        out.writeInt(fileVersion);
+        out.writeDouble(sampleRate);
+        out.writeInt64(lengthInSamples);
+        out.writeInt(finestBinSize);
+        out.writeInt(getNumLevels());
+        out.write(block, (size_t) levelOffsets.back() * sizeof(WaveformBin));
+        out.flush();
+
+        if (out.getStatus().failed())
+            return false;
+    }
+
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+//==============================================================================
+double WaveformPyramid::getSampleRate() const
+{
+    return sampleRate;
+}
+
+int64 WaveformPyramid::getLengthInSamples() const
+{
+    return lengthInSamples;
+}
+
+double WaveformPyramid::getLengthInSeconds() const
+{
+    return (double) lengthInSamples / sampleRate;
+}
+
+int WaveformPyramid::getNumLevels() const
+{
+    return (int) levelOffsets.size() - 1;
+}
+
+int64 WaveformPyramid::getBinSize(int level) const
+{
+    return (int64) finestBinSize << level;
+}
+
+int WaveformPyramid::getNumBins(int level) const
+{
+    return (int) (levelOffsets[(size_t) level + 1] - levelOffsets[(size_t) level]);
+}
+
+const WaveformBin* WaveformPyramid::getBins(int level) const
+{
+    return block + levelOffsets[(size_t) level];
+}
+
+int64 WaveformPyramid::getSizeInBytes() const
+{
+    return levelOffsets.back() * (int64) sizeof(WaveformBin);
+}
+
+int WaveformPyramid::getLevelFor(double samplesPerColumn) const
+{
+    if (samplesPerColumn < 2.0 * finestBinSize)
+        return 0;
+
+    return jmin(getNumLevels() - 1, (int) std::floor(std::log2(samplesPerColumn / finestBinSize)));
+}
+
+// A column narrower than a bin shows the bin it falls in, so a view zoomed
+// past the finest level stretches its bins rather than leaving gaps
+void WaveformPyramid::getColumns(double startSeconds, double endSeconds, WaveformBin* columns, int numColumns) const
+{
+    if (numColumns <= 0)
+        return;
+
+    const double samplesPerColumn = (endSeconds - startSeconds) * sampleRate / numColumns;
+    const int level = getLevelFor(samplesPerColumn);
+    const WaveformBin* bins = getBins(level);
+    const int numBins = getNumBins(level);
+    const double binsPerColumn = samplesPerColumn / (double) getBinSize(level);
+    const double firstBin = startSeconds * sampleRate / (double) getBinSize(level);
+
+    for (int column = 0; column < numColumns; ++column)
+    {
+        const double from = firstBin + column * binsPerColumn;
+        const auto first = (int) std::floor(from);
+        const auto end = jmax(first + 1, (int) std::ceil(from + binsPerColumn));
+
+        BinMerger merger;
+
+        for (int i = jmax(0, first); i < jmin(numBins, end); ++i)
+            merger.add(bins[i]);
+
+        columns[column] = merger.get();
+    }
+}
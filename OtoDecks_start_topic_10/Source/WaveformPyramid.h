@@ -0,0 +1,171 @@
+/*
+==============================================================================
+WaveformPyramid.h
+Created: 26 Oct 2026 9:47:21am
+Author:  Atysuya Ino
+==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <vector>
+
+//==============================================================================
+/*
+    One bin of a waveform: the lowest and highest sample and the RMS level
+    over both channels, and the RMS level of each of the EQ's low, mid and
+    high bands, each quantised to a byte. Bins are stored on disk exactly
+    as they are in memory, so the struct holds only bytes.
+*/
+struct WaveformBin
+{
+    int8 min = 0;
+    int8 max = 0;
+    uint8 rms = 0;
+    uint8 low = 0;
+    uint8 mid = 0;
+    uint8 high = 0;
+};
+
+static_assert(sizeof(WaveformBin) == 6, "WaveformBin is written to disk byte for byte");
+
+//==============================================================================
+/*
+    WaveformPyramid is a track's waveform at every resolution, as a mip-map
+    of WaveformBins. The finest level has a bin for every finestBinSize
+    samples, and each level above has half as many bins, each summarising
+    two from the level below, up to a single bin for the whole track.
+
+    Drawing at any zoom reads the coarsest level that still has a bin per
+    pixel, so it reads at most three bins per pixel however long the track
+    is or however far in the view is zoomed.
+
+    A pyramid is built by splitting the track into one segment per thread,
+    decoding and reducing the segments in parallel, then folding the finest
+    level up into the rest. The band levels come from the same pass: each
+    segment runs its audio through a three-way band split at the
+    DeckEqualiser's crossovers, vectorised across the bands. Once built a
+    pyramid is never changed, so any number of threads can read it.
+
+    Every level's bins are kept in one block, finest first, which is also
+    how a pyramid is saved: a small header and then the block. A saved
+    pyramid is opened by mapping the file into memory, so it is ready to
+    draw without reading or decoding anything.
+*/
+class WaveformPyramid : public ReferenceCountedObject
+{
+public:
+    using Ptr = ReferenceCountedObjectPtr<WaveformPyramid>;
+
+    /** Samples summarised by each bin of the finest level */
+    static constexpr int finestBinSize = 64;
+
+    /**
+     * Builds a file's pyramid, decoding it in parallel segments.
+     * @param file The audio file.
+     * @param formatManager Opens a reader for each segment.
+     * @param pool The threads the segments are decoded on.
+     * @param shouldStop Polled while decoding; returning true abandons the build.
+     * @return The pyramid, or nullptr if the file could not be read or the build was abandoned.
+     */
+    static Ptr build(const File& file, AudioFormatManager& formatManager, ThreadPool& pool,
+                     const std::function<bool()>& shouldStop);
+
+    /**
+     * Builds a pyramid from audio already in memory, reducing it in parallel segments.
+     * @param audio The track, with one or two channels.
+     * @param sampleRate The track's sample rate.
+     * @param pool The threads the segments are reduced on.
+     */
+    static Ptr build(const AudioBuffer<float>& audio, double sampleRate, ThreadPool& pool);
+
+    /**
+     * Opens a saved pyramid by mapping its file into memory.
+     * @param file A file written by save().
+     * @return The pyramid, or nullptr if the file is missing, from another version or damaged.
+     */
+    static Ptr open(const File& file);
+
+    /**
+     * Saves the pyramid so that open() can map it.
+     * @param file The file to write, replaced if it exists.
+     * @return False if writing failed.
+     */
+    bool save(const File& file) const;
+
+    //==============================================================================
+    /** Returns the track's sample rate. */
+    double getSampleRate() const;
+
+    /** Returns the track's length in samples. */
+    int64 getLengthInSamples() const;
+
+    /** Returns the track's length in seconds. */
+    double getLengthInSeconds() const;
+
+    /** Returns the number of levels, the finest being level 0. */
+    int getNumLevels() const;
+
+    /** Returns the number of samples each bin of a level summarises. */
+    int64 getBinSize(int level) const;
+
+    /** Returns the number of bins in a level. */
+    int getNumBins(int level) const;
+
+    /** Returns a level's bins. */
+    const WaveformBin* getBins(int level) const;
+
+    /** Returns the size of the pyramid's bins, whether held in memory or mapped from a file. */
+    int64 getSizeInBytes() const;
+
+    /**
+     * Picks the coarsest level that still has at least one bin per column.
+     * @param samplesPerColumn The samples each column of the view covers.
+     */
+    int getLevelFor(double samplesPerColumn) const;
+
+    /**
+     * Summarises part of the track for each of a number of columns, such as
+     * the pixels across a view. Columns before the start or past the end of
+     * the track are silent.
+     * @param startSeconds Where the first column starts.
+     * @param endSeconds Where the last column ends.
+     * @param columns Receives one bin per column.
+     * @param numColumns The number of columns.
+     */
+    void getColumns(double startSeconds, double endSeconds, WaveformBin* columns, int numColumns) const;
+
+private:
+    /** Works out every level's place in the block; allocates it unless it will be mapped */
+    WaveformPyramid(double _sampleRate, int64 _lengthInSamples, bool allocate);
+
+    /** Splits a segment's audio into the three bands, keeping its filter state from chunk to chunk */
+    struct BandSplitter;
+
+    /** Reduces some audio into consecutive bins of the finest level, starting at a bin */
+    void reduce(const float* const* channels, int numChannels, int numSamples, int64 firstBin, BandSplitter& bands);
+
+    /** Decodes a run of whole bins from a reader and reduces it, returning false if reading failed */
+    bool reduceFromReader(AudioFormatReader& reader, int64 firstBin, int64 endBin, const std::function<bool()>& shouldStop);
+
+    /** Builds every level above the finest from the one below it */
+    void buildCoarserLevels();
+
+    /** Runs a job for each segment of the finest level on a pool and waits for them all */
+    static void forEachSegment(ThreadPool& pool, int64 numBins, int64 minBinsPerSegment,
+                               const std::function<void(int64 firstBin, int64 endBin)>& job);
+
+    double sampleRate;
+    int64 lengthInSamples;
+
+    /** Where each level starts in the block, in bins, with the block's total at the end */
+    std::vector<int64> levelOffsets;
+
+    /** The block, owned when built and mapped when opened from a file */
+    std::vector<WaveformBin> bins;
+    std::unique_ptr<MemoryMappedFile> mappedFile;
+    const WaveformBin* block = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformPyramid)
+};